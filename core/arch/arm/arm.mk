@@ -101,6 +101,10 @@ endif
 ifeq ($(CFG_CORE_SEL2_SPMC),y)
 $(call force,CFG_CORE_FFA,y)
 endif
+# Invoke rings are only implemented for the SMC based ABI
+ifeq ($(CFG_CORE_FFA),y)
+$(call force,CFG_CORE_INVOKE_RING,n)
+endif
 
 # Unmaps all kernel mode code except the code needed to take exceptions
 # from user space and restore kernel mode mapping again. This gives more
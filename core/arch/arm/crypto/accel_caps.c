@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <arm.h>
+#include <atomic.h>
+#include <config.h>
+#include <crypto/crypto_accel.h>
+#include <trace.h>
+
+/* Set in accel_caps once the CPU has been probed */
+#define CAPS_PROBED	BIT32(31)
+
+static uint32_t accel_caps;
+
+static uint32_t probe_caps(void)
+{
+	uint32_t caps = 0;
+
+	if (IS_ENABLED(CFG_CRYPTO_AES_ARM_CE) && feat_aes_is_implemented())
+		caps |= CRYPTO_ACCEL_AES;
+	if (feat_pmull_is_implemented())
+		caps |= CRYPTO_ACCEL_PMULL;
+	if (IS_ENABLED(CFG_CRYPTO_SHA1_ARM_CE) && feat_sha1_is_implemented())
+		caps |= CRYPTO_ACCEL_SHA1;
+	if (IS_ENABLED(CFG_CRYPTO_SHA256_ARM_CE) &&
+	    feat_sha256_is_implemented())
+		caps |= CRYPTO_ACCEL_SHA256;
+	if (IS_ENABLED(CFG_CRYPTO_SHA512_ARM_CE) &&
+	    feat_sha512_is_implemented())
+		caps |= CRYPTO_ACCEL_SHA512;
+	if (IS_ENABLED(CFG_CRYPTO_SM3_ARM_CE) && feat_sm3_is_implemented())
+		caps |= CRYPTO_ACCEL_SM3;
+	if (IS_ENABLED(CFG_CRYPTO_SM4_ARM_CE) && feat_sm4_is_implemented())
+		caps |= CRYPTO_ACCEL_SM4;
+
+	return caps;
+}
+
+uint32_t crypto_accel_get_caps(void)
+{
+	uint32_t caps = atomic_load_u32(&accel_caps);
+
+	/*
+	 * All CPUs are expected to implement the same set of instructions
+	 * so it doesn't matter which CPU does the probing, or if two CPUs
+	 * race to do it, the outcome is the same.
+	 */
+	if (!caps) {
+		caps = probe_caps() | CAPS_PROBED;
+		atomic_store_u32(&accel_caps, caps);
+	}
+
+	return caps & ~CAPS_PROBED;
+}
+
+static const char *yes_no(uint32_t caps)
+{
+	if (crypto_accel_is_available(caps))
+		return "yes";
+	return "no";
+}
+
+void crypto_accel_show_caps(void)
+{
+	IMSG("Crypto Extensions used: AES %s, PMULL %s, SHA-1 %s, SHA-256 %s, "
+	     "SHA-512 %s, SM3 %s, SM4 %s", yes_no(CRYPTO_ACCEL_AES),
+	     yes_no(CRYPTO_ACCEL_PMULL), yes_no(CRYPTO_ACCEL_SHA1),
+	     yes_no(CRYPTO_ACCEL_SHA256), yes_no(CRYPTO_ACCEL_SHA512),
+	     yes_no(CRYPTO_ACCEL_SM3), yes_no(CRYPTO_ACCEL_SM4));
+}
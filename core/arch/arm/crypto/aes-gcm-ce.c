@@ -32,6 +32,23 @@ static void put_be_block(void *dst, const void *src)
 	put_be64((uint8_t *)dst + 8, s[0]);
 }
 
+/*
+ * The AES instructions are always needed. The 64-bit polynomial multiply
+ * is needed on ARM64 by pmull_gcm_encrypt() and pmull_gcm_decrypt(), and
+ * by pmull_ghash_update_p64() if CFG_HWSUPP_PMULT_64=y. Without them the
+ * portable implementation is used instead.
+ */
+static bool use_ce(void)
+{
+	uint32_t caps = CRYPTO_ACCEL_AES;
+
+#if defined(ARM64) || defined(CFG_HWSUPP_PMULT_64)
+	caps |= CRYPTO_ACCEL_PMULL;
+#endif
+
+	return crypto_accel_is_available(caps);
+}
+
 static void ghash_reflect(uint64_t h[2], const uint64_t k[2])
 {
 	uint64_t b = get_be64(k);
@@ -49,6 +66,11 @@ void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
 	uint64_t k[2] = { 0 };
 	uint64_t h[2] = { 0 };
 
+	if (!use_ce()) {
+		internal_aes_gcm_set_key_sw(state, enc_key);
+		return;
+	}
+
 	crypto_aes_enc_block(enc_key->data, sizeof(enc_key->data),
 			     enc_key->rounds, state->ctr, k);
 
@@ -83,6 +105,11 @@ void internal_aes_gcm_ghash_update(struct internal_aes_gcm_state *state,
 	uint32_t vfp_state;
 	uint64_t dg[2];
 
+	if (!use_ce()) {
+		internal_aes_gcm_ghash_update_sw(state, head, data, num_blocks);
+		return;
+	}
+
 	get_be_block(dg, state->hash_state);
 
 	vfp_state = thread_kernel_enable_vfp();
@@ -94,26 +121,52 @@ void internal_aes_gcm_ghash_update(struct internal_aes_gcm_state *state,
 	put_be_block(state->hash_state, dg);
 }
 
+/*
+ * Blocks not handled by the combined AES and PMULL routines are processed
+ * in batches of up to GCM_CE_BATCH_BLOCKS blocks: the payload of a batch
+ * is AES-CTR processed with one call and hashed with one call, instead of
+ * one call of each per block.
+ *
+ * Each batch is read from @src once into a local buffer and hashed from
+ * there, so what's authenticated always matches the data processed even
+ * if @src or @dst is shared with normal world.
+ */
+#define GCM_CE_BATCH_BLOCKS	4
+
+/*
+ * In the encrypt case state->buf_cryp holds the key stream of the first
+ * block and state->ctr the counter of the following block.
+ */
 static void encrypt_pl(struct internal_aes_gcm_state *state,
 		       const struct internal_aes_gcm_key *ek, uint64_t dg[2],
 		       const uint8_t *src, size_t num_blocks, uint8_t *dst)
 {
+	uint8_t buf[GCM_CE_BATCH_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
 	void *buf_cryp = state->buf_cryp;
+	size_t bn = 0;
 
 	while (num_blocks) {
-		ce_aes_xor_block(buf_cryp, buf_cryp, src);
+		bn = MIN(num_blocks, (size_t)GCM_CE_BATCH_BLOCKS);
 
-		pmull_ghash_update(1, dg, buf_cryp, &state->ghash_key, NULL);
-		memcpy(dst, buf_cryp, TEE_AES_BLOCK_SIZE);
+		ce_aes_xor_block(buf, buf_cryp, src);
+		if (bn > 1)
+			ce_aes_ctr_encrypt(buf + TEE_AES_BLOCK_SIZE,
+					   src + TEE_AES_BLOCK_SIZE,
+					   (const uint8_t *)ek->data,
+					   ek->rounds, bn - 1,
+					   (uint8_t *)state->ctr, 1);
 
 		ce_aes_ecb_encrypt(buf_cryp, (const uint8_t *)state->ctr,
 				   (const uint8_t *)ek->data, ek->rounds,
 				   1, 1);
 		internal_aes_gcm_inc_ctr(state);
 
-		src += TEE_AES_BLOCK_SIZE;
-		dst += TEE_AES_BLOCK_SIZE;
-		num_blocks--;
+		pmull_ghash_update(bn, dg, buf, &state->ghash_key, NULL);
+		memcpy(dst, buf, bn * TEE_AES_BLOCK_SIZE);
+
+		src += bn * TEE_AES_BLOCK_SIZE;
+		dst += bn * TEE_AES_BLOCK_SIZE;
+		num_blocks -= bn;
 	}
 }
 
@@ -121,14 +174,21 @@ static void decrypt_pl(struct internal_aes_gcm_state *state,
 		       const struct internal_aes_gcm_key *ek, uint64_t dg[2],
 		       const uint8_t *src, size_t num_blocks, uint8_t *dst)
 {
+	uint8_t buf[GCM_CE_BATCH_BLOCKS * TEE_AES_BLOCK_SIZE] = { };
+	size_t bn = 0;
+
 	while (num_blocks) {
-		ce_aes_ctr_encrypt(dst, src, (const uint8_t *)ek->data,
-				   ek->rounds, 1, (uint8_t *)state->ctr, 1);
-		pmull_ghash_update(1, dg, src, &state->ghash_key, NULL);
+		bn = MIN(num_blocks, (size_t)GCM_CE_BATCH_BLOCKS);
+
+		memcpy(buf, src, bn * TEE_AES_BLOCK_SIZE);
+		pmull_ghash_update(bn, dg, buf, &state->ghash_key, NULL);
+		ce_aes_ctr_encrypt(buf, buf, (const uint8_t *)ek->data,
+				   ek->rounds, bn, (uint8_t *)state->ctr, 1);
+		memcpy(dst, buf, bn * TEE_AES_BLOCK_SIZE);
 
-		src += TEE_AES_BLOCK_SIZE;
-		dst += TEE_AES_BLOCK_SIZE;
-		num_blocks--;
+		src += bn * TEE_AES_BLOCK_SIZE;
+		dst += bn * TEE_AES_BLOCK_SIZE;
+		num_blocks -= bn;
 	}
 }
 
@@ -179,6 +239,12 @@ internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
 	uint32_t vfp_state = 0;
 	uint64_t dg[2] = { 0 };
 
+	if (!use_ce()) {
+		internal_aes_gcm_update_payload_blocks_sw(state, ek, mode, src,
+							  num_blocks, dst);
+		return;
+	}
+
 	get_be_block(dg, state->hash_state);
 	vfp_state = thread_kernel_enable_vfp();
 
@@ -216,6 +282,12 @@ internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
 	uint64_t dg[2] = { 0 };
 	uint32_t vfp_state = 0;
 
+	if (!use_ce()) {
+		internal_aes_gcm_update_payload_blocks_sw(state, ek, mode, src,
+							  num_blocks, dst);
+		return;
+	}
+
 	assert(!state->buf_pos && num_blocks);
 	get_be_block(dg, state->hash_state);
 	vfp_state = thread_kernel_enable_vfp();
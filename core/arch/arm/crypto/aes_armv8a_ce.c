@@ -125,6 +125,8 @@ TEE_Result crypto_accel_aes_expand_keys(const void *key, size_t key_len,
 	unsigned int num_rounds = 0;
 	uint32_t vfp_state = 0;
 
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return TEE_ERROR_NOT_SUPPORTED;
 	if (!key || !enc_key)
 		return TEE_ERROR_BAD_PARAMETERS;
 	if (key_len != 16 && key_len != 24 && key_len != 32)
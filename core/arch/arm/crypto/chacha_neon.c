@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <string_ext.h>
+#include <util.h>
+
+#define CHACHA_BLOCK_SIZE	64
+
+/* Prototype for assembly function */
+void chacha_4block_xor_neon(const uint32_t state[16], void *dst,
+			    const void *src, unsigned int rounds);
+
+void crypto_accel_chacha_xor(uint32_t state[16], void *out, const void *in,
+			     unsigned int block_count, unsigned int rounds)
+{
+	uint8_t buf[CHACHA_BLOCK_SIZE * 4] = { };
+	uint32_t vfp_state = 0;
+	const uint8_t *src = in;
+	uint8_t *dst = out;
+	size_t len = 0;
+
+	vfp_state = thread_kernel_enable_vfp();
+
+	while (block_count >= 4) {
+		chacha_4block_xor_neon(state, dst, src, rounds);
+		state[12] += 4;
+		src += sizeof(buf);
+		dst += sizeof(buf);
+		block_count -= 4;
+	}
+
+	/*
+	 * The remaining one to three blocks are processed in a bounce
+	 * buffer, computing four blocks of key stream is cheaper than
+	 * falling back to the scalar implementation.
+	 */
+	if (block_count) {
+		len = block_count * CHACHA_BLOCK_SIZE;
+		memcpy(buf, src, len);
+		chacha_4block_xor_neon(state, buf, buf, rounds);
+		memcpy(dst, buf, len);
+		state[12] += block_count;
+	}
+
+	thread_kernel_disable_vfp(vfp_state);
+
+	memzero_explicit(buf, sizeof(buf));
+}
@@ -10,12 +10,17 @@
 void sha256_ce_transform(uint32_t state[8], const void *src,
 			 unsigned int block_count);
 
-void crypto_accel_sha256_compress(uint32_t state[8], const void *src,
-				  unsigned int block_count)
+TEE_Result crypto_accel_sha256_compress(uint32_t state[8], const void *src,
+					unsigned int block_count)
 {
 	uint32_t vfp_state = 0;
 
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_SHA256))
+		return TEE_ERROR_NOT_SUPPORTED;
+
 	vfp_state = thread_kernel_enable_vfp();
 	sha256_ce_transform(state, src, block_count);
 	thread_kernel_disable_vfp(vfp_state);
+
+	return TEE_SUCCESS;
 }
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <config.h>
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+
+/* Prototypes for assembly functions */
+void sm3_ce_transform(uint32_t state[8], const void *src,
+		      unsigned int block_count);
+void sm3_neon_transform(uint32_t state[8], const void *src,
+			unsigned int block_count);
+
+static bool use_ce(void)
+{
+	return IS_ENABLED(CFG_CRYPTO_SM3_ARM_CE) &&
+	       crypto_accel_is_available(CRYPTO_ACCEL_SM3);
+}
+
+TEE_Result crypto_accel_sm3_compress(uint32_t state[8], const void *src,
+				     unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+	bool ce = use_ce();
+
+	if (!ce && !IS_ENABLED(CFG_CRYPTO_SM3_ARM_NEON))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	vfp_state = thread_kernel_enable_vfp();
+	if (ce)
+		sm3_ce_transform(state, src, block_count);
+	else
+		sm3_neon_transform(state, src, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+
+	return TEE_SUCCESS;
+}
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <config.h>
+#include <crypto/crypto_accel.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <string_ext.h>
+#include <types_ext.h>
+#include <util.h>
+
+#define SM4_BLOCK_SIZE	16
+
+/* Prototypes for assembly functions */
+void sm4_ce_crypt(const uint32_t rk[32], void *dst, const void *src,
+		  unsigned int block_count);
+void sm4_ce_cbc_decrypt(const uint32_t rk[32], void *dst, const void *src,
+			unsigned int block_count, void *iv);
+void sm4_ce_ctr_encrypt(const uint32_t rk[32], void *dst, const void *src,
+			unsigned int block_count, void *ctr);
+
+/* The NEON functions only handle a multiple of four blocks */
+void sm4_neon_crypt(const uint32_t rk[32], void *dst, const void *src,
+		    unsigned int block_count);
+void sm4_neon_cbc_decrypt(const uint32_t rk[32], void *dst, const void *src,
+			  unsigned int block_count, void *iv);
+void sm4_neon_ctr_encrypt(const uint32_t rk[32], void *dst, const void *src,
+			  unsigned int block_count, void *ctr);
+
+static bool use_ce(void)
+{
+	return IS_ENABLED(CFG_CRYPTO_SM4_ARM_CE) &&
+	       crypto_accel_is_available(CRYPTO_ACCEL_SM4);
+}
+
+static void xor_bytes(uint8_t *dst, const uint8_t *src, size_t len)
+{
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		dst[n] ^= src[n];
+}
+
+static void ctr_be_inc(uint8_t ctr[SM4_BLOCK_SIZE])
+{
+	int i = 0;
+
+	for (i = SM4_BLOCK_SIZE; i > 0; i--)
+		if (++ctr[i - 1])
+			break;
+}
+
+/*
+ * The remaining one to three blocks of the NEON functions below are
+ * processed in a bounce buffer with the four block ECB function, that's
+ * still cheaper than falling back to the scalar implementation.
+ */
+
+static void neon_ecb(const uint32_t rk[32], uint8_t *dst, const uint8_t *src,
+		     unsigned int block_count)
+{
+	uint8_t buf[SM4_BLOCK_SIZE * 4] = { };
+	unsigned int tail = block_count % 4;
+	size_t len = (block_count - tail) * SM4_BLOCK_SIZE;
+
+	if (len)
+		sm4_neon_crypt(rk, dst, src, block_count - tail);
+
+	if (tail) {
+		memcpy(buf, src + len, tail * SM4_BLOCK_SIZE);
+		sm4_neon_crypt(rk, buf, buf, 4);
+		memcpy(dst + len, buf, tail * SM4_BLOCK_SIZE);
+		memzero_explicit(buf, sizeof(buf));
+	}
+}
+
+static void neon_cbc_dec(const uint32_t rk[32], uint8_t *dst,
+			 const uint8_t *src, unsigned int block_count,
+			 uint8_t iv[SM4_BLOCK_SIZE])
+{
+	uint8_t buf[SM4_BLOCK_SIZE * 4] = { };
+	uint8_t ct[SM4_BLOCK_SIZE * 4] = { };
+	unsigned int tail = block_count % 4;
+	size_t len = (block_count - tail) * SM4_BLOCK_SIZE;
+	size_t n = tail * SM4_BLOCK_SIZE;
+
+	if (len)
+		sm4_neon_cbc_decrypt(rk, dst, src, block_count - tail, iv);
+
+	if (tail) {
+		/* The ciphertext is saved since @dst and @src may overlap */
+		memcpy(ct, src + len, n);
+		memcpy(buf, ct, n);
+		sm4_neon_crypt(rk, buf, buf, 4);
+		xor_bytes(buf, iv, SM4_BLOCK_SIZE);
+		xor_bytes(buf + SM4_BLOCK_SIZE, ct, n - SM4_BLOCK_SIZE);
+		memcpy(dst + len, buf, n);
+		memcpy(iv, ct + n - SM4_BLOCK_SIZE, SM4_BLOCK_SIZE);
+		memzero_explicit(buf, sizeof(buf));
+	}
+}
+
+static void neon_ctr_be_enc(const uint32_t rk[32], uint8_t *dst,
+			    const uint8_t *src, unsigned int block_count,
+			    uint8_t ctr[SM4_BLOCK_SIZE])
+{
+	uint8_t buf[SM4_BLOCK_SIZE * 4] = { };
+	unsigned int tail = block_count % 4;
+	size_t len = (block_count - tail) * SM4_BLOCK_SIZE;
+	unsigned int n = 0;
+
+	if (len)
+		sm4_neon_ctr_encrypt(rk, dst, src, block_count - tail, ctr);
+
+	if (tail) {
+		for (n = 0; n < tail; n++) {
+			memcpy(buf + n * SM4_BLOCK_SIZE, ctr, SM4_BLOCK_SIZE);
+			ctr_be_inc(ctr);
+		}
+		sm4_neon_crypt(rk, buf, buf, 4);
+		xor_bytes(buf, src + len, tail * SM4_BLOCK_SIZE);
+		memcpy(dst + len, buf, tail * SM4_BLOCK_SIZE);
+		memzero_explicit(buf, sizeof(buf));
+	}
+}
+
+TEE_Result crypto_accel_sm4_ecb(void *out, const void *in,
+				const uint32_t rk[32],
+				unsigned int block_count)
+{
+	uint32_t vfp_state = 0;
+	bool ce = use_ce();
+
+	if (!ce && !IS_ENABLED(CFG_CRYPTO_SM4_ARM_NEON))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	vfp_state = thread_kernel_enable_vfp();
+	if (ce)
+		sm4_ce_crypt(rk, out, in, block_count);
+	else
+		neon_ecb(rk, out, in, block_count);
+	thread_kernel_disable_vfp(vfp_state);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result crypto_accel_sm4_cbc_dec(void *out, const void *in,
+				    const uint32_t rk[32],
+				    unsigned int block_count, void *iv)
+{
+	uint32_t vfp_state = 0;
+	bool ce = use_ce();
+
+	if (!ce && !IS_ENABLED(CFG_CRYPTO_SM4_ARM_NEON))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	vfp_state = thread_kernel_enable_vfp();
+	if (ce)
+		sm4_ce_cbc_decrypt(rk, out, in, block_count, iv);
+	else
+		neon_cbc_dec(rk, out, in, block_count, iv);
+	thread_kernel_disable_vfp(vfp_state);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result crypto_accel_sm4_ctr_be_enc(void *out, const void *in,
+				       const uint32_t rk[32],
+				       unsigned int block_count, void *ctr)
+{
+	uint32_t vfp_state = 0;
+	bool ce = use_ce();
+
+	if (!ce && !IS_ENABLED(CFG_CRYPTO_SM4_ARM_NEON))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	vfp_state = thread_kernel_enable_vfp();
+	if (ce)
+		sm4_ce_ctr_encrypt(rk, out, in, block_count, ctr);
+	else
+		neon_ctr_be_enc(rk, out, in, block_count, ctr);
+	thread_kernel_disable_vfp(vfp_state);
+
+	return TEE_SUCCESS;
+}
@@ -1,3 +1,10 @@
+ifneq (,$(filter y,$(CFG_CRYPTO_WITH_CE) $(CFG_CRYPTO_AES_ARM_CE) \
+		   $(CFG_CRYPTO_SHA1_ARM_CE) $(CFG_CRYPTO_SHA256_ARM_CE) \
+		   $(CFG_CRYPTO_SHA512_ARM_CE) $(CFG_CRYPTO_SM3_ARM_CE) \
+		   $(CFG_CRYPTO_SM4_ARM_CE)))
+srcs-y += accel_caps.c
+endif
+
 ifeq ($(CFG_CRYPTO_WITH_CE),y)
 srcs-$(CFG_ARM64_core) += ghash-ce-core_a64.S
 srcs-$(CFG_ARM32_core) += ghash-ce-core_a32.S
@@ -22,3 +29,25 @@ srcs-y += sha256_armv8a_ce.c
 srcs-$(CFG_ARM64_core) += sha256_armv8a_ce_a64.S
 srcs-$(CFG_ARM32_core) += sha256_armv8a_ce_a32.S
 endif
+
+ifeq ($(CFG_CRYPTO_SHA512_ARM_CE),y)
+srcs-y += sha512_armv8a_ce.c
+srcs-$(CFG_ARM64_core) += sha512_armv8a_ce_a64.S
+endif
+
+ifneq (,$(filter y,$(CFG_CRYPTO_SM3_ARM_CE) $(CFG_CRYPTO_SM3_ARM_NEON)))
+srcs-y += sm3_arm.c
+srcs-$(CFG_CRYPTO_SM3_ARM_CE) += sm3_armv8a_ce_a64.S
+srcs-$(CFG_CRYPTO_SM3_ARM_NEON) += sm3_neon_a64.S
+endif
+
+ifneq (,$(filter y,$(CFG_CRYPTO_SM4_ARM_CE) $(CFG_CRYPTO_SM4_ARM_NEON)))
+srcs-y += sm4_arm.c
+srcs-$(CFG_CRYPTO_SM4_ARM_CE) += sm4_armv8a_ce_a64.S
+srcs-$(CFG_CRYPTO_SM4_ARM_NEON) += sm4_neon_a64.S
+endif
+
+ifeq ($(CFG_CRYPTO_CHACHA20_ARM_NEON),y)
+srcs-y += chacha_neon.c
+srcs-y += chacha_neon_a64.S
+endif
@@ -125,6 +125,95 @@ static inline bool feat_bti_is_implemented(void)
 		FEAT_BTI_IMPLEMENTED);
 #endif
 }
+
+/*
+ * The Cryptographic Extension is described by ID_ISAR5 on ARM32 and by
+ * ID_AA64ISAR0_EL1 on ARM64, both registers use the same encoding.
+ */
+#define FEAT_AES_IMPLEMENTED	U(0x1)
+#define FEAT_PMULL_IMPLEMENTED	U(0x2)
+#define FEAT_SHA1_IMPLEMENTED	U(0x1)
+#define FEAT_SHA256_IMPLEMENTED	U(0x1)
+
+static inline unsigned int read_feat_aes(void)
+{
+#ifdef ARM32
+	return (read_id_isar5() >> ID_ISAR5_AES_SHIFT) & ID_ISAR5_AES_MASK;
+#else
+	return (read_id_aa64isar0_el1() >> ID_AA64ISAR0_EL1_AES_SHIFT) &
+	       ID_AA64ISAR0_EL1_AES_MASK;
+#endif
+}
+
+static inline unsigned int read_feat_sha1(void)
+{
+#ifdef ARM32
+	return (read_id_isar5() >> ID_ISAR5_SHA1_SHIFT) & ID_ISAR5_SHA1_MASK;
+#else
+	return (read_id_aa64isar0_el1() >> ID_AA64ISAR0_EL1_SHA1_SHIFT) &
+	       ID_AA64ISAR0_EL1_SHA1_MASK;
+#endif
+}
+
+static inline unsigned int read_feat_sha2(void)
+{
+#ifdef ARM32
+	return (read_id_isar5() >> ID_ISAR5_SHA2_SHIFT) & ID_ISAR5_SHA2_MASK;
+#else
+	return (read_id_aa64isar0_el1() >> ID_AA64ISAR0_EL1_SHA2_SHIFT) &
+	       ID_AA64ISAR0_EL1_SHA2_MASK;
+#endif
+}
+
+static inline bool feat_aes_is_implemented(void)
+{
+	return read_feat_aes() >= FEAT_AES_IMPLEMENTED;
+}
+
+static inline bool feat_pmull_is_implemented(void)
+{
+	return read_feat_aes() >= FEAT_PMULL_IMPLEMENTED;
+}
+
+static inline bool feat_sha1_is_implemented(void)
+{
+	return read_feat_sha1() >= FEAT_SHA1_IMPLEMENTED;
+}
+
+static inline bool feat_sha256_is_implemented(void)
+{
+	return read_feat_sha2() >= FEAT_SHA256_IMPLEMENTED;
+}
+
+static inline bool feat_sha512_is_implemented(void)
+{
+#ifdef ARM32
+	return false;
+#else
+	return read_feat_sha2() >= FEAT_SHA512_IMPLEMENTED;
+#endif
+}
+
+/* The SM3 and SM4 instructions are only available in AArch64 state */
+static inline bool feat_sm3_is_implemented(void)
+{
+#ifdef ARM32
+	return false;
+#else
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_EL1_SM3_SHIFT) &
+		ID_AA64ISAR0_EL1_SM3_MASK) >= FEAT_SM3_IMPLEMENTED;
+#endif
+}
+
+static inline bool feat_sm4_is_implemented(void)
+{
+#ifdef ARM32
+	return false;
+#else
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_EL1_SM4_SHIFT) &
+		ID_AA64ISAR0_EL1_SM4_MASK) >= FEAT_SM4_IMPLEMENTED;
+#endif
+}
 #endif
 
 #endif /*ARM_H*/
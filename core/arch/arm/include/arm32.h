@@ -163,6 +163,14 @@
 #define IDPFR1_GENTIMER_SHIFT        U(16)
 #define IDPFR1_GENTIMER_MASK         SHIFT_U32(0xF, IDPFR1_GENTIMER_SHIFT)
 
+/* ID_ISAR5 bit fields */
+#define ID_ISAR5_AES_SHIFT	U(4)
+#define ID_ISAR5_AES_MASK	U(0xf)
+#define ID_ISAR5_SHA1_SHIFT	U(8)
+#define ID_ISAR5_SHA1_MASK	U(0xf)
+#define ID_ISAR5_SHA2_SHIFT	U(12)
+#define ID_ISAR5_SHA2_MASK	U(0xf)
+
 /* Generic timer registers and fields */
 #define CNTCR_OFFSET		0x000
 #define CNTSR_OFFSET		0x004
@@ -199,6 +199,20 @@
 #define ID_AA64PFR1_EL1_BT_MASK	ULL(0xf)
 #define FEAT_BTI_IMPLEMENTED	ULL(0x1)
 
+#define ID_AA64ISAR0_EL1_AES_SHIFT	U(4)
+#define ID_AA64ISAR0_EL1_AES_MASK	ULL(0xf)
+#define ID_AA64ISAR0_EL1_SHA1_SHIFT	U(8)
+#define ID_AA64ISAR0_EL1_SHA1_MASK	ULL(0xf)
+#define ID_AA64ISAR0_EL1_SHA2_SHIFT	U(12)
+#define ID_AA64ISAR0_EL1_SHA2_MASK	ULL(0xf)
+#define FEAT_SHA512_IMPLEMENTED		ULL(0x2)
+#define ID_AA64ISAR0_EL1_SM3_SHIFT	U(36)
+#define ID_AA64ISAR0_EL1_SM3_MASK	ULL(0xf)
+#define ID_AA64ISAR0_EL1_SM4_SHIFT	U(40)
+#define ID_AA64ISAR0_EL1_SM4_MASK	ULL(0xf)
+#define FEAT_SM3_IMPLEMENTED		ULL(0x1)
+#define FEAT_SM4_IMPLEMENTED		ULL(0x1)
+
 #ifndef __ASSEMBLER__
 static inline __noprof void isb(void)
 {
@@ -359,6 +373,7 @@ DEFINE_U64_REG_READ_FUNC(par_el1)
 DEFINE_U64_REG_WRITE_FUNC(mair_el1)
 
 DEFINE_U64_REG_READ_FUNC(id_aa64pfr1_el1)
+DEFINE_U64_REG_READ_FUNC(id_aa64isar0_el1)
 
 /* Register read/write functions for GICC registers by using system interface */
 DEFINE_REG_READ_FUNC_(icc_ctlr, uint32_t, S3_0_C12_C12_4)
@@ -13,6 +13,8 @@ struct internal_ghash_key {
 	uint64_t h2[2];
 	uint64_t h3[2];
 	uint64_t h4[2];
+	/* Used by the fallback in core/crypto/aes-gcm-sw.c */
+	uint64_t hash_subkey[2];
 };
 
 void pmull_ghash_update_p64(int blocks, uint64_t dg[2], const uint8_t *src,
@@ -291,6 +291,8 @@
 #define OPTEE_SMC_SEC_CAP_MEMREF_NULL		BIT(4)
 /* Secure world supports asynchronous notification of normal world */
 #define OPTEE_SMC_SEC_CAP_ASYNC_NOTIF		BIT(5)
+/* Secure world supports invoke rings, see OPTEE_MSG_CMD_REGISTER_RING */
+#define OPTEE_SMC_SEC_CAP_INVOKE_RING		BIT(6)
 /* Secure world is built with OCALL support */
 #define OPTEE_SMC_SEC_CAP_OCALL			BIT(31)
 
@@ -139,14 +139,28 @@ TEE_Result ldelf_init_with_ldelf(struct ts_session *sess,
 		return res;
 
 	if (is_user_ta_ctx(uctx->ts_ctx)) {
+		uint32_t flags = arg->flags;
+
 		/*
 		 * This is already checked by the elf loader, but since it runs
 		 * in user mode we're not trusting it entirely.
 		 */
-		if (arg->flags & ~TA_FLAGS_MASK)
+		if (flags & ~TA_FLAGS_MASK)
 			return TEE_ERROR_BAD_FORMAT;
 
-		to_user_ta_ctx(uctx->ts_ctx)->ta_ctx.flags = arg->flags;
+		/*
+		 * A user TA context has a single user stack and a single
+		 * set of parameter mappings, so it can't be entered by
+		 * more than one thread at a time. Ignore a request for
+		 * concurrent entry instead of letting it bypass the busy
+		 * handling in tee_ta_manager.
+		 */
+		if (flags & TA_FLAG_CONCURRENT) {
+			IMSG("TA_FLAG_CONCURRENT ignored for user TA");
+			flags &= ~TA_FLAG_CONCURRENT;
+		}
+
+		to_user_ta_ctx(uctx->ts_ctx)->ta_ctx.flags = flags;
 	}
 
 	uctx->is_32bit = arg->is_32bit;
@@ -34,6 +34,7 @@ static size_t shm_release_waiters;
 struct mobj_reg_shm {
 	struct mobj mobj;
 	SLIST_ENTRY(mobj_reg_shm) next;
+	TAILQ_ENTRY(mobj_reg_shm) map_cache_link;
 	uint64_t cookie;
 	tee_mm_entry_t *mm;
 	paddr_t page_offset;
@@ -41,6 +42,7 @@ struct mobj_reg_shm {
 	bool guarded;
 	bool releasing;
 	bool release_frees;
+	bool map_cached;
 	paddr_t pages[];
 };
 
@@ -55,14 +57,31 @@ static size_t mobj_reg_shm_size(size_t nr_pages)
 	return s;
 }
 
-static SLIST_HEAD(reg_shm_head, mobj_reg_shm) reg_shm_list =
-	SLIST_HEAD_INITIALIZER(reg_shm_head);
+SLIST_HEAD(reg_shm_head, mobj_reg_shm);
+
+/* Registered shared memory hashed by cookie, protected by reg_shm_slist_lock */
+static struct reg_shm_head reg_shm_hash[MOBJ_COOKIE_HASH_SIZE];
 
 static unsigned int reg_shm_slist_lock = SPINLOCK_UNLOCK;
 static unsigned int reg_shm_map_lock = SPINLOCK_UNLOCK;
 
+/*
+ * Registered shared memory which is still mapped while its mapcount is 0,
+ * least recently used first. Protected by reg_shm_map_lock together with
+ * the statistics below.
+ */
+static TAILQ_HEAD(, mobj_reg_shm) reg_shm_map_cache =
+	TAILQ_HEAD_INITIALIZER(reg_shm_map_cache);
+static size_t reg_shm_map_cache_count;
+static struct mobj_reg_shm_stats reg_shm_stats;
+
 static struct mobj_reg_shm *to_mobj_reg_shm(struct mobj *mobj);
 
+static struct reg_shm_head *reg_shm_bucket(uint64_t cookie)
+{
+	return reg_shm_hash + mobj_cookie_hash(cookie);
+}
+
 static TEE_Result mobj_reg_shm_get_pa(struct mobj *mobj, size_t offst,
 				      size_t granule, paddr_t *pa)
 {
@@ -112,13 +131,55 @@ static void *mobj_reg_shm_get_va(struct mobj *mobj, size_t offst, size_t len)
 				 mrs->page_offset);
 }
 
+static void reg_shm_map_cache_remove(struct mobj_reg_shm *r)
+{
+	assert(r->map_cached && reg_shm_map_cache_count);
+	TAILQ_REMOVE(&reg_shm_map_cache, r, map_cache_link);
+	reg_shm_map_cache_count--;
+	r->map_cached = false;
+}
+
 static void reg_shm_unmap_helper(struct mobj_reg_shm *r)
 {
 	assert(r->mm);
 	assert(r->mm->pool->shift == SMALL_PAGE_SHIFT);
+	if (r->map_cached)
+		reg_shm_map_cache_remove(r);
 	core_mmu_unmap_pages(tee_mm_get_smem(r->mm), r->mm->size);
 	tee_mm_free(r->mm);
 	r->mm = NULL;
+	reg_shm_stats.unmap_count++;
+}
+
+/* Unmaps the least recently used cached mapping, if any */
+static bool reg_shm_map_cache_evict(void)
+{
+	struct mobj_reg_shm *r = TAILQ_FIRST(&reg_shm_map_cache);
+
+	if (!r)
+		return false;
+
+	reg_shm_unmap_helper(r);
+	return true;
+}
+
+/*
+ * Called when the mapcount of @r has reached 0, keeps @r mapped in the
+ * cache if possible.
+ */
+static void reg_shm_map_cache_add(struct mobj_reg_shm *r)
+{
+	if (!CFG_CORE_REG_SHM_MAP_CACHE_SIZE) {
+		reg_shm_unmap_helper(r);
+		return;
+	}
+
+	if (reg_shm_map_cache_count == CFG_CORE_REG_SHM_MAP_CACHE_SIZE)
+		reg_shm_map_cache_evict();
+
+	TAILQ_INSERT_TAIL(&reg_shm_map_cache, r, map_cache_link);
+	reg_shm_map_cache_count++;
+	r->map_cached = true;
 }
 
 static void reg_shm_free_helper(struct mobj_reg_shm *mobj_reg_shm)
@@ -130,7 +191,8 @@ static void reg_shm_free_helper(struct mobj_reg_shm *mobj_reg_shm)
 
 	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
 
-	SLIST_REMOVE(&reg_shm_list, mobj_reg_shm, mobj_reg_shm, next);
+	SLIST_REMOVE(reg_shm_bucket(mobj_reg_shm->cookie), mobj_reg_shm,
+		     mobj_reg_shm, next);
 	free(mobj_reg_shm);
 }
 
@@ -201,11 +263,22 @@ static TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 
 	/*
 	 * If we have beated another thread calling mobj_reg_shm_dec_map()
-	 * to get the lock we need only to reinitialize mapcount to 1.
+	 * to get the lock or if the mapping is still cached we need only
+	 * to reinitialize mapcount to 1.
 	 */
+	if (r->map_cached) {
+		reg_shm_map_cache_remove(r);
+		reg_shm_stats.map_cache_hits++;
+	}
+
 	if (!r->mm) {
 		sz = ROUNDUP(mobj->size + r->page_offset, SMALL_PAGE_SIZE);
-		r->mm = tee_mm_alloc(&tee_mm_shm, sz);
+		while (true) {
+			r->mm = tee_mm_alloc(&tee_mm_shm, sz);
+			/* Free up virtual memory held by cached mappings */
+			if (r->mm || !reg_shm_map_cache_evict())
+				break;
+		}
 		if (!r->mm) {
 			res = TEE_ERROR_OUT_OF_MEMORY;
 			goto out;
@@ -219,6 +292,7 @@ static TEE_Result mobj_reg_shm_inc_map(struct mobj *mobj)
 			r->mm = NULL;
 			goto out;
 		}
+		reg_shm_stats.map_count++;
 	}
 
 	refcount_set(&r->mapcount, 1);
@@ -238,14 +312,23 @@ static TEE_Result mobj_reg_shm_dec_map(struct mobj *mobj)
 
 	exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
 
-	if (!refcount_val(&r->mapcount))
-		reg_shm_unmap_helper(r);
+	if (!refcount_val(&r->mapcount) && r->mm && !r->map_cached)
+		reg_shm_map_cache_add(r);
 
 	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
 
 	return TEE_SUCCESS;
 }
 
+void mobj_reg_shm_get_stats(struct mobj_reg_shm_stats *stats)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&reg_shm_map_lock);
+
+	*stats = reg_shm_stats;
+	stats->map_cache_count = reg_shm_map_cache_count;
+	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
+}
+
 static bool mobj_reg_shm_matches(struct mobj *mobj, enum buf_is_attr attr);
 
 static uint64_t mobj_reg_shm_get_cookie(struct mobj *mobj)
@@ -332,7 +415,7 @@ struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 	}
 
 	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
-	SLIST_INSERT_HEAD(&reg_shm_list, mobj_reg_shm, next);
+	SLIST_INSERT_HEAD(reg_shm_bucket(cookie), mobj_reg_shm, next);
 	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
 
 	return &mobj_reg_shm->mobj;
@@ -353,7 +436,7 @@ static struct mobj_reg_shm *reg_shm_find_unlocked(uint64_t cookie)
 {
 	struct mobj_reg_shm *mobj_reg_shm = NULL;
 
-	SLIST_FOREACH(mobj_reg_shm, &reg_shm_list, next)
+	SLIST_FOREACH(mobj_reg_shm, reg_shm_bucket(cookie), next)
 		if (mobj_reg_shm->cookie == cookie)
 			return mobj_reg_shm;
 
@@ -35,9 +35,12 @@ SLIST_HEAD(mobj_ffa_head, mobj_ffa);
 static bitstr_t bit_decl(shm_bits, NUM_SHMS);
 #endif
 
-static struct mobj_ffa_head shm_head = SLIST_HEAD_INITIALIZER(shm_head);
-static struct mobj_ffa_head shm_inactive_head =
-	SLIST_HEAD_INITIALIZER(shm_inactive_head);
+/*
+ * Active and inactive mobjs hashed by cookie, use get_bucket() to find the
+ * list a cookie belongs to. Protected by shm_lock.
+ */
+static struct mobj_ffa_head shm_head[MOBJ_COOKIE_HASH_SIZE];
+static struct mobj_ffa_head shm_inactive_head[MOBJ_COOKIE_HASH_SIZE];
 
 static unsigned int shm_lock = SPINLOCK_UNLOCK;
 
@@ -121,6 +124,12 @@ static size_t get_page_count(struct mobj_ffa *mf)
 	return ROUNDUP(mf->mobj.size, SMALL_PAGE_SIZE) / SMALL_PAGE_SIZE;
 }
 
+static struct mobj_ffa_head *get_bucket(struct mobj_ffa_head *heads,
+				       uint64_t cookie)
+{
+	return heads + mobj_cookie_hash(cookie);
+}
+
 static bool cmp_cookie(struct mobj_ffa *mf, uint64_t cookie)
 {
 	return mf->cookie == cookie;
@@ -239,10 +248,13 @@ uint64_t mobj_ffa_push_to_inactive(struct mobj_ffa *mf)
 	uint32_t exceptions = 0;
 
 	exceptions = cpu_spin_lock_xsave(&shm_lock);
-	assert(!find_in_list(&shm_inactive_head, cmp_ptr, (vaddr_t)mf));
-	assert(!find_in_list(&shm_inactive_head, cmp_cookie, mf->cookie));
-	assert(!find_in_list(&shm_head, cmp_cookie, mf->cookie));
-	SLIST_INSERT_HEAD(&shm_inactive_head, mf, link);
+	assert(!find_in_list(get_bucket(shm_inactive_head, mf->cookie),
+			     cmp_ptr, (vaddr_t)mf));
+	assert(!find_in_list(get_bucket(shm_inactive_head, mf->cookie),
+			     cmp_cookie, mf->cookie));
+	assert(!find_in_list(get_bucket(shm_head, mf->cookie),
+			     cmp_cookie, mf->cookie));
+	SLIST_INSERT_HEAD(get_bucket(shm_inactive_head, mf->cookie), mf, link);
 	cpu_spin_unlock_xrestore(&shm_lock, exceptions);
 
 	return mf->cookie;
@@ -266,7 +278,7 @@ TEE_Result mobj_ffa_sel1_spmc_reclaim(uint64_t cookie)
 	uint32_t exceptions = 0;
 
 	exceptions = cpu_spin_lock_xsave(&shm_lock);
-	mf = find_in_list(&shm_head, cmp_cookie, cookie);
+	mf = find_in_list(get_bucket(shm_head, cookie), cmp_cookie, cookie);
 	/*
 	 * If the mobj is found here it's still active and cannot be
 	 * reclaimed.
@@ -278,7 +290,8 @@ TEE_Result mobj_ffa_sel1_spmc_reclaim(uint64_t cookie)
 		goto out;
 	}
 
-	mf = find_in_list(&shm_inactive_head, cmp_cookie, cookie);
+	mf = find_in_list(get_bucket(shm_inactive_head, cookie), cmp_cookie,
+			  cookie);
 	if (!mf) {
 		res = TEE_ERROR_ITEM_NOT_FOUND;
 		goto out;
@@ -293,7 +306,8 @@ TEE_Result mobj_ffa_sel1_spmc_reclaim(uint64_t cookie)
 		goto out;
 	}
 
-	if (!pop_from_list(&shm_inactive_head, cmp_ptr, (vaddr_t)mf))
+	if (!pop_from_list(get_bucket(shm_inactive_head, cookie), cmp_ptr,
+			   (vaddr_t)mf))
 		panic();
 	res = TEE_SUCCESS;
 out:
@@ -312,7 +326,7 @@ TEE_Result mobj_ffa_unregister_by_cookie(uint64_t cookie)
 
 	assert(cookie != OPTEE_MSG_FMEM_INVALID_GLOBAL_ID);
 	exceptions = cpu_spin_lock_xsave(&shm_lock);
-	mf = find_in_list(&shm_head, cmp_cookie, cookie);
+	mf = find_in_list(get_bucket(shm_head, cookie), cmp_cookie, cookie);
 	/*
 	 * If the mobj is found here it's still active and cannot be
 	 * unregistered.
@@ -323,7 +337,8 @@ TEE_Result mobj_ffa_unregister_by_cookie(uint64_t cookie)
 		res = TEE_ERROR_BUSY;
 		goto out;
 	}
-	mf = find_in_list(&shm_inactive_head, cmp_cookie, cookie);
+	mf = find_in_list(get_bucket(shm_inactive_head, cookie), cmp_cookie,
+			  cookie);
 	/*
 	 * If the mobj isn't found or if it already has been unregistered.
 	 */
@@ -337,7 +352,8 @@ TEE_Result mobj_ffa_unregister_by_cookie(uint64_t cookie)
 	}
 
 #ifdef CFG_CORE_SEL2_SPMC
-	mf = pop_from_list(&shm_inactive_head, cmp_cookie, cookie);
+	mf = pop_from_list(get_bucket(shm_inactive_head, cookie), cmp_cookie,
+			   cookie);
 	mobj_ffa_sel2_spmc_delete(mf);
 	thread_spmc_relinquish(cookie);
 #else
@@ -359,7 +375,7 @@ struct mobj *mobj_ffa_get_by_cookie(uint64_t cookie,
 	if (internal_offs >= SMALL_PAGE_SIZE)
 		return NULL;
 	exceptions = cpu_spin_lock_xsave(&shm_lock);
-	mf = find_in_list(&shm_head, cmp_cookie, cookie);
+	mf = find_in_list(get_bucket(shm_head, cookie), cmp_cookie, cookie);
 	if (mf) {
 		if (mf->page_offset == internal_offs) {
 			if (!refcount_inc(&mf->mobj.refc)) {
@@ -379,7 +395,8 @@ struct mobj *mobj_ffa_get_by_cookie(uint64_t cookie,
 			mf = NULL;
 		}
 	} else {
-		mf = pop_from_list(&shm_inactive_head, cmp_cookie, cookie);
+		mf = pop_from_list(get_bucket(shm_inactive_head, cookie),
+				   cmp_cookie, cookie);
 #if defined(CFG_CORE_SEL2_SPMC)
 		/* Try to retrieve it from the SPM at S-EL2 */
 		if (mf) {
@@ -417,7 +434,8 @@ struct mobj *mobj_ffa_get_by_cookie(uint64_t cookie,
 			mf->mobj.size -= internal_offs;
 			mf->page_offset = internal_offs;
 
-			SLIST_INSERT_HEAD(&shm_head, mf, link);
+			SLIST_INSERT_HEAD(get_bucket(shm_head, cookie), mf,
+					  link);
 		}
 	}
 
@@ -497,10 +515,11 @@ static void ffa_inactivate(struct mobj *mobj)
 	}
 
 	DMSG("cookie %#"PRIx64, mf->cookie);
-	if (!pop_from_list(&shm_head, cmp_ptr, (vaddr_t)mf))
+	if (!pop_from_list(get_bucket(shm_head, mf->cookie), cmp_ptr,
+			   (vaddr_t)mf))
 		panic();
 	unmap_helper(mf);
-	SLIST_INSERT_HEAD(&shm_inactive_head, mf, link);
+	SLIST_INSERT_HEAD(get_bucket(shm_inactive_head, mf->cookie), mf, link);
 out:
 	cpu_spin_unlock_xrestore(&shm_lock, exceptions);
 }
@@ -121,6 +121,9 @@ static const struct syscall_entry tee_svc_syscall_table[] = {
 	SYSCALL_ENTRY(syscall_not_supported),
 	SYSCALL_ENTRY(syscall_not_supported),
 	SYSCALL_ENTRY(syscall_cache_operation),
+	SYSCALL_ENTRY(syscall_hash_oneshot),
+	SYSCALL_ENTRY(syscall_cipher_oneshot),
+	SYSCALL_ENTRY(syscall_authenc_oneshot),
 };
 
 /*
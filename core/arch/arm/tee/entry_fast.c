@@ -105,8 +105,11 @@ static void tee_entry_exchange_capabilities(struct thread_smc_args *args)
 		
 #if defined(CFG_CORE_DYN_SHM)
 	dyn_shm_en = core_mmu_nsec_ddr_is_defined();
-	if (dyn_shm_en)
+	if (dyn_shm_en) {
 		args->a1 |= OPTEE_SMC_SEC_CAP_DYNAMIC_SHM;
+		if (IS_ENABLED(CFG_CORE_INVOKE_RING))
+			args->a1 |= OPTEE_SMC_SEC_CAP_INVOKE_RING;
+	}
 #endif
 
 	DMSG("Dynamic shared memory is %sabled", dyn_shm_en ? "en" : "dis");
@@ -47,10 +47,15 @@ CFG_CRYPTO_ECC ?= y
 CFG_CRYPTO_SM2_PKE ?= y
 CFG_CRYPTO_SM2_DSA ?= y
 CFG_CRYPTO_SM2_KEP ?= y
+# X25519 key agreement (RFC 7748) and pure Ed25519 signatures (RFC 8032)
+CFG_CRYPTO_X25519 ?= y
+CFG_CRYPTO_ED25519 ?= y
 
 # Authenticated encryption
 CFG_CRYPTO_CCM ?= y
 CFG_CRYPTO_GCM ?= y
+# ChaCha20-Poly1305 (RFC 8439), an OP-TEE extension to the GP algorithms
+CFG_CRYPTO_CHACHA20_POLY1305 ?= y
 # Default uses the OP-TEE internal AES-GCM implementation
 CFG_CRYPTO_AES_GCM_FROM_CRYPTOLIB ?= n
 
@@ -75,10 +80,29 @@ $(call force,CFG_AES_GCM_TABLE_BASED,n,conflicts with CFG_CRYPTO_WITH_CE)
 # assume they are implicitly contained in CFG_CRYPTO_WITH_CE=y.
 CFG_HWSUPP_PMULT_64 ?= y
 
+# The accelerated implementations below are only used if the CPU
+# implements the instructions they need. This is probed at runtime, see
+# crypto_accel_get_caps(), with a fallback to the software implementation
+# so the same binary can run on CPUs without the Cryptographic Extensions.
 CFG_CRYPTO_SHA256_ARM_CE ?= $(CFG_CRYPTO_SHA256)
 CFG_CORE_CRYPTO_SHA256_ACCEL ?= $(CFG_CRYPTO_SHA256_ARM_CE)
 CFG_CRYPTO_SHA1_ARM_CE ?= $(CFG_CRYPTO_SHA1)
 CFG_CORE_CRYPTO_SHA1_ACCEL ?= $(CFG_CRYPTO_SHA1_ARM_CE)
+# The SHA-512 instructions are an optional AArch64 extension from ARMv8.2
+ifeq ($(CFG_ARM64_core),y)
+CFG_CRYPTO_SHA512_ARM_CE ?= $(CFG_CRYPTO_SHA512)
+else
+$(call force,CFG_CRYPTO_SHA512_ARM_CE,n,requires AArch64)
+endif
+CFG_CORE_CRYPTO_SHA512_ACCEL ?= $(CFG_CRYPTO_SHA512_ARM_CE)
+# The SM3 and SM4 instructions are optional AArch64 extensions from ARMv8.2
+ifeq ($(CFG_ARM64_core),y)
+CFG_CRYPTO_SM3_ARM_CE ?= $(CFG_CRYPTO_SM3)
+CFG_CRYPTO_SM4_ARM_CE ?= $(CFG_CRYPTO_SM4)
+else
+$(call force,CFG_CRYPTO_SM3_ARM_CE,n,requires AArch64)
+$(call force,CFG_CRYPTO_SM4_ARM_CE,n,requires AArch64)
+endif
 CFG_CRYPTO_AES_ARM_CE ?= $(CFG_CRYPTO_AES)
 CFG_CORE_CRYPTO_AES_ACCEL ?= $(CFG_CRYPTO_AES_ARM_CE)
 
@@ -88,6 +112,28 @@ CFG_AES_GCM_TABLE_BASED ?= y
 
 endif #!CFG_CRYPTO_WITH_CE
 
+# SM3 and SM4 fall back to Advanced SIMD, which is mandatory in ARMv8-A, on
+# CPUs without the ARMv8.2 SM3 and SM4 instructions
+ifeq ($(CFG_ARM64_core),y)
+CFG_CRYPTO_SM3_ARM_NEON ?= $(CFG_CRYPTO_SM3)
+CFG_CRYPTO_SM4_ARM_NEON ?= $(CFG_CRYPTO_SM4)
+else
+$(call force,CFG_CRYPTO_SM3_ARM_NEON,n,requires AArch64)
+$(call force,CFG_CRYPTO_SM4_ARM_NEON,n,requires AArch64)
+endif
+CFG_CORE_CRYPTO_SM3_ACCEL ?= $(call cfg-one-enabled,CFG_CRYPTO_SM3_ARM_CE \
+					CFG_CRYPTO_SM3_ARM_NEON)
+CFG_CORE_CRYPTO_SM4_ACCEL ?= $(call cfg-one-enabled,CFG_CRYPTO_SM4_ARM_CE \
+					CFG_CRYPTO_SM4_ARM_NEON)
+
+# ChaCha20 only needs Advanced SIMD which, unlike the Cryptographic
+# Extensions, is mandatory in ARMv8-A so there's nothing to probe at runtime
+ifeq ($(CFG_ARM64_core),y)
+CFG_CRYPTO_CHACHA20_ARM_NEON ?= $(CFG_CRYPTO_CHACHA20_POLY1305)
+else
+$(call force,CFG_CRYPTO_CHACHA20_ARM_NEON,n,requires AArch64)
+endif
+CFG_CORE_CRYPTO_CHACHA20_ACCEL ?= $(CFG_CRYPTO_CHACHA20_ARM_NEON)
 
 # Cryptographic extensions can only be used safely when OP-TEE knows how to
 # preserve the VFP context
@@ -100,9 +146,27 @@ endif
 ifeq ($(CFG_CRYPTO_SHA1_ARM_CE),y)
 $(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SHA1_ARM_CE)
 endif
+ifeq ($(CFG_CRYPTO_SHA512_ARM_CE),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SHA512_ARM_CE)
+endif
 ifeq ($(CFG_CRYPTO_AES_ARM_CE),y)
 $(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_AES_ARM_CE)
 endif
+ifeq ($(CFG_CRYPTO_SM3_ARM_CE),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM3_ARM_CE)
+endif
+ifeq ($(CFG_CRYPTO_SM4_ARM_CE),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM4_ARM_CE)
+endif
+ifeq ($(CFG_CRYPTO_SM3_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM3_ARM_NEON)
+endif
+ifeq ($(CFG_CRYPTO_SM4_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_SM4_ARM_NEON)
+endif
+ifeq ($(CFG_CRYPTO_CHACHA20_ARM_NEON),y)
+$(call force,CFG_WITH_VFP,y,required by CFG_CRYPTO_CHACHA20_ARM_NEON)
+endif
 
 cryp-enable-all-depends = $(call cfg-enable-all-depends,$(strip $(1)),$(foreach v,$(2),CFG_CRYPTO_$(v)))
 $(eval $(call cryp-enable-all-depends,CFG_REE_FS, AES ECB CTR HMAC SHA256 GCM))
@@ -149,26 +213,45 @@ ifeq ($(CFG_CRYPTOLIB_NAME),tomcrypt)
 # Disable DSA if any is missing.
 $(eval $(call cryp-dep-all, DSA, SHA256 SHA384 SHA512))
 
+# Cache values derived from RSA private keys which don't change from one
+# private key operation to the next: R^2 mod n, p and q used by the
+# Montgomery multiplications and the blinding pair, which is then updated
+# by squaring. Takes about 1.5 KiB of heap per 2048-bit key object.
+CFG_CRYPTO_RSA_KEY_CACHE ?= $(CFG_CRYPTO_RSA)
+$(eval $(call cryp-dep-one, RSA_KEY_CACHE, RSA))
+
+# Cache precomputed comb tables for the generator of the NIST P-256 and
+# P-384 curves to speed up ECDSA signing and ECC key generation. The
+# tables are computed on first use.
+CFG_CRYPTO_ECC_FIXED_BASE ?= $(CFG_CRYPTO_ECC)
+# Number of ECC public keys for which precomputed tables are cached to
+# speed up repeated ECDSA verifications with the same key, 0 disables.
+# Each table takes about 2 KiB of heap for P-256 and 3 KiB for P-384.
+CFG_CRYPTO_ECC_VERIFY_TABLES ?= 0
+$(eval $(call cryp-dep-one, ECC_FIXED_BASE, ECC))
+
 # Assign _CFG_CORE_LTC_xxx based on CFG_CRYPTO_yyy
 core-ltc-vars = AES DES
 core-ltc-vars += ECB CBC CTR CTS XTS
 core-ltc-vars += MD5 SHA1 SHA224 SHA256 SHA384 SHA512 SHA512_256
 core-ltc-vars += HMAC CMAC CBC_MAC
-core-ltc-vars += CCM
+core-ltc-vars += CCM CHACHA20_POLY1305
 ifeq ($(CFG_CRYPTO_AES_GCM_FROM_CRYPTOLIB),y)
 core-ltc-vars += GCM
 endif
-core-ltc-vars += RSA DSA DH ECC
+core-ltc-vars += RSA RSA_KEY_CACHE DSA DH ECC ECC_FIXED_BASE
 core-ltc-vars += SIZE_OPTIMIZATION
 core-ltc-vars += SM2_PKE
 core-ltc-vars += SM2_DSA
 core-ltc-vars += SM2_KEP
+core-ltc-vars += X25519 ED25519
 # Assigned selected CFG_CRYPTO_xxx as _CFG_CORE_LTC_xxx
 $(foreach v, $(core-ltc-vars), $(eval _CFG_CORE_LTC_$(v) := $(CFG_CRYPTO_$(v))))
 _CFG_CORE_LTC_MPI := $(CFG_CORE_MBEDTLS_MPI)
 _CFG_CORE_LTC_AES_ACCEL := $(CFG_CORE_CRYPTO_AES_ACCEL)
 _CFG_CORE_LTC_SHA1_ACCEL := $(CFG_CORE_CRYPTO_SHA1_ACCEL)
 _CFG_CORE_LTC_SHA256_ACCEL := $(CFG_CORE_CRYPTO_SHA256_ACCEL)
+_CFG_CORE_LTC_SHA512_ACCEL := $(CFG_CORE_CRYPTO_SHA512_ACCEL)
 endif
 
 ###############################################################
@@ -185,6 +268,9 @@ _CFG_CORE_LTC_SHA384_DESC := $(CFG_CRYPTO_DSA)
 _CFG_CORE_LTC_SHA512_DESC := $(CFG_CRYPTO_DSA)
 _CFG_CORE_LTC_XTS := $(CFG_CRYPTO_XTS)
 _CFG_CORE_LTC_CCM := $(CFG_CRYPTO_CCM)
+_CFG_CORE_LTC_CHACHA20_POLY1305 := $(CFG_CRYPTO_CHACHA20_POLY1305)
+_CFG_CORE_LTC_X25519 := $(CFG_CRYPTO_X25519)
+_CFG_CORE_LTC_ED25519 := $(CFG_CRYPTO_ED25519)
 _CFG_CORE_LTC_AES_DESC := $(call cfg-one-enabled, CFG_CRYPTO_XTS CFG_CRYPTO_CCM)
 endif
 
@@ -197,9 +283,11 @@ _CFG_CORE_LTC_SHA256_DESC := $(call cfg-one-enabled, _CFG_CORE_LTC_SHA256_DESC \
 						     _CFG_CORE_LTC_SHA256)
 _CFG_CORE_LTC_SHA384_DESC := $(call cfg-one-enabled, _CFG_CORE_LTC_SHA384_DESC \
 						     _CFG_CORE_LTC_SHA384)
+# Ed25519 hashes with SHA-512 internally
 _CFG_CORE_LTC_SHA512_DESC := $(call cfg-one-enabled, _CFG_CORE_LTC_SHA512_DESC \
 						     _CFG_CORE_LTC_SHA512_256 \
-						     _CFG_CORE_LTC_SHA512)
+						     _CFG_CORE_LTC_SHA512 \
+						     _CFG_CORE_LTC_ED25519)
 _CFG_CORE_LTC_AES_DESC := $(call cfg-one-enabled, _CFG_CORE_LTC_AES_DESC \
 						  _CFG_CORE_LTC_AES)
 
@@ -214,18 +302,22 @@ else
 _CFG_CORE_LTC_OPTEE_THREAD := n
 endif
 _CFG_CORE_LTC_HWSUPP_PMULL := $(CFG_HWSUPP_PMULL)
+_CFG_CORE_LTC_CHACHA20_ACCEL := $(CFG_CORE_CRYPTO_CHACHA20_ACCEL)
 
 # Assign aggregated variables
 ltc-one-enabled = $(call cfg-one-enabled,$(foreach v,$(1),_CFG_CORE_LTC_$(v)))
 _CFG_CORE_LTC_ACIPHER := $(call ltc-one-enabled, RSA DSA DH ECC)
-_CFG_CORE_LTC_AUTHENC := $(and $(filter y,$(_CFG_CORE_LTC_AES_DESC)), \
-			       $(filter y,$(call ltc-one-enabled, CCM GCM)))
+_CFG_CORE_LTC_AUTHENC := $(or $(and $(filter y,$(_CFG_CORE_LTC_AES_DESC)), \
+				    $(filter y,$(call ltc-one-enabled, CCM GCM))), \
+			      $(filter y,$(_CFG_CORE_LTC_CHACHA20_POLY1305)))
 _CFG_CORE_LTC_CIPHER := $(call ltc-one-enabled, AES_DESC DES)
 _CFG_CORE_LTC_HASH := $(call ltc-one-enabled, MD5 SHA1 SHA224 SHA256 SHA384 \
 					      SHA512)
-_CFG_CORE_LTC_MAC := $(call ltc-one-enabled, HMAC CMAC CBC_MAC)
+_CFG_CORE_LTC_MAC := $(call ltc-one-enabled, HMAC CMAC CBC_MAC \
+					     CHACHA20_POLY1305)
 _CFG_CORE_LTC_CBC := $(call ltc-one-enabled, CBC CBC_MAC)
 _CFG_CORE_LTC_ASN1 := $(call ltc-one-enabled, RSA DSA ECC)
+_CFG_CORE_LTC_CURVE25519 := $(call ltc-one-enabled, X25519 ED25519)
 
 ###############################################################
 # Platform independent crypto-driver configuration
@@ -233,6 +325,12 @@ _CFG_CORE_LTC_ASN1 := $(call ltc-one-enabled, RSA DSA ECC)
 CRYPTO_MAKEFILES := $(sort $(wildcard core/drivers/crypto/*/crypto.mk))
 include $(CRYPTO_MAKEFILES)
 
+# The RSA key cache is part of the LibTomCrypt RSA implementation, which a
+# crypto driver may have replaced above
+_CFG_CORE_LTC_RSA_KEY_CACHE := $(call cfg-all-enabled, \
+					_CFG_CORE_LTC_RSA \
+					_CFG_CORE_LTC_RSA_KEY_CACHE)
+
 # Enable TEE_ALG_RSASSA_PKCS1_V1_5 algorithm for signing with PKCS#1 v1.5 EMSA
 # without ASN.1 around the hash.
 ifeq ($(CFG_CRYPTOLIB_NAME),tomcrypt)
@@ -46,26 +46,21 @@ gcm-revised-spec.pdf
  * is the high-order bit of HH corresponds to P^0 and the low-order bit of HL
  * corresponds to P^127.
  */
-void internal_aes_gcm_ghash_gen_tbl(struct internal_ghash_key *ghash_key,
-				    const struct internal_aes_gcm_key *ek)
+static void gen_tbl(uint64_t HL[16], uint64_t HH[16], const unsigned char h[16])
 {
 	int i, j;
 	uint64_t vl, vh;
-	unsigned char h[16];
-
-	memset(h, 0, 16);
-	crypto_aes_enc_block(ek->data, sizeof(ek->data), ek->rounds, h, h);
 
 	vh = get_be64(h);
 	vl = get_be64(h + 8);
 
 	/* 8 = 1000 corresponds to 1 in GF(2^128) */
-	ghash_key->HL[8] = vl;
-	ghash_key->HH[8] = vh;
+	HL[8] = vl;
+	HH[8] = vh;
 
 	/* 0 corresponds to 0 in GF(2^128) */
-	ghash_key->HH[0] = 0;
-	ghash_key->HL[0] = 0;
+	HH[0] = 0;
+	HL[0] = 0;
 
 	for (i = 4; i > 0; i >>= 1) {
 		uint32_t T = (vl & 1) * 0xe1000000U;
@@ -73,23 +68,40 @@ void internal_aes_gcm_ghash_gen_tbl(struct internal_ghash_key *ghash_key,
 		vl  = (vh << 63) | (vl >> 1);
 		vh  = (vh >> 1) ^ ((uint64_t)T << 32);
 
-		ghash_key->HL[i] = vl;
-		ghash_key->HH[i] = vh;
+		HL[i] = vl;
+		HH[i] = vh;
 	}
 
 	for (i = 2; i <= 8; i *= 2) {
-		uint64_t *HiL = ghash_key->HL + i;
-		uint64_t *HiH = ghash_key->HH + i;
+		uint64_t *HiL = HL + i;
+		uint64_t *HiH = HH + i;
 
 		vh = *HiH;
 		vl = *HiL;
 		for (j = 1; j < i; j++) {
-			HiH[j] = vh ^ ghash_key->HH[j];
-			HiL[j] = vl ^ ghash_key->HL[j];
+			HiH[j] = vh ^ HH[j];
+			HiL[j] = vl ^ HL[j];
 		}
 	}
 }
 
+/*
+ * Generates the tables for H and for H^2, the latter is used to hash two
+ * blocks with a single pass, see internal_aes_gcm_ghash_mult2_tbl().
+ */
+void internal_aes_gcm_ghash_gen_tbl(struct internal_ghash_key *ghash_key,
+				    const struct internal_aes_gcm_key *ek)
+{
+	unsigned char h[16];
+
+	memset(h, 0, 16);
+	crypto_aes_enc_block(ek->data, sizeof(ek->data), ek->rounds, h, h);
+
+	gen_tbl(ghash_key->HL, ghash_key->HH, h);
+	internal_aes_gcm_ghash_mult_tbl(ghash_key, h, h);
+	gen_tbl(ghash_key->H2L, ghash_key->H2H, h);
+}
+
 /*
  * Shoup's method for multiplication use this table with
  *      last4[x] = x times P^128
@@ -143,3 +155,51 @@ void internal_aes_gcm_ghash_mult_tbl(struct internal_ghash_key *ghash_key,
 	put_be64(output, zh);
 	put_be64(output + 8, zl);
 }
+
+/*
+ * Sets output to x1 times H^2 plus x2 times H using the precomputed
+ * tables. Since the shift and reduction steps of Shoup's method are
+ * linear they're shared between the two products, so hashing two blocks
+ * this way is cheaper than two calls to internal_aes_gcm_ghash_mult_tbl().
+ */
+void internal_aes_gcm_ghash_mult2_tbl(struct internal_ghash_key *ghash_key,
+				      const unsigned char x1[16],
+				      const unsigned char x2[16],
+				      unsigned char output[16])
+{
+	int i = 0;
+	unsigned char lo1 = 0, hi1 = 0, lo2 = 0, hi2 = 0, rem = 0;
+	uint64_t zh = 0, zl = 0;
+
+	lo1 = x1[15] & 0xf;
+	lo2 = x2[15] & 0xf;
+
+	zh = ghash_key->H2H[lo1] ^ ghash_key->HH[lo2];
+	zl = ghash_key->H2L[lo1] ^ ghash_key->HL[lo2];
+
+	for (i = 15; i >= 0; i--) {
+		lo1 = x1[i] & 0xf;
+		hi1 = x1[i] >> 4;
+		lo2 = x2[i] & 0xf;
+		hi2 = x2[i] >> 4;
+
+		if (i != 15) {
+			rem = (unsigned char)zl & 0xf;
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4);
+			zh ^= (uint64_t)last4[rem] << 48;
+			zh ^= ghash_key->H2H[lo1] ^ ghash_key->HH[lo2];
+			zl ^= ghash_key->H2L[lo1] ^ ghash_key->HL[lo2];
+		}
+
+		rem = (unsigned char)zl & 0xf;
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4);
+		zh ^= (uint64_t)last4[rem] << 48;
+		zh ^= ghash_key->H2H[hi1] ^ ghash_key->HH[hi2];
+		zl ^= ghash_key->H2L[hi1] ^ ghash_key->HL[hi2];
+	}
+
+	put_be64(output, zh);
+	put_be64(output + 8, zl);
+}
@@ -10,6 +10,17 @@
 #include <tee_api_types.h>
 #include <types_ext.h>
 
+#ifdef CFG_CRYPTO_WITH_CE
+/*
+ * Only used as fallback by the implementation in core/arch/arm/crypto/
+ * when the CPU lacks the needed instructions.
+ */
+#define internal_aes_gcm_set_key internal_aes_gcm_set_key_sw
+#define internal_aes_gcm_ghash_update internal_aes_gcm_ghash_update_sw
+#define internal_aes_gcm_update_payload_blocks \
+	internal_aes_gcm_update_payload_blocks_sw
+#endif
+
 void internal_aes_gcm_set_key(struct internal_aes_gcm_state *state,
 			      const struct internal_aes_gcm_key *ek)
 {
@@ -43,88 +54,115 @@ void internal_aes_gcm_ghash_update(struct internal_aes_gcm_state *state,
 	if (head)
 		ghash_update_block(state, head);
 
-	if (data)
-		for (n = 0; n < num_blocks; n++)
-			ghash_update_block(state,
-					   (const uint8_t *)data +
-					   n * TEE_AES_BLOCK_SIZE);
+	if (!data)
+		return;
+
+#ifdef CFG_AES_GCM_TABLE_BASED
+	for (; n + 1 < num_blocks; n += 2) {
+		const uint8_t *d = (const uint8_t *)data +
+				   n * TEE_AES_BLOCK_SIZE;
+		void *y = state->hash_state;
+
+		internal_aes_gcm_xor_block(y, d);
+		internal_aes_gcm_ghash_mult2_tbl(&state->ghash_key, y,
+						 d + TEE_AES_BLOCK_SIZE, y);
+	}
+#endif
+	for (; n < num_blocks; n++)
+		ghash_update_block(state,
+				   (const uint8_t *)data + n * TEE_AES_BLOCK_SIZE);
 }
 
-static void encrypt_block(struct internal_aes_gcm_state *state,
-			  const struct internal_aes_gcm_key *enc_key,
-			  const uint64_t src[2], uint64_t dst[2])
-{
-	void *buf_cryp = state->buf_cryp;
+/*
+ * Payload is processed in batches of up to GCM_SW_BATCH_BLOCKS blocks:
+ * the counter blocks of a batch are encrypted with one call to
+ * crypto_aes_enc_blocks(), which loads the expanded key only once, and
+ * the resulting ciphertext is hashed in one call to
+ * internal_aes_gcm_ghash_update().
+ *
+ * Each block of @src is read once into a local copy and the ciphertext is
+ * hashed from that local copy, so what's authenticated always matches the
+ * data processed even if @src or @dst is shared with normal world and
+ * modified while we're processing it.
+ */
+#define GCM_SW_BATCH_BLOCKS	4
 
-	internal_aes_gcm_xor_block(buf_cryp, src);
-	internal_aes_gcm_ghash_update(state, buf_cryp, NULL, 0);
-	memcpy(dst, buf_cryp, sizeof(state->buf_cryp));
+static void gen_ctr_blocks(struct internal_aes_gcm_state *state,
+			   uint64_t blocks[][2], size_t num_blocks)
+{
+	size_t n = 0;
 
-	crypto_aes_enc_block(enc_key->data, sizeof(enc_key->data),
-			     enc_key->rounds, state->ctr, state->buf_cryp);
-	internal_aes_gcm_inc_ctr(state);
+	for (n = 0; n < num_blocks; n++) {
+		memcpy(blocks[n], state->ctr, sizeof(state->ctr));
+		internal_aes_gcm_inc_ctr(state);
+	}
 }
 
+/*
+ * In the encrypt case state->buf_cryp holds the key stream of the first
+ * block and state->ctr the counter of the following block, see
+ * __gcm_init().
+ */
 static void encrypt_pl(struct internal_aes_gcm_state *state,
 		       const struct internal_aes_gcm_key *ek,
 		       const uint8_t *src, size_t num_blocks, uint8_t *dst)
 {
+	uint64_t ks[GCM_SW_BATCH_BLOCKS + 1][2] = { };
+	uint64_t buf[GCM_SW_BATCH_BLOCKS][2] = { };
+	size_t bn = 0;
 	size_t n = 0;
 
-	if (IS_ALIGNED_WITH_TYPE(src, uint64_t)) {
-		for (n = 0; n < num_blocks; n++) {
-			const void *s = src + n * TEE_AES_BLOCK_SIZE;
-			void *d = dst + n * TEE_AES_BLOCK_SIZE;
-
-			encrypt_block(state, ek, s, d);
-		}
-	} else {
-		for (n = 0; n < num_blocks; n++) {
-			uint64_t tmp[2] = { 0 };
-			void *d = dst + n * TEE_AES_BLOCK_SIZE;
-
-			memcpy(tmp, src + n * TEE_AES_BLOCK_SIZE, sizeof(tmp));
-			encrypt_block(state, ek, tmp, d);
-		}
-	}
-}
+	while (num_blocks) {
+		bn = MIN(num_blocks, (size_t)GCM_SW_BATCH_BLOCKS);
 
-static void decrypt_block(struct internal_aes_gcm_state *state,
-			  const struct internal_aes_gcm_key *enc_key,
-			  const uint64_t src[2], uint64_t dst[2])
-{
-	void *buf_cryp = state->buf_cryp;
+		memcpy(ks[0], state->buf_cryp, sizeof(ks[0]));
+		gen_ctr_blocks(state, ks + 1, bn);
+		crypto_aes_enc_blocks(ek->data, sizeof(ek->data), ek->rounds,
+				      ks + 1, ks + 1, bn);
+
+		memcpy(buf, src, bn * TEE_AES_BLOCK_SIZE);
+		for (n = 0; n < bn; n++)
+			internal_aes_gcm_xor_block(buf[n], ks[n]);
+		internal_aes_gcm_ghash_update(state, NULL, buf, bn);
+		memcpy(dst, buf, bn * TEE_AES_BLOCK_SIZE);
 
-	crypto_aes_enc_block(enc_key->data, sizeof(enc_key->data),
-			     enc_key->rounds, state->ctr, buf_cryp);
-	internal_aes_gcm_inc_ctr(state);
+		memcpy(state->buf_cryp, ks[bn], sizeof(state->buf_cryp));
 
-	internal_aes_gcm_xor_block(buf_cryp, src);
-	internal_aes_gcm_ghash_update(state, src, NULL, 0);
-	memcpy(dst, buf_cryp, sizeof(state->buf_cryp));
+		src += bn * TEE_AES_BLOCK_SIZE;
+		dst += bn * TEE_AES_BLOCK_SIZE;
+		num_blocks -= bn;
+	}
 }
 
+/*
+ * In the decrypt case state->ctr holds the counter of the first block
+ * and the key stream is generated as needed.
+ */
 static void decrypt_pl(struct internal_aes_gcm_state *state,
 		       const struct internal_aes_gcm_key *ek,
 		       const uint8_t *src, size_t num_blocks, uint8_t *dst)
 {
+	uint64_t ks[GCM_SW_BATCH_BLOCKS][2] = { };
+	uint64_t buf[GCM_SW_BATCH_BLOCKS][2] = { };
+	size_t bn = 0;
 	size_t n = 0;
 
-	if (IS_ALIGNED_WITH_TYPE(src, uint64_t)) {
-		for (n = 0; n < num_blocks; n++) {
-			const void *s = src + n * TEE_AES_BLOCK_SIZE;
-			void *d = dst + n * TEE_AES_BLOCK_SIZE;
-
-			decrypt_block(state, ek, s, d);
-		}
-	} else {
-		for (n = 0; n < num_blocks; n++) {
-			uint64_t tmp[2] = { 0 };
-			void *d = dst + n * TEE_AES_BLOCK_SIZE;
-
-			memcpy(tmp, src + n * TEE_AES_BLOCK_SIZE, sizeof(tmp));
-			decrypt_block(state, ek, tmp, d);
-		}
+	while (num_blocks) {
+		bn = MIN(num_blocks, (size_t)GCM_SW_BATCH_BLOCKS);
+
+		gen_ctr_blocks(state, ks, bn);
+		crypto_aes_enc_blocks(ek->data, sizeof(ek->data), ek->rounds,
+				      ks, ks, bn);
+
+		memcpy(buf, src, bn * TEE_AES_BLOCK_SIZE);
+		internal_aes_gcm_ghash_update(state, NULL, buf, bn);
+		for (n = 0; n < bn; n++)
+			internal_aes_gcm_xor_block(buf[n], ks[n]);
+		memcpy(dst, buf, bn * TEE_AES_BLOCK_SIZE);
+
+		src += bn * TEE_AES_BLOCK_SIZE;
+		dst += bn * TEE_AES_BLOCK_SIZE;
+		num_blocks -= bn;
 	}
 }
 
@@ -66,20 +66,31 @@ static void ghash_update_lengths(struct internal_aes_gcm_state *state,
 	internal_aes_gcm_ghash_update(state, (uint8_t *)len_fields, NULL, 0);
 }
 
-static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
-			     const struct internal_aes_gcm_key *ek,
-			     TEE_OperationMode mode, const void *nonce,
-			     size_t nonce_len, size_t tag_len)
+/*
+ * Starts a new message, state->ghash_key must already be set for the key
+ * in ek
+ */
+static TEE_Result __gcm_start(struct internal_aes_gcm_state *state,
+			      const struct internal_aes_gcm_key *ek,
+			      TEE_OperationMode mode, const void *nonce,
+			      size_t nonce_len, size_t tag_len)
 {
+	size_t offs = offsetof(struct internal_aes_gcm_state, hash_state);
+
 	COMPILE_TIME_ASSERT(sizeof(state->ctr) == TEE_AES_BLOCK_SIZE);
+	COMPILE_TIME_ASSERT(offsetof(struct internal_aes_gcm_state,
+				     ghash_key) <
+			    offsetof(struct internal_aes_gcm_state,
+				     hash_state));
 
 	if (tag_len > sizeof(state->buf_tag))
 		return TEE_ERROR_BAD_PARAMETERS;
 
-	memset(state, 0, sizeof(*state));
+	/* Everything but the GHASH key */
+	memset(state->ctr, 0, sizeof(state->ctr));
+	memset((uint8_t *)state + offs, 0, sizeof(*state) - offs);
 
 	state->tag_len = tag_len;
-	internal_aes_gcm_set_key(state, ek);
 
 	if (nonce_len == (96 / 8)) {
 		memcpy(state->ctr, nonce, nonce_len);
@@ -121,6 +132,17 @@ static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
 	return TEE_SUCCESS;
 }
 
+static TEE_Result __gcm_init(struct internal_aes_gcm_state *state,
+			     const struct internal_aes_gcm_key *ek,
+			     TEE_OperationMode mode, const void *nonce,
+			     size_t nonce_len, size_t tag_len)
+{
+	memset(state, 0, sizeof(*state));
+	internal_aes_gcm_set_key(state, ek);
+
+	return __gcm_start(state, ek, mode, nonce, nonce_len, tag_len);
+}
+
 TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 				 TEE_OperationMode mode, const void *key,
 				 size_t key_len, const void *nonce,
@@ -137,6 +159,14 @@ TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 	return __gcm_init(&ctx->state, ek, mode, nonce, nonce_len, tag_len);
 }
 
+TEE_Result internal_aes_gcm_reinit(struct internal_aes_gcm_ctx *ctx,
+				   TEE_OperationMode mode, const void *nonce,
+				   size_t nonce_len, size_t tag_len)
+{
+	return __gcm_start(&ctx->state, &ctx->key, mode, nonce, nonce_len,
+			   tag_len);
+}
+
 static TEE_Result __gcm_update_aad(struct internal_aes_gcm_state *state,
 				   const void *data, size_t len)
 {
@@ -468,6 +498,16 @@ static TEE_Result aes_gcm_init(struct crypto_authenc_ctx *aec,
 				     key_len, nonce, nonce_len, tag_len);
 }
 
+static TEE_Result aes_gcm_reinit(struct crypto_authenc_ctx *aec,
+				 TEE_OperationMode mode,
+				 const uint8_t *nonce, size_t nonce_len,
+				 size_t tag_len, size_t aad_len __unused,
+				 size_t payload_len __unused)
+{
+	return internal_aes_gcm_reinit(&to_aes_gcm_ctx(aec)->ctx, mode, nonce,
+				       nonce_len, tag_len);
+}
+
 static TEE_Result aes_gcm_update_aad(struct crypto_authenc_ctx *aec,
 				     const uint8_t *data, size_t len)
 {
@@ -507,6 +547,7 @@ static void aes_gcm_final(struct crypto_authenc_ctx *aec __unused)
 
 static const struct crypto_authenc_ops aes_gcm_ops = {
 	.init = aes_gcm_init,
+	.reinit = aes_gcm_reinit,
 	.update_aad = aes_gcm_update_aad,
 	.update_payload = aes_gcm_update_payload,
 	.enc_final = aes_gcm_enc_final,
@@ -14,6 +14,39 @@
 #include <string.h>
 #include <utee_defines.h>
 
+TEE_Result crypto_hash_alloc_sw_ctx(struct crypto_hash_ctx **ctx, uint32_t algo)
+{
+	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
+
+	switch (algo) {
+	case TEE_ALG_MD5:
+		res = crypto_md5_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SHA1:
+		res = crypto_sha1_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SHA224:
+		res = crypto_sha224_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SHA256:
+		res = crypto_sha256_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SHA384:
+		res = crypto_sha384_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SHA512:
+		res = crypto_sha512_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SM3:
+		res = crypto_sm3_alloc_ctx(ctx);
+		break;
+	default:
+		break;
+	}
+
+	return res;
+}
+
 TEE_Result crypto_hash_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
@@ -25,33 +58,8 @@ TEE_Result crypto_hash_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_hash_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-		case TEE_ALG_MD5:
-			res = crypto_md5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA1:
-			res = crypto_sha1_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA224:
-			res = crypto_sha224_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA256:
-			res = crypto_sha256_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA384:
-			res = crypto_sha384_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SHA512:
-			res = crypto_sha512_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM3:
-			res = crypto_sm3_alloc_ctx(&c);
-			break;
-		default:
-			break;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_hash_alloc_sw_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -94,6 +102,55 @@ TEE_Result crypto_hash_final(void *ctx, uint8_t *digest, size_t len)
 	return hash_ops(ctx)->final(ctx, digest, len);
 }
 
+TEE_Result crypto_cipher_alloc_sw_ctx(struct crypto_cipher_ctx **ctx,
+				      uint32_t algo)
+{
+	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
+
+	switch (algo) {
+	case TEE_ALG_AES_ECB_NOPAD:
+		res = crypto_aes_ecb_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CBC_NOPAD:
+		res = crypto_aes_cbc_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CTR:
+		res = crypto_aes_ctr_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CTS:
+		res = crypto_aes_cts_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_XTS:
+		res = crypto_aes_xts_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES_ECB_NOPAD:
+		res = crypto_des_ecb_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES3_ECB_NOPAD:
+		res = crypto_des3_ecb_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES_CBC_NOPAD:
+		res = crypto_des_cbc_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES3_CBC_NOPAD:
+		res = crypto_des3_cbc_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SM4_ECB_NOPAD:
+		res = crypto_sm4_ecb_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SM4_CBC_NOPAD:
+		res = crypto_sm4_cbc_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_SM4_CTR:
+		res = crypto_sm4_ctr_alloc_ctx(ctx);
+		break;
+	default:
+		return TEE_ERROR_NOT_IMPLEMENTED;
+	}
+
+	return res;
+}
+
 TEE_Result crypto_cipher_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
@@ -105,48 +162,8 @@ TEE_Result crypto_cipher_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_cipher_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-		case TEE_ALG_AES_ECB_NOPAD:
-			res = crypto_aes_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CBC_NOPAD:
-			res = crypto_aes_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CTR:
-			res = crypto_aes_ctr_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CTS:
-			res = crypto_aes_cts_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_XTS:
-			res = crypto_aes_xts_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_ECB_NOPAD:
-			res = crypto_des_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_ECB_NOPAD:
-			res = crypto_des3_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_CBC_NOPAD:
-			res = crypto_des_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_CBC_NOPAD:
-			res = crypto_des3_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_ECB_NOPAD:
-			res = crypto_sm4_ecb_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_CBC_NOPAD:
-			res = crypto_sm4_cbc_alloc_ctx(&c);
-			break;
-		case TEE_ALG_SM4_CTR:
-			res = crypto_sm4_ctr_alloc_ctx(&c);
-			break;
-		default:
-			return TEE_ERROR_NOT_IMPLEMENTED;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_cipher_alloc_sw_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -186,6 +203,18 @@ TEE_Result crypto_cipher_init(void *ctx, TEE_OperationMode mode,
 				     iv, iv_len);
 }
 
+TEE_Result crypto_cipher_reinit(void *ctx, TEE_OperationMode mode,
+				const uint8_t *iv, size_t iv_len)
+{
+	if (mode != TEE_MODE_DECRYPT && mode != TEE_MODE_ENCRYPT)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!cipher_ops(ctx)->reinit)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	return cipher_ops(ctx)->reinit(ctx, mode, iv, iv_len);
+}
+
 TEE_Result crypto_cipher_update(void *ctx, TEE_OperationMode mode __unused,
 				bool last_block, const uint8_t *data,
 				size_t len, uint8_t *dst)
@@ -222,6 +251,63 @@ TEE_Result crypto_cipher_get_block_size(uint32_t algo, size_t *size)
 	}
 }
 
+TEE_Result crypto_mac_alloc_sw_ctx(struct crypto_mac_ctx **ctx, uint32_t algo)
+{
+	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
+
+	switch (algo) {
+	case TEE_ALG_HMAC_MD5:
+		res = crypto_hmac_md5_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SHA1:
+		res = crypto_hmac_sha1_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SHA224:
+		res = crypto_hmac_sha224_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SHA256:
+		res = crypto_hmac_sha256_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SHA384:
+		res = crypto_hmac_sha384_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SHA512:
+		res = crypto_hmac_sha512_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_HMAC_SM3:
+		res = crypto_hmac_sm3_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CBC_MAC_NOPAD:
+		res = crypto_aes_cbc_mac_nopad_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CBC_MAC_PKCS5:
+		res = crypto_aes_cbc_mac_pkcs5_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES_CBC_MAC_NOPAD:
+		res = crypto_des_cbc_mac_nopad_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES_CBC_MAC_PKCS5:
+		res = crypto_des_cbc_mac_pkcs5_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES3_CBC_MAC_NOPAD:
+		res = crypto_des3_cbc_mac_nopad_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES3_CBC_MAC_PKCS5:
+		res = crypto_des3_cbc_mac_pkcs5_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_DES3_CMAC:
+		res = crypto_des3_cmac_alloc_ctx(ctx);
+		break;
+	case TEE_ALG_AES_CMAC:
+		res = crypto_aes_cmac_alloc_ctx(ctx);
+		break;
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+
+	return res;
+}
+
 TEE_Result crypto_mac_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_SUCCESS;
@@ -233,57 +319,8 @@ TEE_Result crypto_mac_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_mac_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-		case TEE_ALG_HMAC_MD5:
-			res = crypto_hmac_md5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SHA1:
-			res = crypto_hmac_sha1_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SHA224:
-			res = crypto_hmac_sha224_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SHA256:
-			res = crypto_hmac_sha256_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SHA384:
-			res = crypto_hmac_sha384_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SHA512:
-			res = crypto_hmac_sha512_alloc_ctx(&c);
-			break;
-		case TEE_ALG_HMAC_SM3:
-			res = crypto_hmac_sm3_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CBC_MAC_NOPAD:
-			res = crypto_aes_cbc_mac_nopad_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CBC_MAC_PKCS5:
-			res = crypto_aes_cbc_mac_pkcs5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_CBC_MAC_NOPAD:
-			res = crypto_des_cbc_mac_nopad_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES_CBC_MAC_PKCS5:
-			res = crypto_des_cbc_mac_pkcs5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_CBC_MAC_NOPAD:
-			res = crypto_des3_cbc_mac_nopad_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_CBC_MAC_PKCS5:
-			res = crypto_des3_cbc_mac_pkcs5_alloc_ctx(&c);
-			break;
-		case TEE_ALG_DES3_CMAC:
-			res = crypto_des3_cmac_alloc_ctx(&c);
-			break;
-		case TEE_ALG_AES_CMAC:
-			res = crypto_aes_cmac_alloc_ctx(&c);
-			break;
-		default:
-			return TEE_ERROR_NOT_SUPPORTED;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_mac_alloc_sw_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -329,6 +366,34 @@ TEE_Result crypto_mac_final(void *ctx, uint8_t *digest, size_t digest_len)
 	return mac_ops(ctx)->final(ctx, digest, digest_len);
 }
 
+TEE_Result crypto_authenc_alloc_sw_ctx(struct crypto_authenc_ctx **ctx,
+				       uint32_t algo)
+{
+	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
+
+	switch (algo) {
+#if defined(CFG_CRYPTO_CCM)
+	case TEE_ALG_AES_CCM:
+		res = crypto_aes_ccm_alloc_ctx(ctx);
+		break;
+#endif
+#if defined(CFG_CRYPTO_GCM)
+	case TEE_ALG_AES_GCM:
+		res = crypto_aes_gcm_alloc_ctx(ctx);
+		break;
+#endif
+#if defined(CFG_CRYPTO_CHACHA20_POLY1305)
+	case TEE_ALG_CHACHA20_POLY1305:
+		res = crypto_chacha20_poly1305_alloc_ctx(ctx);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	return res;
+}
+
 TEE_Result crypto_authenc_alloc_ctx(void **ctx, uint32_t algo)
 {
 	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
@@ -340,22 +405,8 @@ TEE_Result crypto_authenc_alloc_ctx(void **ctx, uint32_t algo)
 	 */
 	res = drvcrypt_authenc_alloc_ctx(&c, algo);
 
-	if (res == TEE_ERROR_NOT_IMPLEMENTED) {
-		switch (algo) {
-#if defined(CFG_CRYPTO_CCM)
-		case TEE_ALG_AES_CCM:
-			res = crypto_aes_ccm_alloc_ctx(&c);
-			break;
-#endif
-#if defined(CFG_CRYPTO_GCM)
-		case TEE_ALG_AES_GCM:
-			res = crypto_aes_gcm_alloc_ctx(&c);
-			break;
-#endif
-		default:
-			break;
-		}
-	}
+	if (res == TEE_ERROR_NOT_IMPLEMENTED)
+		res = crypto_authenc_alloc_sw_ctx(&c, algo);
 
 	if (!res)
 		*ctx = c;
@@ -382,6 +433,18 @@ TEE_Result crypto_authenc_init(void *ctx, TEE_OperationMode mode,
 				 tag_len, aad_len, payload_len);
 }
 
+TEE_Result crypto_authenc_reinit(void *ctx, TEE_OperationMode mode,
+				 const uint8_t *nonce, size_t nonce_len,
+				 size_t tag_len, size_t aad_len,
+				 size_t payload_len)
+{
+	if (!ae_ops(ctx)->reinit)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	return ae_ops(ctx)->reinit(ctx, mode, nonce, nonce_len, tag_len,
+				   aad_len, payload_len);
+}
+
 TEE_Result crypto_authenc_update_aad(void *ctx, TEE_OperationMode mode __unused,
 				     const uint8_t *data, size_t len)
 {
@@ -513,6 +576,14 @@ int32_t crypto_bignum_compare(struct bignum *a __unused,
 	bignum_cant_happen();
 	return -1;
 }
+
+void crypto_bignum_arena_begin(size_t size_bits __unused)
+{
+}
+
+void crypto_bignum_arena_end(void)
+{
+}
 #endif
 
 #if !defined(CFG_CRYPTO_RSA)
@@ -608,6 +679,12 @@ TEE_Result crypto_acipher_rsassa_verify(uint32_t algo __unused,
 }
 #endif /*!CFG_CRYPTO_RSA*/
 
+#if !defined(_CFG_CORE_LTC_RSA_KEY_CACHE)
+void crypto_acipher_clear_rsa_keypair_cache(struct rsa_keypair *s __unused)
+{
+}
+#endif
+
 #if !defined(CFG_CRYPTO_DSA)
 TEE_Result crypto_acipher_alloc_dsa_keypair(struct dsa_keypair *s __unused,
 					    size_t key_size_bits __unused)
@@ -800,6 +877,79 @@ TEE_Result crypto_acipher_sm2_kep_derive(struct ecc_keypair *my_key __unused,
 }
 #endif
 
+#if !defined(CFG_CRYPTO_ECC_FIXED_BASE)
+bool crypto_acipher_ecc_precomp_enable(bool enable __unused)
+{
+	return false;
+}
+#endif
+
+#if !defined(CFG_CRYPTO_X25519)
+TEE_Result crypto_acipher_alloc_x25519_keypair(struct x25519_keypair *s
+								__unused,
+					       size_t key_size_bits __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result crypto_acipher_gen_x25519_key(struct x25519_keypair *key __unused,
+					 size_t key_size __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result crypto_acipher_x25519_shared_secret(struct x25519_keypair
+					       *private_key __unused,
+					       const void *public_key __unused,
+					       void *secret __unused,
+					       unsigned long
+					       *secret_len __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+#endif /*!CFG_CRYPTO_X25519*/
+
+#if !defined(CFG_CRYPTO_ED25519)
+TEE_Result crypto_acipher_alloc_ed25519_keypair(struct ed25519_keypair *s
+								__unused,
+						size_t key_size_bits __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result
+crypto_acipher_alloc_ed25519_public_key(struct ed25519_public_key *s __unused,
+					size_t key_size_bits __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result crypto_acipher_gen_ed25519_key(struct ed25519_keypair *key __unused,
+					  size_t key_size __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result crypto_acipher_ed25519_sign(struct ed25519_keypair *key __unused,
+				       const uint8_t *msg __unused,
+				       size_t msg_len __unused,
+				       uint8_t *sig __unused,
+				       size_t *sig_len __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+
+TEE_Result crypto_acipher_ed25519_verify(struct ed25519_public_key *key
+								__unused,
+					 const uint8_t *msg __unused,
+					 size_t msg_len __unused,
+					 const uint8_t *sig __unused,
+					 size_t sig_len __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
+#endif /*!CFG_CRYPTO_ED25519*/
+
 __weak void crypto_storage_obj_del(uint8_t *data __unused, size_t len __unused)
 {
 }
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tee_api_types.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#define HMAC_IPAD		0x36
+#define HMAC_OPAD		0x5c
+#define MAX_HASH_BLOCK_SIZE	128
+
+static size_t hash_block_size(uint32_t hash_algo)
+{
+	switch (hash_algo) {
+	case TEE_ALG_SHA384:
+	case TEE_ALG_SHA512:
+		return 128;
+	default:
+		return 64;
+	}
+}
+
+static TEE_Result absorb_pad(void *ctx, uint8_t *k, size_t block_size,
+			     uint8_t pad)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	for (n = 0; n < block_size; n++)
+		k[n] ^= pad;
+
+	res = crypto_hash_init(ctx);
+	if (!res)
+		res = crypto_hash_update(ctx, k, block_size);
+
+	for (n = 0; n < block_size; n++)
+		k[n] ^= pad;
+
+	return res;
+}
+
+TEE_Result crypto_hmac_pads_init(struct crypto_hmac_pads *pads,
+				 uint32_t hash_algo, const uint8_t *key,
+				 size_t key_len)
+{
+	uint8_t k[MAX_HASH_BLOCK_SIZE] = { };
+	size_t block_size = hash_block_size(hash_algo);
+	TEE_Result res = TEE_SUCCESS;
+
+	memset(pads, 0, sizeof(*pads));
+	pads->digest_len = TEE_ALG_GET_DIGEST_SIZE(hash_algo);
+	if (!pads->digest_len)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	res = crypto_hash_alloc_ctx(&pads->inner, hash_algo);
+	if (res)
+		goto err;
+	res = crypto_hash_alloc_ctx(&pads->outer, hash_algo);
+	if (res)
+		goto err;
+	res = crypto_hash_alloc_ctx(&pads->ctx, hash_algo);
+	if (res)
+		goto err;
+
+	/* Keys longer than a block are replaced by their digest */
+	if (key_len > block_size) {
+		res = crypto_hash_init(pads->ctx);
+		if (!res)
+			res = crypto_hash_update(pads->ctx, key, key_len);
+		if (!res)
+			res = crypto_hash_final(pads->ctx, k,
+						pads->digest_len);
+		if (res)
+			goto err;
+	} else {
+		memcpy(k, key, key_len);
+	}
+
+	res = absorb_pad(pads->inner, k, block_size, HMAC_IPAD);
+	if (!res)
+		res = absorb_pad(pads->outer, k, block_size, HMAC_OPAD);
+	memzero_explicit(k, sizeof(k));
+	if (res)
+		goto err;
+
+	return TEE_SUCCESS;
+err:
+	crypto_hmac_pads_free(pads);
+	return res;
+}
+
+void crypto_hmac_pads_start(struct crypto_hmac_pads *pads)
+{
+	crypto_hash_copy_state(pads->ctx, pads->inner);
+}
+
+TEE_Result crypto_hmac_pads_update(struct crypto_hmac_pads *pads,
+				   const uint8_t *data, size_t len)
+{
+	return crypto_hash_update(pads->ctx, data, len);
+}
+
+TEE_Result crypto_hmac_pads_final(struct crypto_hmac_pads *pads,
+				  uint8_t *digest)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	res = crypto_hash_final(pads->ctx, digest, pads->digest_len);
+	if (res)
+		return res;
+
+	crypto_hash_copy_state(pads->ctx, pads->outer);
+	res = crypto_hash_update(pads->ctx, digest, pads->digest_len);
+	if (res)
+		return res;
+
+	return crypto_hash_final(pads->ctx, digest, pads->digest_len);
+}
+
+void crypto_hmac_pads_free(struct crypto_hmac_pads *pads)
+{
+	crypto_hash_free_ctx(pads->inner);
+	crypto_hash_free_ctx(pads->outer);
+	crypto_hash_free_ctx(pads->ctx);
+	memset(pads, 0, sizeof(*pads));
+}
@@ -9,11 +9,14 @@
 
 #include <assert.h>
 #include <crypto/crypto.h>
+#include <kernel/misc.h>
 #include <kernel/mutex.h>
 #include <kernel/refcount.h>
 #include <kernel/spinlock.h>
 #include <kernel/tee_time.h>
+#include <kernel/thread.h>
 #include <string.h>
+#include <string_ext.h>
 #include <types_ext.h>
 #include <utee_defines.h>
 #include <util.h>
@@ -26,6 +29,8 @@
 #define MIN_POOL_SIZE		64
 #define MAX_EVENT_DATA_LEN	32U
 #define RING_BUF_DATA_SIZE	4U
+#define PCPU_BUF_SIZE		256U
+#define PCPU_MAX_READ		(PCPU_BUF_SIZE / 4)
 
 /*
  * struct fortuna_state - state of the Fortuna PRNG
@@ -71,6 +76,17 @@ static struct {
 
 unsigned int ring_buffer_spin_lock;
 
+/*
+ * Small requests are served from per-CPU buffers of generator output to
+ * avoid taking state_mu each time. Each refill is a separate request to
+ * the generator so it's rekeyed once per refill. Bytes are cleared from
+ * the buffer as soon as they're handed out.
+ */
+static struct pcpu_buf {
+	uint8_t data[PCPU_BUF_SIZE];
+	size_t avail;
+} pcpu_buf[CFG_TEE_CORE_NB_CORE];
+
 static void inc_counter(uint64_t counter[2])
 {
 	counter[0]++;
@@ -317,24 +333,22 @@ static TEE_Result generate_blocks(void *block, size_t nblocks)
 	uint8_t *b = block;
 	size_t n;
 
+	/*
+	 * Write all the counter values first and encrypt them in place
+	 * with a single call to get the most out of the cipher
+	 * implementation. The counter is increased before encrypting, we
+	 * must never re-use the counter with the same key, even after an
+	 * error.
+	 */
 	for (n = 0; n < nblocks; n++) {
-		TEE_Result res = crypto_cipher_update(state.ctx,
-						      TEE_MODE_ENCRYPT, false,
-						      (void *)state.counter,
-						      BLOCK_SIZE,
-						      b + n * BLOCK_SIZE);
-
-		/*
-		 * Make sure to increase the counter before returning an
-		 * eventual errors, we must never re-use the counter with
-		 * the same key.
-		 */
+		memcpy(b + n * BLOCK_SIZE, state.counter, BLOCK_SIZE);
 		inc_counter(state.counter);
-		if (res)
-			return res;
 	}
 
-	return TEE_SUCCESS;
+	if (!nblocks)
+		return TEE_SUCCESS;
+	return crypto_cipher_update(state.ctx, TEE_MODE_ENCRYPT, false, b,
+				    nblocks * BLOCK_SIZE, b);
 }
 
 /* GenerateRandomData */
@@ -511,10 +525,65 @@ out:
 	return res;
 }
 
+/* Moves the last @blen bytes of @b to @buf */
+static void pcpu_buf_take(struct pcpu_buf *b, void *buf, size_t blen)
+{
+	uint8_t *d = b->data + b->avail - blen;
+
+	memcpy(buf, d, blen);
+	memzero_explicit(d, blen);
+	b->avail -= blen;
+}
+
+static TEE_Result pcpu_read(void *buf, size_t blen)
+{
+	uint8_t data[PCPU_BUF_SIZE] = { };
+	uint32_t exceptions = 0;
+	struct pcpu_buf *b = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	/* Foreign interrupts are masked to stay on the same CPU */
+	exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+	b = pcpu_buf + get_core_pos();
+	if (b->avail >= blen) {
+		pcpu_buf_take(b, buf, blen);
+		thread_unmask_exceptions(exceptions);
+		return TEE_SUCCESS;
+	}
+	thread_unmask_exceptions(exceptions);
+
+	res = fortuna_read(data, sizeof(data));
+	if (res)
+		return res;
+
+	memcpy(buf, data, blen);
+
+	/*
+	 * We may have been moved to another CPU or the buffer may have
+	 * been refilled in the meantime. Keep the one with the most bytes
+	 * left.
+	 */
+	exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+	b = pcpu_buf + get_core_pos();
+	if (b->avail < sizeof(data) - blen) {
+		memzero_explicit(b->data, b->avail);
+		memcpy(b->data, data + blen, sizeof(data) - blen);
+		b->avail = sizeof(data) - blen;
+	}
+	thread_unmask_exceptions(exceptions);
+
+	memzero_explicit(data, sizeof(data));
+
+	return TEE_SUCCESS;
+}
+
 TEE_Result crypto_rng_read(void *buf, size_t blen)
 {
 	size_t offs = 0;
 
+	if (blen && blen <= PCPU_MAX_READ)
+		return pcpu_read(buf, blen);
+
 	while (true) {
 		TEE_Result res;
 		size_t n;
@@ -10,6 +10,7 @@
  * 2011-10-26
  */
 
+#include <crypto/crypto_accel.h>
 #include <string.h>
 #include <string_ext.h>
 
@@ -154,6 +155,20 @@ static void sm3_process(struct sm3_context *ctx, const uint8_t data[64])
 	ctx->state[7] ^= H;
 }
 
+static void sm3_process_blocks(struct sm3_context *ctx, const uint8_t *data,
+			       size_t block_count)
+{
+#ifdef CFG_CORE_CRYPTO_SM3_ACCEL
+	if (!crypto_accel_sm3_compress(ctx->state, data, block_count))
+		return;
+#endif
+
+	while (block_count--) {
+		sm3_process(ctx, data);
+		data += 64;
+	}
+}
+
 void sm3_update(struct sm3_context *ctx, const uint8_t *input, size_t ilen)
 {
 	size_t fill;
@@ -172,16 +187,18 @@ void sm3_update(struct sm3_context *ctx, const uint8_t *input, size_t ilen)
 
 	if (left && ilen >= fill) {
 		memcpy(ctx->buffer + left, input, fill);
-		sm3_process(ctx, ctx->buffer);
+		sm3_process_blocks(ctx, ctx->buffer, 1);
 		input += fill;
 		ilen -= fill;
 		left = 0;
 	}
 
-	while (ilen >= 64) {
-		sm3_process(ctx, input);
-		input += 64;
-		ilen -= 64;
+	if (ilen >= 64) {
+		size_t block_count = ilen / 64;
+
+		sm3_process_blocks(ctx, input, block_count);
+		input += block_count * 64;
+		ilen -= block_count * 64;
 	}
 
 	if (ilen > 0)
@@ -14,6 +14,7 @@
 
 #include "sm4.h"
 #include <assert.h>
+#include <crypto/crypto_accel.h>
 #include <string.h>
 
 #define GET_UINT32_BE(n, b, i)				\
@@ -205,6 +206,11 @@ void sm4_crypt_ecb(struct sm4_context *ctx, size_t length, const uint8_t *input,
 {
 	assert(!(length % 16));
 
+#ifdef CFG_CORE_CRYPTO_SM4_ACCEL
+	if (!crypto_accel_sm4_ecb(output, input, ctx->sk, length / 16))
+		return;
+#endif
+
 	while (length > 0) {
 		sm4_one_round(ctx->sk, input, output);
 		input  += 16;
@@ -233,6 +239,11 @@ void sm4_crypt_cbc(struct sm4_context *ctx, size_t length, uint8_t iv[16],
 		}
 	} else {
 		/* SM4_DECRYPT */
+#ifdef CFG_CORE_CRYPTO_SM4_ACCEL
+		if (!crypto_accel_sm4_cbc_dec(output, input, ctx->sk,
+					      length / 16, iv))
+			return;
+#endif
 		while (length > 0) {
 			memcpy(temp, input, 16);
 			sm4_one_round(ctx->sk, input, output);
@@ -254,6 +265,12 @@ void sm4_crypt_ctr(struct sm4_context *ctx, size_t length, uint8_t ctr[16],
 
 	assert(!(length % 16));
 
+#ifdef CFG_CORE_CRYPTO_SM4_ACCEL
+	if (!crypto_accel_sm4_ctr_be_enc(output, input, ctx->sk, length / 16,
+					 ctr))
+		return;
+#endif
+
 	while (length > 0) {
 		memcpy(temp, ctr, 16);
 		sm4_one_round(ctx->sk, ctr, ctr);
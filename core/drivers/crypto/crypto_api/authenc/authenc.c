@@ -9,6 +9,7 @@
 #include <crypto/crypto_impl.h>
 #include <drvcrypt.h>
 #include <drvcrypt_authenc.h>
+#include <drvcrypt_balance.h>
 #include <kernel/panic.h>
 #include <malloc.h>
 #include <utee_defines.h>
@@ -325,6 +326,7 @@ TEE_Result drvcrypt_authenc_alloc_ctx(struct crypto_authenc_ctx **ctx,
 	} else {
 		authenc->authenc_ctx.ops = &authenc_ops;
 		*ctx = &authenc->authenc_ctx;
+		drvcrypt_balance_authenc(ctx, algo);
 	}
 
 	CRYPTO_TRACE("authenc alloc_ctx ret 0x%" PRIx32, ret);
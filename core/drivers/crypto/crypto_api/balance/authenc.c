@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   Authenticated Encryption load balancing between the HW driver
+ *         and the software implementation.
+ */
+#include <assert.h>
+#include <malloc.h>
+#include <utee_defines.h>
+
+#include "local.h"
+
+struct balance_authenc {
+	struct crypto_authenc_ctx authenc_ctx; /* Crypto Authenc API context */
+	struct crypto_authenc_ctx *hw;	       /* HW driver context */
+	struct crypto_authenc_ctx *sw;	       /* Software implementation */
+	struct balance_state st;	       /* Backend in use */
+};
+
+static const struct crypto_authenc_ops balance_authenc_ops;
+
+static struct balance_authenc *
+to_balance_authenc(struct crypto_authenc_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &balance_authenc_ops);
+
+	return container_of(ctx, struct balance_authenc, authenc_ctx);
+}
+
+static struct crypto_authenc_ctx *cur_ctx(struct balance_authenc *a)
+{
+	return a->st.hw ? a->hw : a->sw;
+}
+
+static TEE_Result do_authenc_init(struct crypto_authenc_ctx *ctx,
+				  TEE_OperationMode mode, const uint8_t *key,
+				  size_t key_len, const uint8_t *nonce,
+				  size_t nonce_len, size_t tag_len,
+				  size_t aad_len, size_t payload_len)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+	size_t len = SIZE_MAX;
+
+	/*
+	 * The size of the request is given here, except for the algorithms
+	 * where it's optional and left to 0.
+	 */
+	if (aad_len || payload_len)
+		len = aad_len + payload_len;
+
+	balance_start(&a->st, len);
+
+	return cur_ctx(a)->ops->init(cur_ctx(a), mode, key, key_len, nonce,
+				     nonce_len, tag_len, aad_len, payload_len);
+}
+
+static TEE_Result do_authenc_update_aad(struct crypto_authenc_ctx *ctx,
+				       const uint8_t *data, size_t len)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_enter(&a->st, len);
+	res = cur_ctx(a)->ops->update_aad(cur_ctx(a), data, len);
+	balance_exit(&a->st);
+
+	return res;
+}
+
+static TEE_Result do_authenc_update_payload(struct crypto_authenc_ctx *ctx,
+					    TEE_OperationMode mode,
+					    const uint8_t *src_data,
+					    size_t len, uint8_t *dst_data)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_enter(&a->st, len);
+	res = cur_ctx(a)->ops->update_payload(cur_ctx(a), mode, src_data, len,
+					      dst_data);
+	balance_exit(&a->st);
+
+	return res;
+}
+
+static TEE_Result do_authenc_enc_final(struct crypto_authenc_ctx *ctx,
+				       const uint8_t *src_data, size_t len,
+				       uint8_t *dst_data, uint8_t *dst_tag,
+				       size_t *dst_tag_len)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_enter(&a->st, len);
+	res = cur_ctx(a)->ops->enc_final(cur_ctx(a), src_data, len, dst_data,
+					 dst_tag, dst_tag_len);
+	balance_exit(&a->st);
+
+	return res;
+}
+
+static TEE_Result do_authenc_dec_final(struct crypto_authenc_ctx *ctx,
+				       const uint8_t *src_data, size_t len,
+				       uint8_t *dst_data, const uint8_t *tag,
+				       size_t tag_len)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_enter(&a->st, len);
+	res = cur_ctx(a)->ops->dec_final(cur_ctx(a), src_data, len, dst_data,
+					 tag, tag_len);
+	balance_exit(&a->st);
+
+	return res;
+}
+
+static void do_authenc_final(struct crypto_authenc_ctx *ctx)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+
+	cur_ctx(a)->ops->final(cur_ctx(a));
+}
+
+static void do_authenc_free(struct crypto_authenc_ctx *ctx)
+{
+	struct balance_authenc *a = to_balance_authenc(ctx);
+
+	a->hw->ops->free_ctx(a->hw);
+	a->sw->ops->free_ctx(a->sw);
+	free(a);
+}
+
+static void do_authenc_copy_state(struct crypto_authenc_ctx *dst_ctx,
+				  struct crypto_authenc_ctx *src_ctx)
+{
+	struct balance_authenc *dst = to_balance_authenc(dst_ctx);
+	struct balance_authenc *src = to_balance_authenc(src_ctx);
+
+	dst->st = src->st;
+	if (src->st.started)
+		cur_ctx(dst)->ops->copy_state(cur_ctx(dst), cur_ctx(src));
+}
+
+static const struct crypto_authenc_ops balance_authenc_ops = {
+	.init = do_authenc_init,
+	.update_aad = do_authenc_update_aad,
+	.update_payload = do_authenc_update_payload,
+	.enc_final = do_authenc_enc_final,
+	.dec_final = do_authenc_dec_final,
+	.final = do_authenc_final,
+	.free_ctx = do_authenc_free,
+	.copy_state = do_authenc_copy_state,
+};
+
+void drvcrypt_balance_authenc(struct crypto_authenc_ctx **ctx, uint32_t algo)
+{
+	struct balance_authenc *a = NULL;
+
+	a = calloc(1, sizeof(*a));
+	if (!a)
+		return;
+
+	if (crypto_authenc_alloc_sw_ctx(&a->sw, algo)) {
+		free(a);
+		return;
+	}
+
+	a->hw = *ctx;
+	a->st.cls = DRVCRYPT_BALANCE_AUTHENC;
+	a->authenc_ctx.ops = &balance_authenc_ops;
+	*ctx = &a->authenc_ctx;
+}
+
+static TEE_Result calib_authenc(void *ctx, uint8_t *buf, size_t len)
+{
+	static const uint8_t key[TEE_AES_BLOCK_SIZE] = { };
+	static const uint8_t nonce[12] = { };
+	uint8_t tag[TEE_AES_BLOCK_SIZE] = { };
+	struct crypto_authenc_ctx *c = ctx;
+	size_t tag_len = sizeof(tag);
+	TEE_Result res = TEE_SUCCESS;
+
+	res = c->ops->init(c, TEE_MODE_ENCRYPT, key, sizeof(key), nonce,
+			   sizeof(nonce), sizeof(tag), 0, len);
+	if (!res)
+		res = c->ops->enc_final(c, buf, len, buf, tag, &tag_len);
+	c->ops->final(c);
+
+	return res;
+}
+
+void balance_calibrate_authenc(void)
+{
+	struct crypto_authenc_ctx *ctx = NULL;
+	struct balance_authenc *a = NULL;
+
+	if (drvcrypt_authenc_alloc_ctx(&ctx, TEE_ALG_AES_GCM))
+		return;
+
+	if (ctx->ops == &balance_authenc_ops) {
+		a = to_balance_authenc(ctx);
+		balance_calibrate(DRVCRYPT_BALANCE_AUTHENC, calib_authenc,
+				  a->hw, a->sw);
+	}
+
+	ctx->ops->free_ctx(ctx);
+}
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   Crypto Driver load balancing between the HW driver and the
+ *         software implementation.
+ */
+#include <arm.h>
+#include <atomic.h>
+#include <config.h>
+#include <initcall.h>
+#include <kernel/spinlock.h>
+#include <malloc.h>
+#include <util.h>
+
+#include "local.h"
+
+/* Request sizes tried during the calibration, in increasing order */
+static const size_t calib_size[] = { 16, 64, 256, 1024, 4096 };
+#define CALIB_ROUNDS	8
+
+struct balance_class {
+	size_t threshold;	/* Smallest request sent to the HW driver */
+	uint32_t hw_busy;	/* Requests in progress in the HW driver */
+	struct drvcrypt_balance_stats stats;
+};
+
+static struct balance_class classes[DRVCRYPT_BALANCE_MAX_CLASS] = {
+	[DRVCRYPT_BALANCE_HASH] = {
+		.threshold = CFG_CRYPTO_DRV_BALANCE_MIN_SIZE,
+	},
+	[DRVCRYPT_BALANCE_CIPHER] = {
+		.threshold = CFG_CRYPTO_DRV_BALANCE_MIN_SIZE,
+	},
+	[DRVCRYPT_BALANCE_MAC] = {
+		.threshold = CFG_CRYPTO_DRV_BALANCE_MIN_SIZE,
+	},
+	[DRVCRYPT_BALANCE_AUTHENC] = {
+		.threshold = CFG_CRYPTO_DRV_BALANCE_MIN_SIZE,
+	},
+};
+
+static unsigned int stats_lock = SPINLOCK_UNLOCK;
+
+void balance_start(struct balance_state *st, size_t len)
+{
+	struct balance_class *c = classes + st->cls;
+	uint32_t exceptions = 0;
+	bool busy = false;
+
+	st->started = true;
+	st->hw = len >= c->threshold;
+	if (st->hw && atomic_load_u32(&c->hw_busy) >=
+		      CFG_CRYPTO_DRV_BALANCE_HW_DEPTH) {
+		st->hw = false;
+		busy = true;
+	}
+
+	exceptions = cpu_spin_lock_xsave(&stats_lock);
+	if (st->hw)
+		c->stats.hw_requests++;
+	else
+		c->stats.sw_requests++;
+	if (busy)
+		c->stats.busy_count++;
+	cpu_spin_unlock_xrestore(&stats_lock, exceptions);
+}
+
+void balance_enter(struct balance_state *st, size_t len)
+{
+	struct balance_class *c = classes + st->cls;
+	uint32_t exceptions = 0;
+
+	if (st->hw)
+		atomic_inc32(&c->hw_busy);
+
+	exceptions = cpu_spin_lock_xsave(&stats_lock);
+	if (st->hw)
+		c->stats.hw_bytes += len;
+	else
+		c->stats.sw_bytes += len;
+	cpu_spin_unlock_xrestore(&stats_lock, exceptions);
+}
+
+void balance_exit(struct balance_state *st)
+{
+	if (st->hw)
+		atomic_dec32(&classes[st->cls].hw_busy);
+}
+
+TEE_Result drvcrypt_balance_get_stats(enum drvcrypt_balance_class cls,
+				      struct drvcrypt_balance_stats *stats)
+{
+	uint32_t exceptions = 0;
+
+	if (cls >= DRVCRYPT_BALANCE_MAX_CLASS)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	exceptions = cpu_spin_lock_xsave(&stats_lock);
+	*stats = classes[cls].stats;
+	cpu_spin_unlock_xrestore(&stats_lock, exceptions);
+	stats->threshold = classes[cls].threshold;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result calib_time(balance_calib_run run, void *ctx, uint8_t *buf,
+			     size_t len, uint64_t *ticks)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t start = 0;
+	unsigned int n = 0;
+
+	/* Untimed first round, lets the backend set up what it caches */
+	res = run(ctx, buf, len);
+	if (res)
+		return res;
+
+	start = barrier_read_counter_timer();
+	for (n = 0; n < CALIB_ROUNDS; n++) {
+		res = run(ctx, buf, len);
+		if (res)
+			return res;
+	}
+	*ticks = barrier_read_counter_timer() - start;
+
+	return TEE_SUCCESS;
+}
+
+void balance_calibrate(enum drvcrypt_balance_class cls, balance_calib_run run,
+		       void *hw_ctx, void *sw_ctx)
+{
+	size_t threshold = SIZE_MAX;
+	uint64_t hw_ticks = 0;
+	uint64_t sw_ticks = 0;
+	uint8_t *buf = NULL;
+	size_t n = 0;
+
+	buf = calloc(1, calib_size[ARRAY_SIZE(calib_size) - 1]);
+	if (!buf)
+		return;
+
+	for (n = 0; n < ARRAY_SIZE(calib_size); n++) {
+		if (calib_time(run, hw_ctx, buf, calib_size[n], &hw_ticks) ||
+		    calib_time(run, sw_ctx, buf, calib_size[n], &sw_ticks)) {
+			CRYPTO_TRACE("Class %d calibration failed", cls);
+			goto out;
+		}
+
+		if (hw_ticks < sw_ticks) {
+			threshold = calib_size[n];
+			break;
+		}
+	}
+
+	classes[cls].threshold = threshold;
+	DMSG("Class %d: HW driver used from %zu bytes", cls, threshold);
+out:
+	free(buf);
+}
+
+static TEE_Result balance_init(void)
+{
+	if (!IS_ENABLED(CFG_CRYPTO_DRV_BALANCE_CALIBRATE))
+		return TEE_SUCCESS;
+
+	balance_calibrate_hash();
+	balance_calibrate_cipher();
+	balance_calibrate_mac();
+	balance_calibrate_authenc();
+
+	return TEE_SUCCESS;
+}
+driver_init_late(balance_init);
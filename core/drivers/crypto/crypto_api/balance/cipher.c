@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   Cipher load balancing between the HW driver and the software
+ *         implementation.
+ */
+#include <assert.h>
+#include <malloc.h>
+#include <string.h>
+#include <string_ext.h>
+#include <utee_defines.h>
+
+#include "local.h"
+
+/* Largest key and IV saved until the first data, AES-256 and XTS */
+#define MAX_KEY_SIZE	32
+#define MAX_IV_SIZE	TEE_AES_BLOCK_SIZE
+
+struct balance_cipher {
+	struct crypto_cipher_ctx cipher_ctx; /* Crypto Cipher API context */
+	struct crypto_cipher_ctx *hw;	     /* HW driver context */
+	struct crypto_cipher_ctx *sw;	     /* Software implementation */
+	struct balance_state st;	     /* Backend in use */
+	/* Parameters of the initialization, until the backend is chosen */
+	TEE_OperationMode mode;
+	uint8_t key1[MAX_KEY_SIZE];
+	size_t key1_len;
+	uint8_t key2[MAX_KEY_SIZE];
+	size_t key2_len;
+	uint8_t iv[MAX_IV_SIZE];
+	size_t iv_len;
+};
+
+static const struct crypto_cipher_ops balance_cipher_ops;
+
+static struct balance_cipher *to_balance_cipher(struct crypto_cipher_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &balance_cipher_ops);
+
+	return container_of(ctx, struct balance_cipher, cipher_ctx);
+}
+
+static struct crypto_cipher_ctx *cur_ctx(struct balance_cipher *c)
+{
+	return c->st.hw ? c->hw : c->sw;
+}
+
+static void clear_params(struct balance_cipher *c)
+{
+	memzero_explicit(c->key1, sizeof(c->key1));
+	memzero_explicit(c->key2, sizeof(c->key2));
+}
+
+static TEE_Result start(struct balance_cipher *c, size_t len)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_start(&c->st, len);
+	res = cur_ctx(c)->ops->init(cur_ctx(c), c->mode,
+				    c->key1, c->key1_len,
+				    c->key2_len ? c->key2 : NULL, c->key2_len,
+				    c->iv_len ? c->iv : NULL, c->iv_len);
+	clear_params(c);
+
+	return res;
+}
+
+static TEE_Result do_cipher_init(struct crypto_cipher_ctx *ctx,
+				 TEE_OperationMode mode, const uint8_t *key1,
+				 size_t key1_len, const uint8_t *key2,
+				 size_t key2_len, const uint8_t *iv,
+				 size_t iv_len)
+{
+	struct balance_cipher *c = to_balance_cipher(ctx);
+
+	if (key1_len > sizeof(c->key1) || key2_len > sizeof(c->key2) ||
+	    iv_len > sizeof(c->iv)) {
+		/* Not expected, let the backend deal with it right away */
+		balance_start(&c->st, SIZE_MAX);
+		return cur_ctx(c)->ops->init(cur_ctx(c), mode, key1, key1_len,
+					     key2, key2_len, iv, iv_len);
+	}
+
+	/* The backend is chosen with the first data */
+	c->st.started = false;
+	c->mode = mode;
+	memcpy(c->key1, key1, key1_len);
+	c->key1_len = key1_len;
+	if (key2_len)
+		memcpy(c->key2, key2, key2_len);
+	c->key2_len = key2_len;
+	if (iv_len)
+		memcpy(c->iv, iv, iv_len);
+	c->iv_len = iv_len;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result do_cipher_update(struct crypto_cipher_ctx *ctx,
+				   bool last_block, const uint8_t *data,
+				   size_t len, uint8_t *dst)
+{
+	struct balance_cipher *c = to_balance_cipher(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!c->st.started) {
+		res = start(c, len);
+		if (res)
+			return res;
+	}
+
+	balance_enter(&c->st, len);
+	res = cur_ctx(c)->ops->update(cur_ctx(c), last_block, data, len, dst);
+	balance_exit(&c->st);
+
+	return res;
+}
+
+static void do_cipher_final(struct crypto_cipher_ctx *ctx)
+{
+	struct balance_cipher *c = to_balance_cipher(ctx);
+
+	if (c->st.started)
+		cur_ctx(c)->ops->final(cur_ctx(c));
+	else
+		clear_params(c);
+}
+
+static void do_cipher_free(struct crypto_cipher_ctx *ctx)
+{
+	struct balance_cipher *c = to_balance_cipher(ctx);
+
+	c->hw->ops->free_ctx(c->hw);
+	c->sw->ops->free_ctx(c->sw);
+	clear_params(c);
+	free(c);
+}
+
+static void do_cipher_copy_state(struct crypto_cipher_ctx *dst_ctx,
+				 struct crypto_cipher_ctx *src_ctx)
+{
+	struct balance_cipher *dst = to_balance_cipher(dst_ctx);
+	struct balance_cipher *src = to_balance_cipher(src_ctx);
+
+	dst->st = src->st;
+	dst->mode = src->mode;
+	memcpy(dst->key1, src->key1, sizeof(dst->key1));
+	dst->key1_len = src->key1_len;
+	memcpy(dst->key2, src->key2, sizeof(dst->key2));
+	dst->key2_len = src->key2_len;
+	memcpy(dst->iv, src->iv, sizeof(dst->iv));
+	dst->iv_len = src->iv_len;
+
+	if (src->st.started)
+		cur_ctx(dst)->ops->copy_state(cur_ctx(dst), cur_ctx(src));
+}
+
+static const struct crypto_cipher_ops balance_cipher_ops = {
+	.init = do_cipher_init,
+	.update = do_cipher_update,
+	.final = do_cipher_final,
+	.free_ctx = do_cipher_free,
+	.copy_state = do_cipher_copy_state,
+};
+
+void drvcrypt_balance_cipher(struct crypto_cipher_ctx **ctx, uint32_t algo)
+{
+	struct balance_cipher *c = NULL;
+
+	c = calloc(1, sizeof(*c));
+	if (!c)
+		return;
+
+	if (crypto_cipher_alloc_sw_ctx(&c->sw, algo)) {
+		free(c);
+		return;
+	}
+
+	c->hw = *ctx;
+	c->st.cls = DRVCRYPT_BALANCE_CIPHER;
+	c->cipher_ctx.ops = &balance_cipher_ops;
+	*ctx = &c->cipher_ctx;
+}
+
+static TEE_Result calib_cipher(void *ctx, uint8_t *buf, size_t len)
+{
+	static const uint8_t key[TEE_AES_BLOCK_SIZE] = { };
+	static const uint8_t iv[TEE_AES_BLOCK_SIZE] = { };
+	struct crypto_cipher_ctx *c = ctx;
+	TEE_Result res = TEE_SUCCESS;
+
+	res = c->ops->init(c, TEE_MODE_ENCRYPT, key, sizeof(key), NULL, 0, iv,
+			   sizeof(iv));
+	if (!res)
+		res = c->ops->update(c, true, buf, len, buf);
+	c->ops->final(c);
+
+	return res;
+}
+
+void balance_calibrate_cipher(void)
+{
+	struct crypto_cipher_ctx *ctx = NULL;
+	struct balance_cipher *c = NULL;
+
+	if (drvcrypt_cipher_alloc_ctx(&ctx, TEE_ALG_AES_CBC_NOPAD))
+		return;
+
+	if (ctx->ops == &balance_cipher_ops) {
+		c = to_balance_cipher(ctx);
+		balance_calibrate(DRVCRYPT_BALANCE_CIPHER, calib_cipher, c->hw,
+				  c->sw);
+	}
+
+	ctx->ops->free_ctx(ctx);
+}
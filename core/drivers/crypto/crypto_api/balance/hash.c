@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   Hash load balancing between the HW driver and the software
+ *         implementation.
+ */
+#include <assert.h>
+#include <malloc.h>
+#include <utee_defines.h>
+
+#include "local.h"
+
+struct balance_hash {
+	struct crypto_hash_ctx hash_ctx; /* Crypto Hash API context */
+	struct crypto_hash_ctx *hw;	 /* HW driver context */
+	struct crypto_hash_ctx *sw;	 /* Software implementation context */
+	struct balance_state st;	 /* Backend in use */
+};
+
+static const struct crypto_hash_ops balance_hash_ops;
+
+static struct balance_hash *to_balance_hash(struct crypto_hash_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &balance_hash_ops);
+
+	return container_of(ctx, struct balance_hash, hash_ctx);
+}
+
+static struct crypto_hash_ctx *cur_ctx(struct balance_hash *h)
+{
+	return h->st.hw ? h->hw : h->sw;
+}
+
+static TEE_Result start(struct balance_hash *h, size_t len)
+{
+	balance_start(&h->st, len);
+
+	return cur_ctx(h)->ops->init(cur_ctx(h));
+}
+
+static TEE_Result do_hash_init(struct crypto_hash_ctx *ctx)
+{
+	/* The backend is chosen with the first data */
+	to_balance_hash(ctx)->st.started = false;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result do_hash_update(struct crypto_hash_ctx *ctx,
+				 const uint8_t *data, size_t len)
+{
+	struct balance_hash *h = to_balance_hash(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!h->st.started) {
+		res = start(h, len);
+		if (res)
+			return res;
+	}
+
+	balance_enter(&h->st, len);
+	res = cur_ctx(h)->ops->update(cur_ctx(h), data, len);
+	balance_exit(&h->st);
+
+	return res;
+}
+
+static TEE_Result do_hash_final(struct crypto_hash_ctx *ctx, uint8_t *digest,
+				size_t len)
+{
+	struct balance_hash *h = to_balance_hash(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!h->st.started) {
+		res = start(h, 0);
+		if (res)
+			return res;
+	}
+
+	balance_enter(&h->st, 0);
+	res = cur_ctx(h)->ops->final(cur_ctx(h), digest, len);
+	balance_exit(&h->st);
+
+	return res;
+}
+
+static void do_hash_free(struct crypto_hash_ctx *ctx)
+{
+	struct balance_hash *h = to_balance_hash(ctx);
+
+	h->hw->ops->free_ctx(h->hw);
+	h->sw->ops->free_ctx(h->sw);
+	free(h);
+}
+
+static void do_hash_copy_state(struct crypto_hash_ctx *dst_ctx,
+			       struct crypto_hash_ctx *src_ctx)
+{
+	struct balance_hash *dst = to_balance_hash(dst_ctx);
+	struct balance_hash *src = to_balance_hash(src_ctx);
+
+	dst->st = src->st;
+	if (src->st.started)
+		cur_ctx(dst)->ops->copy_state(cur_ctx(dst), cur_ctx(src));
+}
+
+static const struct crypto_hash_ops balance_hash_ops = {
+	.init = do_hash_init,
+	.update = do_hash_update,
+	.final = do_hash_final,
+	.free_ctx = do_hash_free,
+	.copy_state = do_hash_copy_state,
+};
+
+void drvcrypt_balance_hash(struct crypto_hash_ctx **ctx, uint32_t algo)
+{
+	struct balance_hash *h = NULL;
+
+	h = calloc(1, sizeof(*h));
+	if (!h)
+		return;
+
+	if (crypto_hash_alloc_sw_ctx(&h->sw, algo)) {
+		free(h);
+		return;
+	}
+
+	h->hw = *ctx;
+	h->st.cls = DRVCRYPT_BALANCE_HASH;
+	h->hash_ctx.ops = &balance_hash_ops;
+	*ctx = &h->hash_ctx;
+}
+
+static TEE_Result calib_hash(void *ctx, uint8_t *buf, size_t len)
+{
+	uint8_t digest[TEE_SHA256_HASH_SIZE] = { };
+	struct crypto_hash_ctx *c = ctx;
+	TEE_Result res = TEE_SUCCESS;
+
+	res = c->ops->init(c);
+	if (!res)
+		res = c->ops->update(c, buf, len);
+	if (!res)
+		res = c->ops->final(c, digest, sizeof(digest));
+
+	return res;
+}
+
+void balance_calibrate_hash(void)
+{
+	struct crypto_hash_ctx *ctx = NULL;
+	struct balance_hash *h = NULL;
+
+	if (drvcrypt_hash_alloc_ctx(&ctx, TEE_ALG_SHA256))
+		return;
+
+	if (ctx->ops == &balance_hash_ops) {
+		h = to_balance_hash(ctx);
+		balance_calibrate(DRVCRYPT_BALANCE_HASH, calib_hash, h->hw,
+				  h->sw);
+	}
+
+	ctx->ops->free_ctx(ctx);
+}
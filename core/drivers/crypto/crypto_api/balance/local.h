@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Definition of the functions shared locally.
+ */
+#ifndef __LOCAL_H__
+#define __LOCAL_H__
+
+#include <drvcrypt_balance.h>
+
+/*
+ * Backend of a wrapped context
+ */
+struct balance_state {
+	enum drvcrypt_balance_class cls; /* Class of the algorithm */
+	bool started;			 /* Backend chosen */
+	bool hw;			 /* HW driver chosen */
+};
+
+/*
+ * Choose the backend of a request
+ *
+ * @st   [in/out] State of the context
+ * @len  Size of the first data of the request, SIZE_MAX if unknown
+ */
+void balance_start(struct balance_state *st, size_t len);
+
+/*
+ * Account for @len bytes about to be processed by the chosen backend.
+ * Must be paired with a call to balance_exit() once done.
+ *
+ * @st   State of the context
+ * @len  Number of bytes
+ */
+void balance_enter(struct balance_state *st, size_t len);
+
+/*
+ * Account for the end of the processing started with balance_enter()
+ *
+ * @st   State of the context
+ */
+void balance_exit(struct balance_state *st);
+
+/*
+ * Calibration function running a complete request of @len bytes on @ctx
+ */
+typedef TEE_Result (*balance_calib_run)(void *ctx, uint8_t *buf, size_t len);
+
+/*
+ * Measure the request size from which the HW driver is faster than the
+ * software implementation and use it as threshold for the class
+ *
+ * @cls     Class of algorithms
+ * @run     Function running a request
+ * @hw_ctx  HW driver context
+ * @sw_ctx  Software implementation context
+ */
+void balance_calibrate(enum drvcrypt_balance_class cls, balance_calib_run run,
+		       void *hw_ctx, void *sw_ctx);
+
+/*
+ * Calibration of each class of algorithms
+ */
+#ifdef CFG_CRYPTO_DRV_HASH
+void balance_calibrate_hash(void);
+#else
+static inline void balance_calibrate_hash(void)
+{
+}
+#endif
+
+#ifdef CFG_CRYPTO_DRV_CIPHER
+void balance_calibrate_cipher(void);
+#else
+static inline void balance_calibrate_cipher(void)
+{
+}
+#endif
+
+#ifdef CFG_CRYPTO_DRV_MAC
+void balance_calibrate_mac(void);
+#else
+static inline void balance_calibrate_mac(void)
+{
+}
+#endif
+
+#ifdef CFG_CRYPTO_DRV_AUTHENC
+void balance_calibrate_authenc(void);
+#else
+static inline void balance_calibrate_authenc(void)
+{
+}
+#endif
+
+#endif /* __LOCAL_H__ */
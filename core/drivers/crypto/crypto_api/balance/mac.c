@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   MAC load balancing between the HW driver and the software
+ *         implementation.
+ */
+#include <assert.h>
+#include <malloc.h>
+#include <string.h>
+#include <string_ext.h>
+#include <utee_defines.h>
+
+#include "local.h"
+
+/* Largest key saved until the first data, one HMAC-SHA512 block */
+#define MAX_KEY_SIZE	(TEE_SHA512_HASH_SIZE * 2)
+
+struct balance_mac {
+	struct crypto_mac_ctx mac_ctx;	/* Crypto MAC API context */
+	struct crypto_mac_ctx *hw;	/* HW driver context */
+	struct crypto_mac_ctx *sw;	/* Software implementation context */
+	struct balance_state st;	/* Backend in use */
+	uint8_t key[MAX_KEY_SIZE];	/* Key, until the backend is chosen */
+	size_t key_len;
+};
+
+static const struct crypto_mac_ops balance_mac_ops;
+
+static struct balance_mac *to_balance_mac(struct crypto_mac_ctx *ctx)
+{
+	assert(ctx && ctx->ops == &balance_mac_ops);
+
+	return container_of(ctx, struct balance_mac, mac_ctx);
+}
+
+static struct crypto_mac_ctx *cur_ctx(struct balance_mac *m)
+{
+	return m->st.hw ? m->hw : m->sw;
+}
+
+static TEE_Result start(struct balance_mac *m, size_t len)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	balance_start(&m->st, len);
+	res = cur_ctx(m)->ops->init(cur_ctx(m), m->key, m->key_len);
+	memzero_explicit(m->key, sizeof(m->key));
+
+	return res;
+}
+
+static TEE_Result do_mac_init(struct crypto_mac_ctx *ctx, const uint8_t *key,
+			      size_t len)
+{
+	struct balance_mac *m = to_balance_mac(ctx);
+
+	if (len > sizeof(m->key)) {
+		/* Long key, let the backend hash it right away */
+		balance_start(&m->st, SIZE_MAX);
+		return cur_ctx(m)->ops->init(cur_ctx(m), key, len);
+	}
+
+	/* The backend is chosen with the first data */
+	m->st.started = false;
+	memcpy(m->key, key, len);
+	m->key_len = len;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result do_mac_update(struct crypto_mac_ctx *ctx,
+				const uint8_t *data, size_t len)
+{
+	struct balance_mac *m = to_balance_mac(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!m->st.started) {
+		res = start(m, len);
+		if (res)
+			return res;
+	}
+
+	balance_enter(&m->st, len);
+	res = cur_ctx(m)->ops->update(cur_ctx(m), data, len);
+	balance_exit(&m->st);
+
+	return res;
+}
+
+static TEE_Result do_mac_final(struct crypto_mac_ctx *ctx, uint8_t *digest,
+			       size_t len)
+{
+	struct balance_mac *m = to_balance_mac(ctx);
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!m->st.started) {
+		res = start(m, 0);
+		if (res)
+			return res;
+	}
+
+	balance_enter(&m->st, 0);
+	res = cur_ctx(m)->ops->final(cur_ctx(m), digest, len);
+	balance_exit(&m->st);
+
+	return res;
+}
+
+static void do_mac_free(struct crypto_mac_ctx *ctx)
+{
+	struct balance_mac *m = to_balance_mac(ctx);
+
+	m->hw->ops->free_ctx(m->hw);
+	m->sw->ops->free_ctx(m->sw);
+	memzero_explicit(m->key, sizeof(m->key));
+	free(m);
+}
+
+static void do_mac_copy_state(struct crypto_mac_ctx *dst_ctx,
+			      struct crypto_mac_ctx *src_ctx)
+{
+	struct balance_mac *dst = to_balance_mac(dst_ctx);
+	struct balance_mac *src = to_balance_mac(src_ctx);
+
+	dst->st = src->st;
+	memcpy(dst->key, src->key, sizeof(dst->key));
+	dst->key_len = src->key_len;
+
+	if (src->st.started)
+		cur_ctx(dst)->ops->copy_state(cur_ctx(dst), cur_ctx(src));
+}
+
+static const struct crypto_mac_ops balance_mac_ops = {
+	.init = do_mac_init,
+	.update = do_mac_update,
+	.final = do_mac_final,
+	.free_ctx = do_mac_free,
+	.copy_state = do_mac_copy_state,
+};
+
+void drvcrypt_balance_mac(struct crypto_mac_ctx **ctx, uint32_t algo)
+{
+	struct balance_mac *m = NULL;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return;
+
+	if (crypto_mac_alloc_sw_ctx(&m->sw, algo)) {
+		free(m);
+		return;
+	}
+
+	m->hw = *ctx;
+	m->st.cls = DRVCRYPT_BALANCE_MAC;
+	m->mac_ctx.ops = &balance_mac_ops;
+	*ctx = &m->mac_ctx;
+}
+
+static TEE_Result calib_mac(void *ctx, uint8_t *buf, size_t len)
+{
+	static const uint8_t key[TEE_SHA256_HASH_SIZE] = { };
+	uint8_t digest[TEE_SHA256_HASH_SIZE] = { };
+	struct crypto_mac_ctx *c = ctx;
+	TEE_Result res = TEE_SUCCESS;
+
+	res = c->ops->init(c, key, sizeof(key));
+	if (!res)
+		res = c->ops->update(c, buf, len);
+	if (!res)
+		res = c->ops->final(c, digest, sizeof(digest));
+
+	return res;
+}
+
+void balance_calibrate_mac(void)
+{
+	struct crypto_mac_ctx *ctx = NULL;
+	struct balance_mac *m = NULL;
+
+	if (drvcrypt_mac_alloc_ctx(&ctx, TEE_ALG_HMAC_SHA256))
+		return;
+
+	if (ctx->ops == &balance_mac_ops) {
+		m = to_balance_mac(ctx);
+		balance_calibrate(DRVCRYPT_BALANCE_MAC, calib_mac, m->hw,
+				  m->sw);
+	}
+
+	ctx->ops->free_ctx(ctx);
+}
@@ -0,0 +1,5 @@
+srcs-y += balance.c
+srcs-$(CFG_CRYPTO_DRV_HASH) += hash.c
+srcs-$(CFG_CRYPTO_DRV_CIPHER) += cipher.c
+srcs-$(CFG_CRYPTO_DRV_MAC) += mac.c
+srcs-$(CFG_CRYPTO_DRV_AUTHENC) += authenc.c
@@ -8,6 +8,7 @@
 #include <crypto/crypto.h>
 #include <crypto/crypto_impl.h>
 #include <drvcrypt.h>
+#include <drvcrypt_balance.h>
 #include <drvcrypt_cipher.h>
 #include <kernel/panic.h>
 #include <malloc.h>
@@ -192,6 +193,7 @@ TEE_Result drvcrypt_cipher_alloc_ctx(struct crypto_cipher_ctx **ctx,
 	} else {
 		cipher->cipher_ctx.ops = &cipher_ops;
 		*ctx = &cipher->cipher_ctx;
+		drvcrypt_balance_cipher(ctx, algo);
 	}
 
 	CRYPTO_TRACE("Cipher alloc_ctx ret 0x%" PRIX32, ret);
@@ -6,6 +6,7 @@
  */
 #include <assert.h>
 #include <drvcrypt.h>
+#include <drvcrypt_balance.h>
 #include <drvcrypt_hash.h>
 #include <utee_defines.h>
 #include <util.h>
@@ -24,6 +25,9 @@ TEE_Result drvcrypt_hash_alloc_ctx(struct crypto_hash_ctx **ctx, uint32_t algo)
 	if (hash_alloc)
 		ret = hash_alloc(ctx, algo);
 
+	if (!ret)
+		drvcrypt_balance_hash(ctx, algo);
+
 	CRYPTO_TRACE("hash alloc_ctx ret 0x%" PRIX32, ret);
 
 	return ret;
@@ -0,0 +1,99 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2021, Linaro Limited
+ *
+ * Brief   Crypto Driver load balancing between the HW driver and the
+ *         software implementation.
+ *
+ * The contexts allocated by a HW driver are wrapped together with a
+ * context of the software implementation of the same algorithm. The
+ * backend is chosen when the first data is processed: requests smaller
+ * than the threshold of the class, or arriving while the driver already
+ * has CFG_CRYPTO_DRV_BALANCE_HW_DEPTH requests in progress, are processed
+ * in software.
+ */
+#ifndef __DRVCRYPT_BALANCE_H__
+#define __DRVCRYPT_BALANCE_H__
+
+#include <crypto/crypto_impl.h>
+#include <drvcrypt.h>
+
+/*
+ * Classes of algorithms balanced
+ */
+enum drvcrypt_balance_class {
+	DRVCRYPT_BALANCE_HASH = 0, /* Hash */
+	DRVCRYPT_BALANCE_CIPHER,   /* Cipher */
+	DRVCRYPT_BALANCE_MAC,	   /* MAC */
+	DRVCRYPT_BALANCE_AUTHENC,  /* Authenticated Encryption */
+	DRVCRYPT_BALANCE_MAX_CLASS
+};
+
+/*
+ * Load balancing counters of a class
+ */
+struct drvcrypt_balance_stats {
+	size_t threshold;	 /* Smallest request sent to the HW driver */
+	uint32_t busy_count;	 /* Requests moved to software, HW busy */
+	uint64_t hw_requests;	 /* Requests processed by the HW driver */
+	uint64_t sw_requests;	 /* Requests processed in software */
+	uint64_t hw_bytes;	 /* Bytes processed by the HW driver */
+	uint64_t sw_bytes;	 /* Bytes processed in software */
+};
+
+#ifdef CFG_CRYPTO_DRV_BALANCE
+/*
+ * Get the load balancing counters of a class
+ *
+ * @cls    Class of algorithms
+ * @stats  [out] Counters
+ */
+TEE_Result drvcrypt_balance_get_stats(enum drvcrypt_balance_class cls,
+				      struct drvcrypt_balance_stats *stats);
+
+/*
+ * Wrap a context allocated by a HW driver for load balancing. The context
+ * is left as is if the software implementation doesn't support @algo or if
+ * the wrapper can't be allocated.
+ *
+ * @ctx   [in/out] HW driver context, replaced by the wrapper
+ * @algo  Algorithm of the context
+ */
+void drvcrypt_balance_hash(struct crypto_hash_ctx **ctx, uint32_t algo);
+void drvcrypt_balance_cipher(struct crypto_cipher_ctx **ctx, uint32_t algo);
+void drvcrypt_balance_mac(struct crypto_mac_ctx **ctx, uint32_t algo);
+void drvcrypt_balance_authenc(struct crypto_authenc_ctx **ctx, uint32_t algo);
+#else
+static inline TEE_Result
+drvcrypt_balance_get_stats(enum drvcrypt_balance_class cls __unused,
+			   struct drvcrypt_balance_stats *stats __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+
+static inline void
+drvcrypt_balance_hash(struct crypto_hash_ctx **ctx __unused,
+		      uint32_t algo __unused)
+{
+}
+
+static inline void
+drvcrypt_balance_cipher(struct crypto_cipher_ctx **ctx __unused,
+			uint32_t algo __unused)
+{
+}
+
+static inline void
+drvcrypt_balance_mac(struct crypto_mac_ctx **ctx __unused,
+		     uint32_t algo __unused)
+{
+}
+
+static inline void
+drvcrypt_balance_authenc(struct crypto_authenc_ctx **ctx __unused,
+			 uint32_t algo __unused)
+{
+}
+#endif /* CFG_CRYPTO_DRV_BALANCE */
+
+#endif /* __DRVCRYPT_BALANCE_H__ */
@@ -6,6 +6,7 @@
  */
 #include <assert.h>
 #include <drvcrypt.h>
+#include <drvcrypt_balance.h>
 #include <drvcrypt_mac.h>
 #include <utee_defines.h>
 #include <util.h>
@@ -28,6 +29,9 @@ TEE_Result drvcrypt_mac_alloc_ctx(struct crypto_mac_ctx **ctx, uint32_t algo)
 	if (mac_alloc)
 		ret = mac_alloc(ctx, algo);
 
+	if (!ret)
+		drvcrypt_balance_mac(ctx, algo);
+
 	CRYPTO_TRACE("mac alloc_ctx ret 0x%" PRIX32, ret);
 
 	return ret;
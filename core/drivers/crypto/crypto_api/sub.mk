@@ -1,6 +1,7 @@
 srcs-y += drvcrypt.c
 
 subdirs-y += math
+subdirs-$(CFG_CRYPTO_DRV_BALANCE) += balance
 
 subdirs-$(CFG_CRYPTO_DRV_HASH)    += hash
 subdirs-$(CFG_CRYPTO_DRV_ACIPHER) += acipher
@@ -40,6 +40,13 @@ TEE_Result crypto_cipher_init(void *ctx, TEE_OperationMode mode,
 			      const uint8_t *key1, size_t key1_len,
 			      const uint8_t *key2, size_t key2_len,
 			      const uint8_t *iv, size_t iv_len);
+/*
+ * Sets a new IV, keeping the key schedule from the last successful
+ * crypto_cipher_init() on the context. Returns TEE_ERROR_NOT_SUPPORTED if
+ * the implementation can't, crypto_cipher_init() must be used instead.
+ */
+TEE_Result crypto_cipher_reinit(void *ctx, TEE_OperationMode mode,
+				const uint8_t *iv, size_t iv_len);
 TEE_Result crypto_cipher_update(void *ctx, TEE_OperationMode mode,
 				bool last_block, const uint8_t *data,
 				size_t len, uint8_t *dst);
@@ -56,6 +63,34 @@ TEE_Result crypto_mac_final(void *ctx, uint8_t *digest, size_t digest_len);
 void crypto_mac_free_ctx(void *ctx);
 void crypto_mac_copy_state(void *dst_ctx, void *src_ctx);
 
+/*
+ * HMAC with precomputed pads. The hash states after absorbing the key
+ * XORed with ipad and opad are computed once by crypto_hmac_pads_init()
+ * and cloned for each message. Compared to calling crypto_mac_init() with
+ * the same key for each message this saves two hash block compressions
+ * per message, which matters for iterated constructions like PBKDF2.
+ *
+ * A message is processed with crypto_hmac_pads_start(), any number of
+ * crypto_hmac_pads_update() and crypto_hmac_pads_final() which writes
+ * @digest_len bytes to @digest.
+ */
+struct crypto_hmac_pads {
+	void *inner;
+	void *outer;
+	void *ctx;
+	size_t digest_len;
+};
+
+TEE_Result crypto_hmac_pads_init(struct crypto_hmac_pads *pads,
+				 uint32_t hash_algo, const uint8_t *key,
+				 size_t key_len);
+void crypto_hmac_pads_start(struct crypto_hmac_pads *pads);
+TEE_Result crypto_hmac_pads_update(struct crypto_hmac_pads *pads,
+				   const uint8_t *data, size_t len);
+TEE_Result crypto_hmac_pads_final(struct crypto_hmac_pads *pads,
+				  uint8_t *digest);
+void crypto_hmac_pads_free(struct crypto_hmac_pads *pads);
+
 /* Authenticated encryption */
 TEE_Result crypto_authenc_alloc_ctx(void **ctx, uint32_t algo);
 TEE_Result crypto_authenc_init(void *ctx, TEE_OperationMode mode,
@@ -63,6 +98,11 @@ TEE_Result crypto_authenc_init(void *ctx, TEE_OperationMode mode,
 			       const uint8_t *nonce, size_t nonce_len,
 			       size_t tag_len, size_t aad_len,
 			       size_t payload_len);
+/* Same as crypto_cipher_reinit() but for crypto_authenc_init() */
+TEE_Result crypto_authenc_reinit(void *ctx, TEE_OperationMode mode,
+				 const uint8_t *nonce, size_t nonce_len,
+				 size_t tag_len, size_t aad_len,
+				 size_t payload_len);
 TEE_Result crypto_authenc_update_aad(void *ctx, TEE_OperationMode mode,
 				     const uint8_t *data, size_t len);
 TEE_Result crypto_authenc_update_payload(void *ctx, TEE_OperationMode mode,
@@ -103,6 +143,14 @@ void crypto_bignum_clear(struct bignum *a);
 /* return -1 if a<b, 0 if a==b, +1 if a>b */
 int32_t crypto_bignum_compare(struct bignum *a, struct bignum *b);
 
+/*
+ * Bracket an asymmetric operation on a key of up to size_bits bits, the
+ * temporary bignums of the operation are then taken from an arena reset
+ * by crypto_bignum_arena_end(). Calls may be nested.
+ */
+void crypto_bignum_arena_begin(size_t size_bits);
+void crypto_bignum_arena_end(void);
+
 /* Asymmetric algorithms */
 
 struct rsa_keypair {
@@ -116,6 +164,9 @@ struct rsa_keypair {
 	struct bignum *qp;	/* 1/q mod p */
 	struct bignum *dp;	/* d mod (p-1) */
 	struct bignum *dq;	/* d mod (q-1) */
+
+	/* Values cached by the crypto library, NULL if none */
+	struct rsa_keypair_cache *cache;
 };
 
 struct rsa_public_key {
@@ -167,6 +218,21 @@ struct ecc_keypair {
 	const struct crypto_ecc_keypair_ops *ops; /* Key Operations */
 };
 
+/* Curve25519 keys, 32 bytes each in the RFC 7748 and RFC 8032 encoding */
+struct x25519_keypair {
+	uint8_t *priv;	/* Private scalar */
+	uint8_t *pub;	/* Public u-coordinate */
+};
+
+struct ed25519_keypair {
+	uint8_t *priv;	/* Private key seed */
+	uint8_t *pub;	/* Public key */
+};
+
+struct ed25519_public_key {
+	uint8_t *pub;	/* Public key */
+};
+
 /*
  * Key allocation functions
  * Allocate the bignum's inside a key structure.
@@ -178,6 +244,11 @@ TEE_Result crypto_acipher_alloc_rsa_public_key(struct rsa_public_key *s,
 				   size_t key_size_bits);
 void crypto_acipher_free_rsa_public_key(struct rsa_public_key *s);
 void crypto_acipher_free_rsa_keypair(struct rsa_keypair *s);
+/*
+ * Frees the values cached with the private key @s, needed when @s is
+ * freed or cleared without calling crypto_acipher_free_rsa_keypair().
+ */
+void crypto_acipher_clear_rsa_keypair_cache(struct rsa_keypair *s);
 TEE_Result crypto_acipher_alloc_dsa_keypair(struct dsa_keypair *s,
 				size_t key_size_bits);
 TEE_Result crypto_acipher_alloc_dsa_public_key(struct dsa_public_key *s,
@@ -191,6 +262,13 @@ TEE_Result crypto_acipher_alloc_ecc_keypair(struct ecc_keypair *s,
 					    uint32_t key_type,
 					    size_t key_size_bits);
 void crypto_acipher_free_ecc_public_key(struct ecc_public_key *s);
+TEE_Result crypto_acipher_alloc_x25519_keypair(struct x25519_keypair *s,
+					       size_t key_size_bits);
+TEE_Result crypto_acipher_alloc_ed25519_keypair(struct ed25519_keypair *s,
+						size_t key_size_bits);
+TEE_Result
+crypto_acipher_alloc_ed25519_public_key(struct ed25519_public_key *s,
+					size_t key_size_bits);
 
 /*
  * Key generation functions
@@ -200,6 +278,10 @@ TEE_Result crypto_acipher_gen_dsa_key(struct dsa_keypair *key, size_t key_size);
 TEE_Result crypto_acipher_gen_dh_key(struct dh_keypair *key, struct bignum *q,
 				     size_t xbits, size_t key_size);
 TEE_Result crypto_acipher_gen_ecc_key(struct ecc_keypair *key, size_t key_size);
+TEE_Result crypto_acipher_gen_x25519_key(struct x25519_keypair *key,
+					 size_t key_size);
+TEE_Result crypto_acipher_gen_ed25519_key(struct ed25519_keypair *key,
+					  size_t key_size);
 
 TEE_Result crypto_acipher_dh_shared_secret(struct dh_keypair *private_key,
 					   struct bignum *public_key,
@@ -246,6 +328,24 @@ TEE_Result crypto_acipher_ecc_shared_secret(struct ecc_keypair *private_key,
 					    struct ecc_public_key *public_key,
 					    void *secret,
 					    unsigned long *secret_len);
+/*
+ * Enables or disables the cached precomputed tables used by ECC point
+ * multiplications and returns the previous setting. Only intended to
+ * compare performance, the result of the operations is the same.
+ */
+bool crypto_acipher_ecc_precomp_enable(bool enable);
+TEE_Result crypto_acipher_x25519_shared_secret(struct x25519_keypair
+					       *private_key,
+					       const void *public_key,
+					       void *secret,
+					       unsigned long *secret_len);
+/* Pure Ed25519, @msg is the message itself and not a digest of it */
+TEE_Result crypto_acipher_ed25519_sign(struct ed25519_keypair *key,
+				       const uint8_t *msg, size_t msg_len,
+				       uint8_t *sig, size_t *sig_len);
+TEE_Result crypto_acipher_ed25519_verify(struct ed25519_public_key *key,
+					 const uint8_t *msg, size_t msg_len,
+					 const uint8_t *sig, size_t sig_len);
 TEE_Result crypto_acipher_sm2_pke_decrypt(struct ecc_keypair *key,
 					  const uint8_t *src, size_t src_len,
 					  uint8_t *dst, size_t *dst_len);
@@ -366,4 +466,20 @@ TEE_Result crypto_aes_expand_enc_key(const void *key, size_t key_len,
 void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen,
 			  unsigned int rounds, const void *src, void *dst);
 
+/*
+ * crypto_aes_enc_blocks() - Encrypt a number of AES blocks in ECB mode
+ * @enc_key:	Expanded AES encryption key
+ * @enc_keylen:	Size of @enc_key in bytes
+ * @rounds:	Number of rounds
+ * @src:	Source buffer of @num_blocks AES blocks
+ * @dst:	Destination buffer of @num_blocks AES blocks
+ * @num_blocks:	Number of blocks to encrypt
+ *
+ * Same as calling crypto_aes_enc_block() @num_blocks times, but the
+ * expanded key is only loaded once. @src and @dst may be the same buffer.
+ */
+void crypto_aes_enc_blocks(const void *enc_key, size_t enc_keylen,
+			   unsigned int rounds, const void *src, void *dst,
+			   size_t num_blocks);
+
 #endif /* __CRYPTO_CRYPTO_H */
@@ -6,8 +6,43 @@
 #ifndef __CRYPTO_CRYPTO_ACCEL_H
 #define __CRYPTO_CRYPTO_ACCEL_H
 
+#include <stdbool.h>
 #include <tee_api_types.h>
+#include <util.h>
 
+/*
+ * Accelerated primitives, as returned by crypto_accel_get_caps()
+ */
+#define CRYPTO_ACCEL_AES	BIT32(0)
+#define CRYPTO_ACCEL_PMULL	BIT32(1)
+#define CRYPTO_ACCEL_SHA1	BIT32(2)
+#define CRYPTO_ACCEL_SHA256	BIT32(3)
+#define CRYPTO_ACCEL_SHA512	BIT32(4)
+#define CRYPTO_ACCEL_SM3	BIT32(5)
+#define CRYPTO_ACCEL_SM4	BIT32(6)
+
+/*
+ * Returns a mask of CRYPTO_ACCEL_* for the accelerated primitives which
+ * are both compiled in and supported by the CPU. The CPU is probed on
+ * first call and the result is the same for the lifetime of the system,
+ * so key schedules or other state prepared for one implementation can
+ * safely be used later on.
+ */
+uint32_t crypto_accel_get_caps(void);
+
+static inline bool crypto_accel_is_available(uint32_t caps)
+{
+	return (crypto_accel_get_caps() & caps) == caps;
+}
+
+/* Prints the outcome of crypto_accel_get_caps() */
+void crypto_accel_show_caps(void);
+
+/*
+ * Returns TEE_ERROR_NOT_SUPPORTED if the CPU doesn't implement the AES
+ * instructions, none of the other crypto_accel_aes_*() functions may be
+ * used in that case.
+ */
 TEE_Result crypto_accel_aes_expand_keys(const void *key, size_t key_len,
 					void *enc_key, void *dec_key,
 					size_t expanded_key_len,
@@ -40,8 +75,42 @@ void crypto_accel_aes_xts_dec(void *out, const void *in, const void *key1,
 			      unsigned int block_count, const void *key2,
 			      void *tweak);
 
-void crypto_accel_sha1_compress(uint32_t state[5], const void *src,
+/*
+ * The compress functions below return TEE_ERROR_NOT_SUPPORTED without
+ * touching @state if the CPU doesn't implement the needed instructions,
+ * the caller is then expected to fall back to a software implementation.
+ */
+TEE_Result crypto_accel_sha1_compress(uint32_t state[5], const void *src,
+				      unsigned int block_count);
+TEE_Result crypto_accel_sha256_compress(uint32_t state[8], const void *src,
+					unsigned int block_count);
+TEE_Result crypto_accel_sha512_compress(uint64_t state[8], const void *src,
+					unsigned int block_count);
+TEE_Result crypto_accel_sm3_compress(uint32_t state[8], const void *src,
+				     unsigned int block_count);
+
+/*
+ * SM4 with the 32 round keys as expanded by the software implementation,
+ * in reverse order for decryption. The SM4 instructions are used if the
+ * CPU implements them, Advanced SIMD otherwise if CFG_CRYPTO_SM4_ARM_NEON
+ * is enabled. Returns TEE_ERROR_NOT_SUPPORTED without touching any
+ * buffer if neither is available.
+ */
+TEE_Result crypto_accel_sm4_ecb(void *out, const void *in,
+				const uint32_t rk[32],
 				unsigned int block_count);
-void crypto_accel_sha256_compress(uint32_t state[8], const void *src,
-				  unsigned int block_count);
+TEE_Result crypto_accel_sm4_cbc_dec(void *out, const void *in,
+				    const uint32_t rk[32],
+				    unsigned int block_count, void *iv);
+TEE_Result crypto_accel_sm4_ctr_be_enc(void *out, const void *in,
+				       const uint32_t rk[32],
+				       unsigned int block_count, void *ctr);
+
+/*
+ * ChaCha with @rounds rounds, XORs @block_count blocks of 64 bytes of key
+ * stream into @out and advances the 32-bit block counter in state[12]
+ * accordingly. The caller must make sure that the counter doesn't wrap.
+ */
+void crypto_accel_chacha_xor(uint32_t state[16], void *out, const void *in,
+			     unsigned int block_count, unsigned int rounds);
 #endif /*__CRYPTO_CRYPTO_ACCEL_H*/
@@ -156,6 +156,10 @@ struct crypto_cipher_ops {
 			   const uint8_t *key1, size_t key1_len,
 			   const uint8_t *key2, size_t key2_len,
 			   const uint8_t *iv, size_t iv_len);
+	/* Optional, new IV with the key schedule of the last init() */
+	TEE_Result (*reinit)(struct crypto_cipher_ctx *ctx,
+			     TEE_OperationMode mode,
+			     const uint8_t *iv, size_t iv_len);
 	TEE_Result (*update)(struct crypto_cipher_ctx *ctx, bool last_block,
 			     const uint8_t *data, size_t len, uint8_t *dst);
 	void (*final)(struct crypto_cipher_ctx *ctx);
@@ -244,6 +248,12 @@ struct crypto_authenc_ops {
 			   const uint8_t *nonce, size_t nonce_len,
 			   size_t tag_len, size_t aad_len,
 			   size_t payload_len);
+	/* Optional, new nonce with the key schedule of the last init() */
+	TEE_Result (*reinit)(struct crypto_authenc_ctx *ctx,
+			     TEE_OperationMode mode,
+			     const uint8_t *nonce, size_t nonce_len,
+			     size_t tag_len, size_t aad_len,
+			     size_t payload_len);
 	TEE_Result (*update_aad)(struct crypto_authenc_ctx *ctx,
 				 const uint8_t *data, size_t len);
 	TEE_Result (*update_payload)(struct crypto_authenc_ctx *ctx,
@@ -266,6 +276,19 @@ struct crypto_authenc_ops {
 
 TEE_Result crypto_aes_ccm_alloc_ctx(struct crypto_authenc_ctx **ctx);
 TEE_Result crypto_aes_gcm_alloc_ctx(struct crypto_authenc_ctx **ctx);
+TEE_Result crypto_chacha20_poly1305_alloc_ctx(struct crypto_authenc_ctx **ctx);
+
+/*
+ * Allocate a context of the software implementation of an algorithm,
+ * whether a crypto driver supports it or not
+ */
+TEE_Result crypto_hash_alloc_sw_ctx(struct crypto_hash_ctx **ctx,
+				    uint32_t algo);
+TEE_Result crypto_cipher_alloc_sw_ctx(struct crypto_cipher_ctx **ctx,
+				      uint32_t algo);
+TEE_Result crypto_mac_alloc_sw_ctx(struct crypto_mac_ctx **ctx, uint32_t algo);
+TEE_Result crypto_authenc_alloc_sw_ctx(struct crypto_authenc_ctx **ctx,
+				       uint32_t algo);
 
 #ifdef CFG_CRYPTO_DRV_HASH
 TEE_Result drvcrypt_hash_alloc_ctx(struct crypto_hash_ctx **ctx, uint32_t algo);
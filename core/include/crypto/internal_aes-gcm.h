@@ -19,6 +19,9 @@ struct internal_ghash_key {
 #ifdef CFG_AES_GCM_TABLE_BASED
 	uint64_t HL[16];
 	uint64_t HH[16];
+	/* Same as above but for H^2 */
+	uint64_t H2L[16];
+	uint64_t H2H[16];
 #else
 	uint64_t hash_subkey[2];
 #endif
@@ -56,6 +59,13 @@ TEE_Result internal_aes_gcm_init(struct internal_aes_gcm_ctx *ctx,
 				 TEE_OperationMode mode, const void *key,
 				 size_t key_len, const void *nonce,
 				 size_t nonce_len, size_t tag_len);
+/*
+ * Starts a new message with the key given to the last internal_aes_gcm_init()
+ * on ctx, without computing the key schedule and GHASH key again.
+ */
+TEE_Result internal_aes_gcm_reinit(struct internal_aes_gcm_ctx *ctx,
+				   TEE_OperationMode mode, const void *nonce,
+				   size_t nonce_len, size_t tag_len);
 TEE_Result internal_aes_gcm_update_aad(struct internal_aes_gcm_ctx *ctx,
 				       const void *data, size_t len);
 TEE_Result internal_aes_gcm_update_payload(struct internal_aes_gcm_ctx *ctx,
@@ -110,6 +120,10 @@ void internal_aes_gcm_ghash_gen_tbl(struct internal_ghash_key *ghash_key,
 void internal_aes_gcm_ghash_mult_tbl(struct internal_ghash_key *ghash_key,
 				     const unsigned char x[16],
 				     unsigned char output[16]);
+void internal_aes_gcm_ghash_mult2_tbl(struct internal_ghash_key *ghash_key,
+				      const unsigned char x1[16],
+				      const unsigned char x2[16],
+				      unsigned char output[16]);
 #endif
 
 /*
@@ -131,4 +145,23 @@ internal_aes_gcm_update_payload_blocks(struct internal_aes_gcm_state *state,
 				       TEE_OperationMode mode, const void *src,
 				       size_t num_blocks, void *dst);
 
+#ifdef CFG_CRYPTO_WITH_CE
+/*
+ * Portable implementations from core/crypto/aes-gcm-sw.c, used by the
+ * implementation in core/arch/arm/crypto/ if the CPU lacks the needed
+ * instructions.
+ */
+void internal_aes_gcm_set_key_sw(struct internal_aes_gcm_state *state,
+				 const struct internal_aes_gcm_key *enc_key);
+void internal_aes_gcm_ghash_update_sw(struct internal_aes_gcm_state *state,
+				      const void *head, const void *data,
+				      size_t num_blocks);
+void
+internal_aes_gcm_update_payload_blocks_sw(struct internal_aes_gcm_state *state,
+					  const struct internal_aes_gcm_key *ek,
+					  TEE_OperationMode mode,
+					  const void *src, size_t num_blocks,
+					  void *dst);
+#endif
+
 #endif /*__CRYPTO_INTERNAL_AES_GCM_H*/
@@ -73,6 +73,7 @@ struct tee_ta_ctx {
 	uint32_t panic_code;	/* Code supplied for panic */
 	uint32_t ref_count;	/* Reference counter for multi session TA */
 	bool busy;		/* Context is busy and cannot be entered */
+	struct mutex busy_mu;	/* Protects @busy */
 	struct condvar busy_cv;	/* CV used when context is busy */
 };
 
@@ -130,7 +131,14 @@ TEE_Result tee_ta_close_session(struct tee_ta_session *sess,
 				struct tee_ta_session_head *open_sessions,
 				const TEE_Identity *clnt_id);
 
-
+/*
+ * Registers @cb to be called when a session is destroyed, with the session
+ * still held exclusively and before it's unlinked from @open_sessions.
+ * Lets the subsystem owning @open_sessions release what it has bound to
+ * the session id. Only one callback is kept.
+ */
+void tee_ta_set_session_destroy_cb(void (*cb)(struct tee_ta_session *s,
+			struct tee_ta_session_head *open_sessions));
 
 struct tee_ta_session *tee_ta_find_session(uint32_t id,
 			struct tee_ta_session_head *open_sessions);
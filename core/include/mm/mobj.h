@@ -232,6 +232,26 @@ struct mobj *mobj_mm_alloc(struct mobj *mobj_parent, size_t size,
 struct mobj *mobj_phys_alloc(paddr_t pa, size_t size, uint32_t cattr,
 			     enum buf_is_attr battr);
 
+/*
+ * Registered shared memory is indexed by cookie in a hash table with
+ * MOBJ_COOKIE_HASH_SIZE buckets.
+ */
+#define MOBJ_COOKIE_HASH_SIZE	BIT(CFG_CORE_SHM_COOKIE_HASH_BITS)
+
+/*
+ * mobj_cookie_hash() - get hash bucket index of a shared memory cookie
+ * @cookie:	Cookie supplied by normal world
+ *
+ * Cookies are often addresses of kernel objects in normal world and
+ * thus share low bits, so a multiplicative hash using the upper bits of
+ * the product is used.
+ */
+static inline size_t mobj_cookie_hash(uint64_t cookie)
+{
+	return (cookie * 0x9e3779b97f4a7c15ULL) >>
+	       (64 - CFG_CORE_SHM_COOKIE_HASH_BITS);
+}
+
 #if defined(CFG_CORE_FFA)
 struct mobj *mobj_ffa_get_by_cookie(uint64_t cookie,
 				    unsigned int internal_offs);
@@ -285,6 +305,22 @@ TEE_Result mobj_reg_shm_release_by_cookie(uint64_t cookie);
  */
 void mobj_reg_shm_unguard(struct mobj *mobj);
 
+/**
+ * struct mobj_reg_shm_stats - registered shared memory mapping statistics
+ * @map_count:		Number of times a buffer was mapped
+ * @unmap_count:	Number of times a buffer was unmapped
+ * @map_cache_hits:	Number of times a cached mapping was reused
+ * @map_cache_count:	Number of unused mappings currently cached
+ */
+struct mobj_reg_shm_stats {
+	unsigned int map_count;
+	unsigned int unmap_count;
+	unsigned int map_cache_hits;
+	unsigned int map_cache_count;
+};
+
+void mobj_reg_shm_get_stats(struct mobj_reg_shm_stats *stats);
+
 /*
  * mapped_shm represents registered shared buffer
  * which is mapped into OPTEE va space
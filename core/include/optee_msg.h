@@ -235,6 +235,32 @@ struct optee_msg_arg {
 	((OPTEE_MSG_NONCONTIG_PAGE_SIZE - sizeof(struct optee_msg_arg)) / \
 	 sizeof(struct optee_msg_param))
 
+/**
+ * struct optee_msg_ring - invoke ring header
+ * @num_entries: Number of slots following the header, a power of two
+ * @prod: Free running index of the next slot to be filled by normal world
+ * @cons: Free running index of the next slot to be processed by secure world
+ * @pad: Unused, must be zero
+ *
+ * The header is followed by @num_entries slots of OPTEE_MSG_RING_SLOT_SIZE
+ * bytes each. Slot n is located at index n & (@num_entries - 1) and holds a
+ * struct optee_msg_arg with cmd OPTEE_MSG_CMD_INVOKE_COMMAND and at most
+ * OPTEE_MSG_RING_NUM_PARAMS parameters. Normal world only updates @prod
+ * and secure world only updates @cons, once a slot has been processed
+ * its ret and ret_origin fields and output parameters are updated before
+ * @cons is advanced past it.
+ */
+struct optee_msg_ring {
+	uint32_t num_entries;
+	uint32_t prod;
+	uint32_t cons;
+	uint32_t pad;
+};
+
+#define OPTEE_MSG_RING_NUM_PARAMS	4
+#define OPTEE_MSG_RING_SLOT_SIZE	\
+	OPTEE_MSG_GET_ARG_SIZE(OPTEE_MSG_RING_NUM_PARAMS)
+
 #endif /*__ASSEMBLER__*/
 
 /*****************************************************************************
@@ -331,6 +357,24 @@ struct optee_msg_arg {
  * OPTEE_MSG_CMD_STOP_ASYNC_NOTIF informs secure world that from now is
  * normal world unable to process asynchronous notifications. Typically
  * used when the driver is shut down.
+ *
+ * OPTEE_MSG_CMD_REGISTER_RING binds an invoke ring, described by struct
+ * optee_msg_ring, to the session in struct optee_msg_arg::session. The
+ * ring must be located in previously registered shared memory:
+ * [in] param[0].attr			OPTEE_MSG_ATTR_TYPE_RMEM_INOUT
+ * [in] param[0].u.rmem.shm_ref		holds shared memory reference
+ * [in] param[0].u.rmem.offs		offset of the ring header
+ * [in] param[0].u.rmem.size		size of the ring including all slots
+ * The ring stays mapped in secure world until OPTEE_MSG_CMD_UNREGISTER_RING
+ * or OPTEE_MSG_CMD_CLOSE_SESSION is called for the session.
+ *
+ * OPTEE_MSG_CMD_DRAIN_RING processes the pending requests in the invoke
+ * ring bound to struct optee_msg_arg::session, without parameters. At most
+ * num_entries requests are processed per call, normal world checks the
+ * cons field of the ring header to find out how far secure world got.
+ *
+ * OPTEE_MSG_CMD_UNREGISTER_RING unbinds the invoke ring from struct
+ * optee_msg_arg::session, without parameters.
  */
 #define OPTEE_MSG_CMD_OPEN_SESSION	U(0)
 #define OPTEE_MSG_CMD_INVOKE_COMMAND	U(1)
@@ -340,6 +384,9 @@ struct optee_msg_arg {
 #define OPTEE_MSG_CMD_UNREGISTER_SHM	U(5)
 #define OPTEE_MSG_CMD_DO_BOTTOM_HALF	U(6)
 #define OPTEE_MSG_CMD_STOP_ASYNC_NOTIF	U(7)
+#define OPTEE_MSG_CMD_REGISTER_RING	U(8)
+#define OPTEE_MSG_CMD_DRAIN_RING	U(9)
+#define OPTEE_MSG_CMD_UNREGISTER_RING	U(10)
 #define OPTEE_MSG_FUNCID_CALL_WITH_ARG	U(0x0004)
 
 #endif /* _OPTEE_MSG_H */
@@ -18,6 +18,7 @@ struct tee_obj {
 	TEE_ObjectInfo info;
 	bool busy;		/* true if used by an operation */
 	uint32_t have_attrs;	/* bitfield identifying set properties */
+	uint64_t generation;	/* incremented when the attributes change */
 	void *attr;
 	size_t ds_pos;
 	struct tee_pobj *pobj;	/* ptr to persistant object */
@@ -63,6 +63,29 @@ TEE_Result syscall_invoke_ta_command(unsigned long sess,
 TEE_Result syscall_check_access_rights(unsigned long flags, const void *buf,
 				       size_t len);
 
+/**
+ * struct tee_svc_param_copy_stats - TA to TA parameter copy statistics
+ * @num_requests:	Number of open session and invoke requests made by TAs
+ * @num_copied:		Number of those requests using a bounce buffer
+ * @bytes_in:		Bytes copied from calling TAs into bounce buffers
+ * @bytes_out:		Bytes copied from bounce buffers back to calling TAs
+ *
+ * Only the bounce buffers used for memrefs passed by a TA to another user
+ * TA are counted, whether they're allocated from secure DDR or, with
+ * CFG_PAGED_USER_TA, as a mobj_seccpy_shm. Not counted are the partial
+ * block buffering done by libutee in tee_buffer_update(), which happens
+ * in the TA and isn't visible to the core, and the copies a pseudo TA
+ * makes on its own.
+ */
+struct tee_svc_param_copy_stats {
+	unsigned int num_requests;
+	unsigned int num_copied;
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+};
+
+void tee_svc_get_param_copy_stats(struct tee_svc_param_copy_stats *stats);
+
 TEE_Result syscall_get_cancellation_flag(uint32_t *cancel);
 
 TEE_Result syscall_unmask_cancellation(uint32_t *old_mask);
@@ -81,6 +81,14 @@ TEE_Result syscall_asymm_verify(unsigned long state,
 			size_t num_params, const void *data, size_t data_len,
 			const void *sig, size_t sig_len);
 
+TEE_Result syscall_hash_oneshot(unsigned long algo, unsigned long key,
+			const void *chunk, size_t chunk_size, void *hash,
+			uint64_t *hash_len);
+TEE_Result syscall_cipher_oneshot(unsigned long algo, unsigned long mode,
+			unsigned long key, struct utee_cryp_oneshot *bufs);
+TEE_Result syscall_authenc_oneshot(unsigned long algo, unsigned long mode,
+			unsigned long key, struct utee_cryp_oneshot *bufs);
+
 TEE_Result tee_obj_set_type(struct tee_obj *o, uint32_t obj_type,
 			    size_t max_key_size);
 
@@ -314,6 +314,8 @@ TEE_Result tee_ta_init_pseudo_ta_session(const TEE_UUID *uuid,
 
 	ctx->ref_count = 1;
 	ctx->flags = ta->flags;
+	mutex_init(&ctx->busy_mu);
+	condvar_init(&ctx->busy_cv);
 	stc->pseudo_ta = ta;
 	ctx->ts_ctx.uuid = ta->uuid;
 	ctx->ts_ctx.ops = &pseudo_ta_ops;
@@ -3,6 +3,8 @@
  * Copyright (c) 1019 Huawei Technologies Co., Ltd
  */
 
+#include <config.h>
+#include <crypto/crypto_accel.h>
 #include <initcall.h>
 #include <trace.h>
 
@@ -14,6 +16,9 @@ static TEE_Result show_conf(void)
 	IMSG("Contents of conf.mk (decode with 'base64 -d | xz -d'):");
 	trace_ext_puts(conf_str);
 #endif
+	if (IS_ENABLED(CFG_CRYPTO_WITH_CE))
+		crypto_accel_show_caps();
+
 	return TEE_SUCCESS;
 }
 service_init(show_conf);
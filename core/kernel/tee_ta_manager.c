@@ -42,6 +42,9 @@ struct mutex tee_ta_mutex = MUTEX_INITIALIZER;
 struct condvar tee_ta_init_cv = CONDVAR_INITIALIZER;
 struct tee_ta_ctx_head tee_ctxes = TAILQ_HEAD_INITIALIZER(tee_ctxes);
 
+static void (*session_destroy_cb)(struct tee_ta_session *s,
+				  struct tee_ta_session_head *open_sessions);
+
 #ifndef CFG_CONCURRENT_SINGLE_INSTANCE_TA
 static struct condvar tee_ta_cv = CONDVAR_INITIALIZER;
 static short int tee_ta_single_instance_thread = THREAD_ID_INVALID;
@@ -92,7 +95,12 @@ static void unlock_single_instance(void)
 
 static bool has_single_instance_lock(void)
 {
-	/* Requires tee_ta_mutex to be held */
+	/*
+	 * May be called without tee_ta_mutex held: only the owning thread
+	 * sets tee_ta_single_instance_thread to its own id and only the
+	 * owning thread resets it, so comparing against our own id gives
+	 * a stable answer.
+	 */
 	return tee_ta_single_instance_thread == thread_get_id();
 }
 #endif
@@ -114,6 +122,32 @@ static struct tee_ta_ctx *ts_to_ta_ctx(struct ts_ctx *ctx)
 	panic("bad context");
 }
 
+static void tee_ta_lock_single_instance(struct tee_ta_ctx *ctx)
+{
+	if (!(ctx->flags & TA_FLAG_SINGLE_INSTANCE))
+		return;
+
+	mutex_lock(&tee_ta_mutex);
+	lock_single_instance();
+	mutex_unlock(&tee_ta_mutex);
+}
+
+static void tee_ta_unlock_single_instance(struct tee_ta_ctx *ctx)
+{
+	if (!(ctx->flags & TA_FLAG_SINGLE_INSTANCE))
+		return;
+
+	mutex_lock(&tee_ta_mutex);
+	unlock_single_instance();
+	mutex_unlock(&tee_ta_mutex);
+}
+
+/*
+ * The busy state of a context is protected by the per-context
+ * @ctx->busy_mu so that invocations of different TAs don't contend on
+ * tee_ta_mutex. tee_ta_mutex is only taken for the global single-instance
+ * lock and is never acquired while holding @ctx->busy_mu.
+ */
 static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 {
 	bool rc = true;
@@ -121,10 +155,9 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return true;
 
-	mutex_lock(&tee_ta_mutex);
+	tee_ta_lock_single_instance(ctx);
 
-	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
-		lock_single_instance();
+	mutex_lock(&ctx->busy_mu);
 
 	if (has_single_instance_lock()) {
 		if (ctx->busy) {
@@ -134,8 +167,6 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 			 * dead-lock, we release the lock and return false.
 			 */
 			rc = false;
-			if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
-				unlock_single_instance();
 		}
 	} else {
 		/*
@@ -143,13 +174,17 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 		 * wait for the TA to become available.
 		 */
 		while (ctx->busy)
-			condvar_wait(&ctx->busy_cv, &tee_ta_mutex);
+			condvar_wait(&ctx->busy_cv, &ctx->busy_mu);
 	}
 
 	/* Either it's already true or we should set it to true */
 	ctx->busy = true;
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&ctx->busy_mu);
+
+	if (!rc)
+		tee_ta_unlock_single_instance(ctx);
+
 	return rc;
 }
 
@@ -164,16 +199,15 @@ static void tee_ta_clear_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return;
 
-	mutex_lock(&tee_ta_mutex);
+	mutex_lock(&ctx->busy_mu);
 
 	assert(ctx->busy);
 	ctx->busy = false;
 	condvar_signal(&ctx->busy_cv);
 
-	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
-		unlock_single_instance();
+	mutex_unlock(&ctx->busy_mu);
 
-	mutex_unlock(&tee_ta_mutex);
+	tee_ta_unlock_single_instance(ctx);
 }
 
 static void dec_session_ref_count(struct tee_ta_session *s)
@@ -297,6 +331,8 @@ static void destroy_session(struct tee_ta_session *s,
 	}
 #endif
 
+	if (session_destroy_cb)
+		session_destroy_cb(s, open_sessions);
 	tui_close_session(&s->ts_sess);
 	tee_ta_unlink_session(s, open_sessions);
 #if defined(CFG_TA_GPROF_SUPPORT)
@@ -310,6 +346,7 @@ static void destroy_context(struct tee_ta_ctx *ctx)
 	DMSG("Destroy TA ctx (0x%" PRIxVA ")",  (vaddr_t)ctx);
 
 	condvar_destroy(&ctx->busy_cv);
+	mutex_destroy(&ctx->busy_mu);
 	pgt_flush_ctx(&ctx->ts_ctx);
 	ctx->ts_ctx.ops->destroy(&ctx->ts_ctx);
 }
@@ -499,6 +536,12 @@ infinite:
 	sess->cancel_time.millis = UINT32_MAX;
 }
 
+void tee_ta_set_session_destroy_cb(void (*cb)(struct tee_ta_session *s,
+			struct tee_ta_session_head *open_sessions))
+{
+	session_destroy_cb = cb;
+}
+
 /*-----------------------------------------------------------------------------
  * Close a Trusted Application and free available resources
  *---------------------------------------------------------------------------*/
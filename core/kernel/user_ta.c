@@ -426,6 +426,7 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	TAILQ_INIT(&utc->cryp_states);
 	TAILQ_INIT(&utc->objects);
 	TAILQ_INIT(&utc->storage_enums);
+	mutex_init(&utc->ta_ctx.busy_mu);
 	condvar_init(&utc->ta_ctx.busy_cv);
 	utc->ta_ctx.ref_count = 1;
 
@@ -482,6 +483,7 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 out:
 	if (res) {
 		condvar_destroy(&utc->ta_ctx.busy_cv);
+		mutex_destroy(&utc->ta_ctx.busy_mu);
 		pgt_flush_ctx(&utc->ta_ctx.ts_ctx);
 		free_utc(utc);
 	}
@@ -35,7 +35,7 @@ static inline TEE_Result convert_ltc_verify_status(int ltc_res, int ltc_stat)
 	}
 }
 
-#ifdef CFG_CRYPTOLIB_NAME_tomcrypt
+#if defined(CFG_CRYPTOLIB_NAME_tomcrypt) && defined(LTC_MECC)
 TEE_Result ecc_populate_ltc_private_key(ecc_key *ltc_key,
 					struct ecc_keypair *key,
 					uint32_t algo, size_t *key_size_bytes);
@@ -44,6 +44,27 @@ TEE_Result ecc_populate_ltc_public_key(ecc_key *ltc_key,
 				       uint32_t algo, size_t *key_size_bytes);
 #endif
 
+#ifdef _CFG_CORE_LTC_ECC_FIXED_BASE
+/*
+ * Replacements for ltc_ecc_mulmod() and ltc_ecc_mul2add() using cached
+ * comb tables when possible, see ecc_comb.c
+ */
+int ecc_comb_mulmod(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map);
+int ecc_comb_mul2add(const ecc_point *A, void *kA, const ecc_point *B,
+		     void *kB, ecc_point *C, void *ma, void *modulus);
+#endif
+
+#ifdef _CFG_CORE_LTC_RSA_KEY_CACHE
+/*
+ * Replacement for rsa_exptmod() using the values cached with the private
+ * key, see rsa.c
+ */
+int rsa_cache_exptmod(const unsigned char *in, unsigned long inlen,
+		      unsigned char *out, unsigned long *outlen, int which,
+		      const rsa_key *key);
+#endif
+
 /* Write bignum to fixed size buffer in big endian order */
 #define mp_to_unsigned_bin2(a, b, c) \
         do { \
@@ -9,17 +9,19 @@
 #include <tee_api_defines.h>
 #include <tee_api_types.h>
 #include <tomcrypt_private.h>
+#include <utee_defines.h>
 
 TEE_Result crypto_aes_expand_enc_key(const void *key, size_t key_len,
 				     void *enc_key, size_t enc_keylen,
 				     unsigned int *rounds)
 {
-#ifdef _CFG_CORE_LTC_AES_ACCEL
-	return crypto_accel_aes_expand_keys(key, key_len, enc_key, NULL,
-					    enc_keylen, rounds);
-#else
 	symmetric_key skey;
 
+#ifdef _CFG_CORE_LTC_AES_ACCEL
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return crypto_accel_aes_expand_keys(key, key_len, enc_key, NULL,
+						    enc_keylen, rounds);
+#endif
 	if (enc_keylen < sizeof(skey.rijndael.eK))
 		return TEE_ERROR_BAD_PARAMETERS;
 
@@ -28,22 +30,37 @@ TEE_Result crypto_aes_expand_enc_key(const void *key, size_t key_len,
 
 	memcpy(enc_key, skey.rijndael.eK, sizeof(skey.rijndael.eK));
 	*rounds = skey.rijndael.Nr;
-#endif
 	return TEE_SUCCESS;
 }
 
-void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen __maybe_unused,
-			  unsigned int rounds, const void *src, void *dst)
+void crypto_aes_enc_blocks(const void *enc_key,
+			   size_t enc_keylen __maybe_unused,
+			   unsigned int rounds, const void *src, void *dst,
+			   size_t num_blocks)
 {
-#ifdef _CFG_CORE_LTC_AES_ACCEL
-	crypto_accel_aes_ecb_enc(dst, src, enc_key, rounds, 1);
-#else
 	symmetric_key skey;
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	size_t n = 0;
 
+#ifdef _CFG_CORE_LTC_AES_ACCEL
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES)) {
+		crypto_accel_aes_ecb_enc(dst, src, enc_key, rounds,
+					 num_blocks);
+		return;
+	}
+#endif
 	assert(enc_keylen >= sizeof(skey.rijndael.eK));
 	memcpy(skey.rijndael.eK, enc_key, sizeof(skey.rijndael.eK));
 	skey.rijndael.Nr = rounds;
-	if (aes_ecb_encrypt(src, dst, &skey))
-		panic();
-#endif
+	for (n = 0; n < num_blocks; n++)
+		if (aes_ecb_encrypt(s + n * TEE_AES_BLOCK_SIZE,
+				    d + n * TEE_AES_BLOCK_SIZE, &skey))
+			panic();
+}
+
+void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen,
+			  unsigned int rounds, const void *src, void *dst)
+{
+	crypto_aes_enc_blocks(enc_key, enc_keylen, rounds, src, dst, 1);
 }
@@ -47,10 +47,11 @@
 
 #include <compiler.h>
 #include <crypto/crypto_accel.h>
+#include <tomcrypt_init.h>
 #include <tomcrypt_private.h>
 
-int rijndael_setup(const unsigned char *key, int keylen, int num_rounds,
-	      symmetric_key *skey)
+static int aes_accel_setup(const unsigned char *key, int keylen,
+			   int num_rounds, symmetric_key *skey)
 {
 	unsigned int round_count = 0;
 
@@ -74,26 +75,6 @@ int rijndael_setup(const unsigned char *key, int keylen, int num_rounds,
 	return CRYPT_OK;
 }
 
-void rijndael_done(symmetric_key *skey __unused)
-{
-}
-
-int rijndael_keysize(int *keysize)
-{
-	LTC_ARGCHK(keysize);
-
-	if (*keysize < 16)
-		return CRYPT_INVALID_KEYSIZE;
-	else if (*keysize < 24)
-		*keysize = 16;
-	else if (*keysize < 32)
-		*keysize = 24;
-	else
-		*keysize = 32;
-
-	return CRYPT_OK;
-}
-
 static int aes_ecb_encrypt_nblocks(const unsigned char *pt, unsigned char *ct,
 				   unsigned long blocks,
 				   const symmetric_key *skey)
@@ -121,14 +102,14 @@ static int aes_ecb_decrypt_nblocks(const unsigned char *ct, unsigned char *pt,
 	return CRYPT_OK;
 }
 
-int rijndael_ecb_encrypt(const unsigned char *pt, unsigned char *ct,
-			 const symmetric_key *skey)
+static int aes_accel_ecb_encrypt(const unsigned char *pt, unsigned char *ct,
+				 const symmetric_key *skey)
 {
 	return aes_ecb_encrypt_nblocks(pt, ct, 1, skey);
 }
 
-int rijndael_ecb_decrypt(const unsigned char *ct, unsigned char *pt,
-			 const symmetric_key *skey)
+static int aes_accel_ecb_decrypt(const unsigned char *ct, unsigned char *pt,
+				 const symmetric_key *skey)
 {
 	return aes_ecb_decrypt_nblocks(ct, pt, 1, skey);
 }
@@ -222,16 +203,21 @@ static int aes_xts_decrypt_nblocks(const unsigned char *ct, unsigned char *pt,
 	return CRYPT_OK;
 }
 
-const struct ltc_cipher_descriptor aes_desc = {
+/*
+ * Registered instead of the software aes_desc when the CPU implements the
+ * AES instructions, see tee_ltc_reg_algs(). Key schedules set up by one
+ * descriptor can't be used with the other.
+ */
+const struct ltc_cipher_descriptor aes_accel_desc = {
 	.name = "aes",
 	.ID = 6,
 	.min_key_length = 16,
 	.max_key_length = 32,
 	.block_length = 16,
 	.default_rounds = 10,
-	.setup = rijndael_setup,
-	.ecb_encrypt = rijndael_ecb_encrypt,
-	.ecb_decrypt = rijndael_ecb_decrypt,
+	.setup = aes_accel_setup,
+	.ecb_encrypt = aes_accel_ecb_encrypt,
+	.ecb_decrypt = aes_accel_ecb_decrypt,
 	.done = rijndael_done,
 	.keysize = rijndael_keysize,
 	.accel_ecb_encrypt = aes_ecb_encrypt_nblocks,
@@ -59,6 +59,26 @@ static TEE_Result ltc_cbc_init(struct crypto_cipher_ctx *ctx,
 		return TEE_ERROR_BAD_STATE;
 }
 
+static TEE_Result ltc_cbc_reinit(struct crypto_cipher_ctx *ctx,
+				 TEE_OperationMode mode, const uint8_t *iv,
+				 size_t iv_len)
+{
+	struct ltc_cbc_ctx *c = to_cbc_ctx(ctx);
+
+	if ((int)iv_len != cipher_descriptor[c->cipher_idx]->block_length)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (mode == TEE_MODE_ENCRYPT)
+		c->update = cbc_encrypt;
+	else
+		c->update = cbc_decrypt;
+
+	if (cbc_setiv(iv, iv_len, &c->state) == CRYPT_OK)
+		return TEE_SUCCESS;
+	else
+		return TEE_ERROR_BAD_STATE;
+}
+
 static TEE_Result ltc_cbc_update(struct crypto_cipher_ctx *ctx,
 				 bool last_block __unused,
 				 const uint8_t *data, size_t len, uint8_t *dst)
@@ -94,6 +114,7 @@ static void ltc_cbc_copy_state(struct crypto_cipher_ctx *dst_ctx,
 
 static const struct crypto_cipher_ops ltc_cbc_ops = {
 	.init = ltc_cbc_init,
+	.reinit = ltc_cbc_reinit,
 	.update = ltc_cbc_update,
 	.final = ltc_cbc_final,
 	.free_ctx = ltc_cbc_free_ctx,
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <assert.h>
+#include <crypto/crypto.h>
+#include <crypto/crypto_impl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tee_api_types.h>
+#include <tomcrypt_private.h>
+#include <util.h>
+
+#define TEE_CHACHAPOLY_KEY_LENGTH	32
+#define TEE_CHACHAPOLY_NONCE_LENGTH	12
+#define TEE_CHACHAPOLY_TAG_LENGTH	16
+
+struct tee_chachapoly_state {
+	struct crypto_authenc_ctx aectx;
+	/* the chacha20poly1305 state as defined by LTC */
+	chacha20poly1305_state ctx;
+};
+
+static const struct crypto_authenc_ops chacha20_poly1305_ops;
+
+TEE_Result crypto_chacha20_poly1305_alloc_ctx(struct crypto_authenc_ctx **ctx)
+{
+	struct tee_chachapoly_state *c = calloc(1, sizeof(*c));
+
+	if (!c)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	c->aectx.ops = &chacha20_poly1305_ops;
+
+	*ctx = &c->aectx;
+	return TEE_SUCCESS;
+}
+
+static struct tee_chachapoly_state *
+to_tee_chachapoly_state(struct crypto_authenc_ctx *aectx)
+{
+	assert(aectx && aectx->ops == &chacha20_poly1305_ops);
+
+	return container_of(aectx, struct tee_chachapoly_state, aectx);
+}
+
+static void chacha20_poly1305_free_ctx(struct crypto_authenc_ctx *aectx)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+
+	memzero_explicit(&c->ctx, sizeof(c->ctx));
+	free(c);
+}
+
+static void chacha20_poly1305_copy_state(struct crypto_authenc_ctx *dst_aectx,
+					 struct crypto_authenc_ctx *src_aectx)
+{
+	struct tee_chachapoly_state *dst = to_tee_chachapoly_state(dst_aectx);
+	struct tee_chachapoly_state *src = to_tee_chachapoly_state(src_aectx);
+
+	dst->ctx = src->ctx;
+}
+
+static TEE_Result chacha20_poly1305_init(struct crypto_authenc_ctx *aectx,
+					 TEE_OperationMode mode __unused,
+					 const uint8_t *key, size_t key_len,
+					 const uint8_t *nonce, size_t nonce_len,
+					 size_t tag_len, size_t aad_len __unused,
+					 size_t payload_len __unused)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+	int ltc_res = 0;
+
+	if (!key || key_len != TEE_CHACHAPOLY_KEY_LENGTH)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (nonce_len != TEE_CHACHAPOLY_NONCE_LENGTH)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (tag_len != TEE_CHACHAPOLY_TAG_LENGTH)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	ltc_res = chacha20poly1305_init(&c->ctx, key, key_len);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+
+	ltc_res = chacha20poly1305_setiv(&c->ctx, nonce, nonce_len);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result chacha20_poly1305_update_aad(struct crypto_authenc_ctx *aectx,
+					       const uint8_t *data, size_t len)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+	int ltc_res = 0;
+
+	/* LTC rejects any AAD once the payload processing has started */
+	ltc_res = chacha20poly1305_add_aad(&c->ctx, data, len);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result
+chacha20_poly1305_update_payload(struct crypto_authenc_ctx *aectx,
+				 TEE_OperationMode mode,
+				 const uint8_t *src_data, size_t len,
+				 uint8_t *dst_data)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+	int ltc_res = 0;
+
+	if (!len)
+		return TEE_SUCCESS;
+
+	if (mode == TEE_MODE_ENCRYPT)
+		ltc_res = chacha20poly1305_encrypt(&c->ctx, src_data, len,
+						   dst_data);
+	else
+		ltc_res = chacha20poly1305_decrypt(&c->ctx, src_data, len,
+						   dst_data);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result chacha20_poly1305_enc_final(struct crypto_authenc_ctx *aectx,
+					      const uint8_t *src_data,
+					      size_t len, uint8_t *dst_data,
+					      uint8_t *dst_tag,
+					      size_t *dst_tag_len)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+	unsigned long ltc_tag_len = TEE_CHACHAPOLY_TAG_LENGTH;
+	TEE_Result res = TEE_SUCCESS;
+	int ltc_res = 0;
+
+	if (*dst_tag_len < TEE_CHACHAPOLY_TAG_LENGTH) {
+		*dst_tag_len = TEE_CHACHAPOLY_TAG_LENGTH;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	res = chacha20_poly1305_update_payload(aectx, TEE_MODE_ENCRYPT,
+					       src_data, len, dst_data);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	ltc_res = chacha20poly1305_done(&c->ctx, dst_tag, &ltc_tag_len);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+	*dst_tag_len = ltc_tag_len;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result chacha20_poly1305_dec_final(struct crypto_authenc_ctx *aectx,
+					      const uint8_t *src_data,
+					      size_t len, uint8_t *dst_data,
+					      const uint8_t *tag,
+					      size_t tag_len)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+	uint8_t dst_tag[TEE_CHACHAPOLY_TAG_LENGTH] = { };
+	unsigned long ltc_tag_len = sizeof(dst_tag);
+	TEE_Result res = TEE_SUCCESS;
+	int ltc_res = 0;
+
+	if (tag_len != TEE_CHACHAPOLY_TAG_LENGTH)
+		return TEE_ERROR_MAC_INVALID;
+
+	res = chacha20_poly1305_update_payload(aectx, TEE_MODE_DECRYPT,
+					       src_data, len, dst_data);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	ltc_res = chacha20poly1305_done(&c->ctx, dst_tag, &ltc_tag_len);
+	if (ltc_res != CRYPT_OK)
+		return TEE_ERROR_BAD_STATE;
+
+	if (consttime_memcmp(dst_tag, tag, tag_len) != 0)
+		return TEE_ERROR_MAC_INVALID;
+
+	return TEE_SUCCESS;
+}
+
+static void chacha20_poly1305_final(struct crypto_authenc_ctx *aectx)
+{
+	struct tee_chachapoly_state *c = to_tee_chachapoly_state(aectx);
+
+	memzero_explicit(&c->ctx, sizeof(c->ctx));
+}
+
+static const struct crypto_authenc_ops chacha20_poly1305_ops = {
+	.init = chacha20_poly1305_init,
+	.update_aad = chacha20_poly1305_update_aad,
+	.update_payload = chacha20_poly1305_update_payload,
+	.enc_final = chacha20_poly1305_enc_final,
+	.dec_final = chacha20_poly1305_dec_final,
+	.final = chacha20_poly1305_final,
+	.free_ctx = chacha20_poly1305_free_ctx,
+	.copy_state = chacha20_poly1305_copy_state,
+};
@@ -52,6 +52,26 @@ static TEE_Result ltc_ctr_init(struct crypto_cipher_ctx *ctx,
 		return TEE_ERROR_BAD_STATE;
 }
 
+static TEE_Result ltc_ctr_reinit(struct crypto_cipher_ctx *ctx,
+				 TEE_OperationMode mode, const uint8_t *iv,
+				 size_t iv_len)
+{
+	struct ltc_ctr_ctx *c = to_ctr_ctx(ctx);
+
+	if ((int)iv_len != cipher_descriptor[c->cipher_idx]->block_length)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (mode == TEE_MODE_ENCRYPT)
+		c->update = ctr_encrypt;
+	else
+		c->update = ctr_decrypt;
+
+	if (ctr_setiv(iv, iv_len, &c->state) == CRYPT_OK)
+		return TEE_SUCCESS;
+	else
+		return TEE_ERROR_BAD_STATE;
+}
+
 static TEE_Result ltc_ctr_update(struct crypto_cipher_ctx *ctx,
 				 bool last_block __unused,
 				 const uint8_t *data, size_t len, uint8_t *dst)
@@ -87,6 +107,7 @@ static void ltc_ctr_copy_state(struct crypto_cipher_ctx *dst_ctx,
 
 static const struct crypto_cipher_ops ltc_ctr_ops = {
 	.init = ltc_ctr_init,
+	.reinit = ltc_ctr_reinit,
 	.update = ltc_ctr_update,
 	.final = ltc_ctr_final,
 	.free_ctx = ltc_ctr_free_ctx,
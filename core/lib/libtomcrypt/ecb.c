@@ -57,6 +57,22 @@ static TEE_Result ltc_ecb_init(struct crypto_cipher_ctx *ctx,
 		return TEE_ERROR_BAD_STATE;
 }
 
+static TEE_Result ltc_ecb_reinit(struct crypto_cipher_ctx *ctx,
+				 TEE_OperationMode mode,
+				 const uint8_t *iv __unused,
+				 size_t iv_len __unused)
+{
+	struct ltc_ecb_ctx *c = to_ecb_ctx(ctx);
+
+	/* There's nothing but the key schedule */
+	if (mode == TEE_MODE_ENCRYPT)
+		c->update = ecb_encrypt;
+	else
+		c->update = ecb_decrypt;
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result ltc_ecb_update(struct crypto_cipher_ctx *ctx,
 				 bool last_block __unused,
 				 const uint8_t *data, size_t len, uint8_t *dst)
@@ -92,6 +108,7 @@ static void ltc_ecb_copy_state(struct crypto_cipher_ctx *dst_ctx,
 
 static const struct crypto_cipher_ops ltc_ecb_ops = {
 	.init = ltc_ecb_init,
+	.reinit = ltc_ecb_reinit,
 	.update = ltc_ecb_update,
 	.final = ltc_ecb_final,
 	.free_ctx = ltc_ecb_free_ctx,
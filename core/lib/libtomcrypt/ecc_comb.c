@@ -0,0 +1,599 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+/*
+ * Fixed-base comb method for ECC point multiplication, following
+ * ecp_mul_comb() in mbedtls/library/ecp.c: the scalar is made odd and
+ * recoded into signed comb digits which are all odd, so every step is a
+ * doubling followed by an addition of a point read from the table with a
+ * constant-time scan.
+ *
+ * With a comb of width COMB_W a table of 2^(COMB_W - 1) points replaces
+ * the n doublings and n additions of the Montgomery ladder in
+ * ltc_ecc_mulmod() with n / COMB_W doublings and as many additions.
+ *
+ * A table for the generator of the NIST P-256 and P-384 curves is
+ * computed on first use and kept until the TEE is reset, it's used for
+ * ECDSA signing and ECC key generation. With CFG_CRYPTO_ECC_VERIFY_TABLES
+ * > 0 tables are also computed for up to that number of public keys, the
+ * least recently used is replaced when all slots are taken. This is used
+ * for ECDSA verification which then shares the doublings between the two
+ * multiplications. Without a table for the public key, verification still
+ * uses the generator table for u1 * G.
+ */
+
+#include <assert.h>
+#include <crypto/crypto.h>
+#include <kernel/mutex.h>
+#include <mbedtls/bignum.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <util.h>
+
+#include "acipher_helpers.h"
+
+#define COMB_W			5
+#define COMB_POINTS		BIT(COMB_W - 1)
+/* Number of columns for the largest supported curve, P-384 */
+#define COMB_MAX_D		((384 + COMB_W - 1) / COMB_W)
+
+/*
+ * Points in affine coordinates and Montgomery representation, the Z
+ * coordinate is the Montgomery representation of 1 held in struct
+ * comb_curve.
+ */
+struct comb_table {
+	size_t d;
+	mbedtls_mpi x[COMB_POINTS];
+	mbedtls_mpi y[COMB_POINTS];
+};
+
+struct comb_curve {
+	const char *name;
+	bool params_loaded;
+	mbedtls_mpi prime;
+	mbedtls_mpi order;
+	mbedtls_mpi gx;
+	mbedtls_mpi gy;
+	mbedtls_mpi one;
+	struct comb_table *g;
+};
+
+struct comb_key {
+	struct comb_curve *curve;
+	mbedtls_mpi qx;
+	mbedtls_mpi qy;
+	struct comb_table *t;
+	unsigned int refc;
+	unsigned int last_use;
+};
+
+/* Both curves have a == -3, the "ma" argument to ecc_ptdbl() is NULL */
+static struct comb_curve comb_curves[] = {
+	{ .name = "NISTP256" },
+	{ .name = "NISTP384" },
+};
+
+#if CFG_CRYPTO_ECC_VERIFY_TABLES > 0
+static struct comb_key comb_keys[CFG_CRYPTO_ECC_VERIFY_TABLES];
+static unsigned int comb_key_tick;
+#endif
+
+static struct mutex comb_mu = MUTEX_INITIALIZER;
+static bool comb_disabled;
+
+static void comb_table_free(struct comb_table *t)
+{
+	size_t n = 0;
+
+	if (!t)
+		return;
+
+	for (n = 0; n < COMB_POINTS; n++) {
+		mbedtls_mpi_free(t->x + n);
+		mbedtls_mpi_free(t->y + n);
+	}
+	free(t);
+}
+
+/*
+ * Returns a table where entry i is
+ * P + sum(bit(j - 1) of i * 2^(j * d) * P) for j in [1, COMB_W), with
+ * d = ceil(bits(order) / COMB_W).
+ */
+static struct comb_table *comb_table_build(struct comb_curve *c, void *px,
+					   void *py, void *mp)
+{
+	ecc_point *pts[COMB_POINTS] = { };
+	struct comb_table *t = NULL;
+	ecc_point *p = NULL;
+	size_t i = 0;
+	size_t j = 0;
+	size_t n = 0;
+	int err = CRYPT_MEM;
+
+	t = calloc(1, sizeof(*t));
+	if (!t)
+		return NULL;
+	for (n = 0; n < COMB_POINTS; n++) {
+		mbedtls_mpi_init(t->x + n);
+		mbedtls_mpi_init(t->y + n);
+	}
+	t->d = ROUNDUP(mbedtls_mpi_bitlen(&c->order), COMB_W) / COMB_W;
+	assert(t->d <= COMB_MAX_D);
+
+	p = ltc_ecc_new_point();
+	if (!p)
+		goto out;
+	for (n = 0; n < COMB_POINTS; n++) {
+		pts[n] = ltc_ecc_new_point();
+		if (!pts[n])
+			goto out;
+	}
+
+	if ((err = mp_mulmod(px, &c->one, &c->prime, p->x)) ||
+	    (err = mp_mulmod(py, &c->one, &c->prime, p->y)) ||
+	    (err = mp_copy(&c->one, p->z)) ||
+	    (err = ltc_ecc_copy_point(p, pts[0])))
+		goto out;
+
+	for (j = 1; j < COMB_W; j++) {
+		/* p = 2^(j * d) * P */
+		for (n = 0; n < t->d; n++) {
+			err = ltc_mp.ecc_ptdbl(p, p, NULL, &c->prime, mp);
+			if (err)
+				goto out;
+		}
+		for (i = 0; i < BIT(j - 1); i++) {
+			err = ltc_mp.ecc_ptadd(pts[i], p, pts[BIT(j - 1) + i],
+					       NULL, &c->prime, mp);
+			if (err)
+				goto out;
+		}
+	}
+
+	for (n = 0; n < COMB_POINTS; n++) {
+		if ((err = ltc_ecc_map(pts[n], &c->prime, mp)) ||
+		    (err = mp_mulmod(pts[n]->x, &c->one, &c->prime,
+				     t->x + n)) ||
+		    (err = mp_mulmod(pts[n]->y, &c->one, &c->prime, t->y + n)))
+			goto out;
+	}
+
+	err = CRYPT_OK;
+out:
+	ltc_ecc_del_point(p);
+	for (n = 0; n < COMB_POINTS; n++)
+		ltc_ecc_del_point(pts[n]);
+	if (err) {
+		comb_table_free(t);
+		return NULL;
+	}
+	return t;
+}
+
+static int comb_load_params(struct comb_curve *c)
+{
+	const ltc_ecc_curve *cu = NULL;
+
+	if (ecc_find_curve(c->name, &cu) != CRYPT_OK)
+		return CRYPT_ERROR;
+
+	mbedtls_mpi_init(&c->prime);
+	mbedtls_mpi_init(&c->order);
+	mbedtls_mpi_init(&c->gx);
+	mbedtls_mpi_init(&c->gy);
+	mbedtls_mpi_init(&c->one);
+	if (mbedtls_mpi_read_string(&c->prime, 16, cu->prime) ||
+	    mbedtls_mpi_read_string(&c->order, 16, cu->order) ||
+	    mbedtls_mpi_read_string(&c->gx, 16, cu->Gx) ||
+	    mbedtls_mpi_read_string(&c->gy, 16, cu->Gy) ||
+	    mp_montgomery_normalization(&c->one, &c->prime))
+		return CRYPT_MEM;
+
+	c->params_loaded = true;
+	return CRYPT_OK;
+}
+
+/*
+ * Returns the curve if @G is the generator of one of the supported
+ * curves, the table of the generator is computed if needed.
+ */
+static struct comb_curve *comb_get_curve(const ecc_point *G, void *modulus,
+					 void *mp)
+{
+	struct comb_curve *c = NULL;
+	size_t n = 0;
+
+	mutex_lock(&comb_mu);
+
+	if (comb_disabled)
+		goto out;
+
+	for (n = 0; n < ARRAY_SIZE(comb_curves); n++) {
+		if (!comb_curves[n].params_loaded &&
+		    comb_load_params(comb_curves + n))
+			continue;
+		if (!mbedtls_mpi_cmp_mpi(&comb_curves[n].prime, modulus)) {
+			c = comb_curves + n;
+			break;
+		}
+	}
+	if (!c)
+		goto out;
+
+	if (mbedtls_mpi_cmp_mpi(&c->gx, G->x) ||
+	    mbedtls_mpi_cmp_mpi(&c->gy, G->y) ||
+	    mbedtls_mpi_cmp_int(G->z, 1)) {
+		c = NULL;
+		goto out;
+	}
+
+	if (!c->g) {
+		c->g = comb_table_build(c, &c->gx, &c->gy, mp);
+		if (!c->g)
+			c = NULL;
+	}
+out:
+	mutex_unlock(&comb_mu);
+
+	return c;
+}
+
+/* Returns 1 if @a == @b and 0 otherwise without branches */
+static uint8_t ct_eq(size_t a, size_t b)
+{
+	return ((uint64_t)(a ^ b) - 1) >> 63;
+}
+
+/*
+ * Computes the signed comb digits of the odd scalar @m as in
+ * ecp_comb_recode_core() in mbedtls/library/ecp.c. On return @x[i],
+ * 0 <= i <= @d, is odd and selects the table entry (@x[i] & 0x7f) >> 1,
+ * which is to be negated if bit 7 of @x[i] is set.
+ */
+static void comb_recode(uint8_t x[COMB_MAX_D + 1], size_t d,
+			const mbedtls_mpi *m)
+{
+	uint8_t adjust = 0;
+	uint8_t cc = 0;
+	uint8_t c = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	memset(x, 0, d + 1);
+	for (i = 0; i < d; i++)
+		for (j = 0; j < COMB_W; j++)
+			x[i] |= mbedtls_mpi_get_bit(m, i + d * j) << j;
+
+	/* Make x[1] .. x[d] odd, carries propagate to the next column */
+	for (i = 1; i <= d; i++) {
+		cc = x[i] & c;
+		x[i] ^= c;
+		c = cc;
+
+		adjust = 1 - (x[i] & 1);
+		c |= x[i] & (x[i - 1] * adjust);
+		x[i] ^= x[i - 1] * adjust;
+		x[i - 1] |= adjust << 7;
+	}
+}
+
+/*
+ * Loads the table entry selected by the comb digit @x into @r, negated
+ * if either bit 7 of @x or @neg is set. All entries are read regardless
+ * of @x.
+ */
+static int comb_select(const struct comb_table *t, struct comb_curve *c,
+		       uint8_t x, uint8_t neg, ecc_point *r, mbedtls_mpi *tmp)
+{
+	size_t idx = (x & 0x7f) >> 1;
+	size_t n = 0;
+
+	neg ^= x >> 7;
+	for (n = 0; n < COMB_POINTS; n++) {
+		if (mbedtls_mpi_safe_cond_assign(r->x, t->x + n,
+						 ct_eq(n, idx)) ||
+		    mbedtls_mpi_safe_cond_assign(r->y, t->y + n,
+						 ct_eq(n, idx)))
+			return CRYPT_MEM;
+	}
+
+	if (mbedtls_mpi_sub_mpi(tmp, &c->prime, r->y) ||
+	    mbedtls_mpi_safe_cond_assign(r->y, tmp, neg))
+		return CRYPT_MEM;
+
+	return mp_copy(&c->one, r->z);
+}
+
+/*
+ * Recodes @k, 0 < @k < order, into @x. As the recoding needs an odd
+ * scalar order - @k is used instead if @k is even and @neg is set to 1 to
+ * negate all the points added.
+ */
+static int comb_prepare_scalar(struct comb_curve *c, size_t d, void *k,
+			       uint8_t x[COMB_MAX_D + 1], uint8_t *neg)
+{
+	mbedtls_mpi m = { };
+	mbedtls_mpi nk = { };
+	int err = CRYPT_MEM;
+
+	mbedtls_mpi_init_mempool(&m);
+	mbedtls_mpi_init_mempool(&nk);
+
+	*neg = !mbedtls_mpi_get_bit(k, 0);
+	if (mbedtls_mpi_copy(&m, k) ||
+	    mbedtls_mpi_sub_mpi(&nk, &c->order, k) ||
+	    mbedtls_mpi_safe_cond_assign(&m, &nk, *neg))
+		goto out;
+
+	comb_recode(x, d, &m);
+	err = CRYPT_OK;
+out:
+	mbedtls_mpi_free(&m);
+	mbedtls_mpi_free(&nk);
+	return err;
+}
+
+static bool comb_scalar_ok(struct comb_curve *c, void *k)
+{
+	return mbedtls_mpi_cmp_int(k, 0) > 0 &&
+	       mbedtls_mpi_cmp_mpi(k, &c->order) < 0;
+}
+
+/* R = k * P where @t is the table of P, in constant time */
+static int comb_mul(struct comb_curve *c, const struct comb_table *t,
+		    void *k, ecc_point *R, void *mp)
+{
+	uint8_t x[COMB_MAX_D + 1] = { };
+	mbedtls_mpi tmp = { };
+	ecc_point *p = NULL;
+	uint8_t neg = 0;
+	size_t i = t->d;
+	int err = CRYPT_MEM;
+
+	mbedtls_mpi_init_mempool(&tmp);
+	p = ltc_ecc_new_point();
+	if (!p)
+		goto out;
+
+	err = comb_prepare_scalar(c, t->d, k, x, &neg);
+	if (err)
+		goto out;
+
+	err = comb_select(t, c, x[i], neg, R, &tmp);
+	while (!err && i--) {
+		if ((err = ltc_mp.ecc_ptdbl(R, R, NULL, &c->prime, mp)) ||
+		    (err = comb_select(t, c, x[i], neg, p, &tmp)))
+			break;
+		err = ltc_mp.ecc_ptadd(R, p, R, NULL, &c->prime, mp);
+	}
+out:
+	memzero_explicit(x, sizeof(x));
+	memzero_explicit(&neg, sizeof(neg));
+	mbedtls_mpi_free(&tmp);
+	ltc_ecc_del_point(p);
+	return err;
+}
+
+int ecc_comb_mulmod(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map)
+{
+	struct comb_curve *c = NULL;
+	void *mp = NULL;
+	int err = CRYPT_OK;
+
+	if ((err = mp_montgomery_setup(modulus, &mp)))
+		return err;
+
+	c = comb_get_curve(G, modulus, mp);
+	if (!c || !comb_scalar_ok(c, k)) {
+		mp_montgomery_free(mp);
+		return ltc_ecc_mulmod(k, G, R, a, modulus, map);
+	}
+
+	err = comb_mul(c, c->g, k, R, mp);
+	if (!err && map)
+		err = ltc_ecc_map(R, modulus, mp);
+
+	mp_montgomery_free(mp);
+	return err;
+}
+
+#if CFG_CRYPTO_ECC_VERIFY_TABLES > 0
+/*
+ * Returns a reference to the table of the public key @Q, computing it if
+ * needed. NULL is returned if all slots are in use.
+ */
+static struct comb_key *comb_get_key(struct comb_curve *c, const ecc_point *Q,
+				     void *mp)
+{
+	struct comb_key *victim = NULL;
+	struct comb_key *k = NULL;
+	size_t n = 0;
+
+	mutex_lock(&comb_mu);
+
+	for (n = 0; n < ARRAY_SIZE(comb_keys); n++) {
+		k = comb_keys + n;
+		if (k->t && k->curve == c &&
+		    !mbedtls_mpi_cmp_mpi(&k->qx, Q->x) &&
+		    !mbedtls_mpi_cmp_mpi(&k->qy, Q->y))
+			goto found;
+		if (!k->refc && (!victim || k->last_use < victim->last_use))
+			victim = k;
+	}
+
+	k = victim;
+	if (!k)
+		goto out;
+
+	comb_table_free(k->t);
+	k->t = NULL;
+	if (mbedtls_mpi_copy(&k->qx, Q->x) || mbedtls_mpi_copy(&k->qy, Q->y)) {
+		k = NULL;
+		goto out;
+	}
+	k->t = comb_table_build(c, Q->x, Q->y, mp);
+	if (!k->t) {
+		k = NULL;
+		goto out;
+	}
+	k->curve = c;
+found:
+	k->refc++;
+	k->last_use = ++comb_key_tick;
+out:
+	mutex_unlock(&comb_mu);
+
+	return k;
+}
+
+static void comb_put_key(struct comb_key *k)
+{
+	mutex_lock(&comb_mu);
+	assert(k->refc);
+	k->refc--;
+	mutex_unlock(&comb_mu);
+}
+#else
+static struct comb_key *comb_get_key(struct comb_curve *c __unused,
+				     const ecc_point *Q __unused,
+				     void *mp __unused)
+{
+	return NULL;
+}
+
+static void comb_put_key(struct comb_key *k __unused)
+{
+}
+#endif
+
+/*
+ * C = kA * A + kB * B where @ta and @tb are the tables of A and B. The
+ * doublings are shared between the two multiplications. Only used with
+ * public scalars, the point at infinity is handled with branches in
+ * ecc_ptadd() and ecc_ptdbl().
+ */
+static int comb_mul2(struct comb_curve *c, const struct comb_table *ta,
+		     void *kA, const struct comb_table *tb, void *kB,
+		     ecc_point *C, void *mp)
+{
+	uint8_t xa[COMB_MAX_D + 1] = { };
+	uint8_t xb[COMB_MAX_D + 1] = { };
+	mbedtls_mpi tmp = { };
+	ecc_point *p = NULL;
+	uint8_t nega = 0;
+	uint8_t negb = 0;
+	size_t i = MAX(ta->d, tb->d) + 1;
+	int err = CRYPT_MEM;
+
+	mbedtls_mpi_init_mempool(&tmp);
+	p = ltc_ecc_new_point();
+	if (!p)
+		goto out;
+
+	if ((err = comb_prepare_scalar(c, ta->d, kA, xa, &nega)) ||
+	    (err = comb_prepare_scalar(c, tb->d, kB, xb, &negb)) ||
+	    (err = ltc_ecc_set_point_xyz(1, 1, 0, C)))
+		goto out;
+
+	while (i--) {
+		if (i < MAX(ta->d, tb->d) &&
+		    (err = ltc_mp.ecc_ptdbl(C, C, NULL, &c->prime, mp)))
+			goto out;
+		if (i <= ta->d &&
+		    ((err = comb_select(ta, c, xa[i], nega, p, &tmp)) ||
+		     (err = ltc_mp.ecc_ptadd(C, p, C, NULL, &c->prime, mp))))
+			goto out;
+		if (i <= tb->d &&
+		    ((err = comb_select(tb, c, xb[i], negb, p, &tmp)) ||
+		     (err = ltc_mp.ecc_ptadd(C, p, C, NULL, &c->prime, mp))))
+			goto out;
+	}
+
+	err = ltc_ecc_map(C, &c->prime, mp);
+out:
+	mbedtls_mpi_free(&tmp);
+	ltc_ecc_del_point(p);
+	return err;
+}
+
+/*
+ * C = kA * G + kB * B where G is the generator of @c, using the table of
+ * G for the first multiplication and ltc_ecc_mulmod() for the second.
+ */
+static int comb_mul_add(struct comb_curve *c, void *kA, const ecc_point *B,
+			void *kB, ecc_point *C, void *mp)
+{
+	mbedtls_mpi a = { };
+	ecc_point *p = NULL;
+	int err = CRYPT_MEM;
+
+	mbedtls_mpi_init_mempool(&a);
+	p = ltc_ecc_new_point();
+	if (!p)
+		goto out;
+
+	/* Both curves have a == -3 */
+	if (mbedtls_mpi_sub_int(&a, &c->prime, 3))
+		goto out;
+
+	/* B first, C may be the same point as A but not as B */
+	if ((err = ltc_ecc_mulmod(kB, B, p, &a, &c->prime, 0)) ||
+	    (err = comb_mul(c, c->g, kA, C, mp)) ||
+	    (err = ltc_mp.ecc_ptadd(C, p, C, NULL, &c->prime, mp)))
+		goto out;
+
+	err = ltc_ecc_map(C, &c->prime, mp);
+out:
+	mbedtls_mpi_free(&a);
+	ltc_ecc_del_point(p);
+	return err;
+}
+
+int ecc_comb_mul2add(const ecc_point *A, void *kA, const ecc_point *B,
+		     void *kB, ecc_point *C, void *ma, void *modulus)
+{
+	struct comb_curve *c = NULL;
+	struct comb_key *k = NULL;
+	void *mp = NULL;
+	int err = CRYPT_OK;
+
+	if ((err = mp_montgomery_setup(modulus, &mp)))
+		return err;
+
+	c = comb_get_curve(A, modulus, mp);
+	if (!c || !comb_scalar_ok(c, kA) || !comb_scalar_ok(c, kB) ||
+	    mbedtls_mpi_cmp_int(B->z, 1))
+		goto fallback;
+
+	k = comb_get_key(c, B, mp);
+	if (k) {
+		err = comb_mul2(c, c->g, kA, k->t, kB, C, mp);
+		comb_put_key(k);
+	} else {
+		err = comb_mul_add(c, kA, B, kB, C, mp);
+	}
+	mp_montgomery_free(mp);
+	return err;
+
+fallback:
+	mp_montgomery_free(mp);
+	return ltc_ecc_mul2add(A, kA, B, kB, C, ma, modulus);
+}
+
+bool crypto_acipher_ecc_precomp_enable(bool enable)
+{
+	bool prev = false;
+
+	mutex_lock(&comb_mu);
+	prev = !comb_disabled;
+	comb_disabled = !enable;
+	mutex_unlock(&comb_mu);
+
+	return prev;
+}
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tee_api_types.h>
+#include <utee_defines.h>
+
+#include "acipher_helpers.h"
+
+/* Ed25519 keys are octet strings of 256 bits */
+#define ED25519_KEY_SIZE	256
+#define ED25519_KEY_SIZE_BYTES	UL(32)
+#define ED25519_SIG_SIZE_BYTES	UL(64)
+
+/* LTC rejects a NULL message even when its length is 0 */
+static const uint8_t *msg_or_empty(const uint8_t *msg)
+{
+	if (msg)
+		return msg;
+	return (const uint8_t *)"";
+}
+
+TEE_Result crypto_acipher_alloc_ed25519_keypair(struct ed25519_keypair *key,
+						size_t key_size)
+{
+	if (!key || key_size != ED25519_KEY_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	memset(key, 0, sizeof(*key));
+
+	key->priv = calloc(1, ED25519_KEY_SIZE_BYTES);
+	if (!key->priv)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	key->pub = calloc(1, ED25519_KEY_SIZE_BYTES);
+	if (!key->pub) {
+		free(key->priv);
+		key->priv = NULL;
+		return TEE_ERROR_OUT_OF_MEMORY;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result
+crypto_acipher_alloc_ed25519_public_key(struct ed25519_public_key *key,
+					size_t key_size)
+{
+	if (!key || key_size != ED25519_KEY_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	memset(key, 0, sizeof(*key));
+
+	key->pub = calloc(1, ED25519_KEY_SIZE_BYTES);
+	if (!key->pub)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result crypto_acipher_gen_ed25519_key(struct ed25519_keypair *key,
+					  size_t key_size)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+	curve25519_key ltc_key = { };
+	uint8_t priv[ED25519_KEY_SIZE_BYTES] = { };
+
+	if (key_size != ED25519_KEY_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = crypto_rng_read(priv, sizeof(priv));
+	if (res)
+		return res;
+
+	if (ed25519_set_key(priv, sizeof(priv), NULL, 0,
+			    &ltc_key) != CRYPT_OK) {
+		res = TEE_ERROR_BAD_PARAMETERS;
+		goto out;
+	}
+
+	memcpy(key->priv, ltc_key.priv, ED25519_KEY_SIZE_BYTES);
+	memcpy(key->pub, ltc_key.pub, ED25519_KEY_SIZE_BYTES);
+out:
+	memzero_explicit(priv, sizeof(priv));
+	memzero_explicit(&ltc_key, sizeof(ltc_key));
+
+	return res;
+}
+
+TEE_Result crypto_acipher_ed25519_sign(struct ed25519_keypair *key,
+				       const uint8_t *msg, size_t msg_len,
+				       uint8_t *sig, size_t *sig_len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	unsigned long siglen = 0;
+	curve25519_key ltc_key = {
+		.type = PK_PRIVATE,
+		.algo = PKA_ED25519,
+	};
+
+	if (!key || !sig_len || (!msg && msg_len))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (*sig_len < ED25519_SIG_SIZE_BYTES) {
+		*sig_len = ED25519_SIG_SIZE_BYTES;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	/*
+	 * The stored public key is used as is, ed25519_set_key() would
+	 * recompute it which costs as much as the signature itself.
+	 */
+	memcpy(ltc_key.priv, key->priv, sizeof(ltc_key.priv));
+	memcpy(ltc_key.pub, key->pub, sizeof(ltc_key.pub));
+
+	siglen = *sig_len;
+	if (ed25519_sign(msg_or_empty(msg), msg_len, sig, &siglen,
+			 &ltc_key) != CRYPT_OK)
+		res = TEE_ERROR_BAD_PARAMETERS;
+	else
+		*sig_len = siglen;
+
+	memzero_explicit(&ltc_key, sizeof(ltc_key));
+
+	return res;
+}
+
+TEE_Result crypto_acipher_ed25519_verify(struct ed25519_public_key *key,
+					 const uint8_t *msg, size_t msg_len,
+					 const uint8_t *sig, size_t sig_len)
+{
+	curve25519_key ltc_key = { };
+	int ltc_stat = 0;
+	int ltc_res = 0;
+
+	if (!key || (!msg && msg_len))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (sig_len != ED25519_SIG_SIZE_BYTES)
+		return TEE_ERROR_SIGNATURE_INVALID;
+
+	if (ed25519_set_key(NULL, 0, key->pub, ED25519_KEY_SIZE_BYTES,
+			    &ltc_key) != CRYPT_OK)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	ltc_res = ed25519_verify(msg_or_empty(msg), msg_len, sig, sig_len,
+				 &ltc_stat, &ltc_key);
+	/* CRYPT_ERROR means that the public key isn't a point on the curve */
+	if (ltc_res == CRYPT_ERROR)
+		return TEE_ERROR_SIGNATURE_INVALID;
+
+	return convert_ltc_verify_status(ltc_res, ltc_stat);
+}
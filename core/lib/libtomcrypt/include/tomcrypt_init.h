@@ -8,4 +8,11 @@
 
 void tomcrypt_init(void);
 
+#ifdef _CFG_CORE_LTC_AES_ACCEL
+struct ltc_cipher_descriptor;
+
+/* AES using the Cryptographic Extensions, see aes_accel.c */
+extern const struct ltc_cipher_descriptor aes_accel_desc;
+#endif
+
 #endif /*__TOMCRYPT_INIT_H*/
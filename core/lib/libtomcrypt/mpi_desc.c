@@ -3,16 +3,18 @@
  * Copyright (c) 2018, Linaro Limited
  */
 
+#include <config.h>
 #include <crypto/crypto.h>
 #include <kernel/panic.h>
 #include <mbedtls/bignum.h>
 #include <mempool.h>
 #include <stdlib.h>
 #include <string.h>
-#include <tomcrypt_private.h>
 #include <tomcrypt_mp.h>
 #include <util.h>
 
+#include "acipher_helpers.h"
+
 #if defined(_CFG_CORE_LTC_PAGER)
 #include <mm/core_mmu.h>
 #include <mm/tee_pager.h>
@@ -21,6 +23,15 @@
 /* Size needed for xtest to pass reliably on both ARM32 and ARM64 */
 #define MPI_MEMPOOL_SIZE	(46 * 1024)
 
+/*
+ * Arena bytes per byte of key, enough for the window table and the
+ * temporaries of a modular exponentiation. The arena takes at most half
+ * of the pool so that larger operations can still fall back to it.
+ */
+#define MPI_ARENA_KEY_RATIO	32
+#define MPI_ARENA_MIN_SIZE	(4 * 1024)
+#define MPI_ARENA_MAX_SIZE	(MPI_MEMPOOL_SIZE / 2)
+
 /* From mbedtls/library/bignum.c */
 #define ciL		(sizeof(mbedtls_mpi_uint))	/* chars in limb  */
 #define biL		(ciL << 3)			/* bits  in limb  */
@@ -679,7 +690,9 @@ ltc_math_descriptor ltc_mp = {
 	.isprime = isprime,
 
 #ifdef LTC_MECC
-#ifdef LTC_MECC_FP
+#if defined(_CFG_CORE_LTC_ECC_FIXED_BASE)
+	.ecc_ptmul = ecc_comb_mulmod,
+#elif defined(LTC_MECC_FP)
 	.ecc_ptmul = ltc_ecc_fp_mulmod,
 #else
 	.ecc_ptmul = ltc_ecc_mulmod,
@@ -688,7 +701,9 @@ ltc_math_descriptor ltc_mp = {
 	.ecc_ptdbl = ltc_ecc_projective_dbl_point,
 	.ecc_map = ltc_ecc_map,
 #ifdef LTC_ECC_SHAMIR
-#ifdef LTC_MECC_FP
+#if defined(_CFG_CORE_LTC_ECC_FIXED_BASE)
+	.ecc_mul2add = ecc_comb_mul2add,
+#elif defined(LTC_MECC_FP)
 	.ecc_mul2add = ltc_ecc_fp_mul2add,
 #else
 	.ecc_mul2add = ltc_ecc_mul2add,
@@ -698,7 +713,11 @@ ltc_math_descriptor ltc_mp = {
 
 #ifdef LTC_MRSA
 	.rsa_keygen = rsa_make_key,
+#ifdef _CFG_CORE_LTC_RSA_KEY_CACHE
+	.rsa_me = rsa_cache_exptmod,
+#else
 	.rsa_me = rsa_exptmod,
+#endif
 #endif
 	.addmod = addmod,
 	.submod = submod,
@@ -777,3 +796,22 @@ void crypto_bignum_clear(struct bignum *s)
 	if (bn->p)
 		memset(bn->p, 0, sizeof(*bn->p) * bn->n);
 }
+
+void crypto_bignum_arena_begin(size_t size_bits)
+{
+	size_t size = 0;
+
+	if (!IS_ENABLED(CFG_CORE_BIGNUM_ARENA))
+		return;
+
+	size = MAX(ROUNDUP(size_bits, 8) / 8 * MPI_ARENA_KEY_RATIO,
+		   (size_t)MPI_ARENA_MIN_SIZE);
+	mempool_arena_begin(mbedtls_mpi_mempool,
+			    MIN(size, (size_t)MPI_ARENA_MAX_SIZE));
+}
+
+void crypto_bignum_arena_end(void)
+{
+	if (IS_ENABLED(CFG_CORE_BIGNUM_ARENA))
+		mempool_arena_end(mbedtls_mpi_mempool);
+}
@@ -4,6 +4,8 @@
  */
 
 #include <crypto/crypto.h>
+#include <kernel/mutex.h>
+#include <mbedtls/bignum.h>
 #include <stdlib.h>
 #include <string.h>
 #include <tee_api_types.h>
@@ -11,9 +13,345 @@
 #include <tee/tee_cryp_utl.h>
 #include <trace.h>
 #include <utee_defines.h>
+#include <util.h>
 
 #include "acipher_helpers.h"
 
+/*
+ * Private keys are handed to LibTomCrypt embedded in this struct so that
+ * rsa_cache_exptmod() can find the struct rsa_keypair, and thus the
+ * cache, the rsa_key was built from.
+ */
+struct ltc_rsa_private_key {
+	rsa_key key;
+	struct rsa_keypair *kp;
+};
+
+#if defined(_CFG_CORE_LTC_RSA_KEY_CACHE)
+/*
+ * Values derived from a private key which don't change from one private
+ * key operation to the next. @n, @e, @p and @q are copies of the key the
+ * values were computed for, if the key has changed since the cache is
+ * rebuilt.
+ */
+struct rsa_keypair_cache {
+	struct mutex mu;
+	mbedtls_mpi n;
+	mbedtls_mpi e;
+	mbedtls_mpi p;
+	mbedtls_mpi q;
+	mbedtls_mpi rr_n;	/* R^2 mod n */
+	mbedtls_mpi rr_p;	/* R^2 mod p */
+	mbedtls_mpi rr_q;	/* R^2 mod q */
+	mbedtls_mpi vi;		/* r^e mod n, blinds the input */
+	mbedtls_mpi vf;		/* 1/r mod n, unblinds the result */
+};
+
+static struct mutex rsa_cache_mu = MUTEX_INITIALIZER;
+
+static void cache_reset(struct rsa_keypair_cache *c)
+{
+	/* mbedtls_mpi_free() also clears the memory */
+	mbedtls_mpi_free(&c->n);
+	mbedtls_mpi_free(&c->e);
+	mbedtls_mpi_free(&c->p);
+	mbedtls_mpi_free(&c->q);
+	mbedtls_mpi_free(&c->rr_n);
+	mbedtls_mpi_free(&c->rr_p);
+	mbedtls_mpi_free(&c->rr_q);
+	mbedtls_mpi_free(&c->vi);
+	mbedtls_mpi_free(&c->vf);
+}
+
+void crypto_acipher_clear_rsa_keypair_cache(struct rsa_keypair *s)
+{
+	if (!s || !s->cache)
+		return;
+
+	cache_reset(s->cache);
+	mutex_destroy(&s->cache->mu);
+	free(s->cache);
+	s->cache = NULL;
+}
+
+static struct rsa_keypair_cache *get_cache(struct rsa_keypair *kp)
+{
+	struct rsa_keypair_cache *c = NULL;
+
+	mutex_lock(&rsa_cache_mu);
+	if (!kp->cache) {
+		/* The mbedtls_mpi are kept zero initialized, off the mempool */
+		c = calloc(1, sizeof(*c));
+		if (c) {
+			mutex_init(&c->mu);
+			kp->cache = c;
+		}
+	}
+	c = kp->cache;
+	mutex_unlock(&rsa_cache_mu);
+
+	return c;
+}
+
+static int mpi_to_ltc_err(int mbedtls_err)
+{
+	if (!mbedtls_err)
+		return CRYPT_OK;
+	if (mbedtls_err == MBEDTLS_ERR_MPI_ALLOC_FAILED)
+		return CRYPT_MEM;
+	return CRYPT_ERROR;
+}
+
+/*
+ * Computes R^2 mod @m the same way as mbedtls_mpi_exp_mod() does when
+ * not supplied with it. It depends on the number of limbs of @m so the
+ * same @m must be passed to mbedtls_mpi_exp_mod() later.
+ */
+static int compute_rr(mbedtls_mpi *rr, const mbedtls_mpi *m)
+{
+	int res = 0;
+
+	res = mbedtls_mpi_lset(rr, 1);
+	if (!res)
+		res = mbedtls_mpi_shift_l(rr, m->n * 2 *
+					  sizeof(mbedtls_mpi_uint) * 8);
+	if (!res)
+		res = mbedtls_mpi_mod_mpi(rr, rr, m);
+
+	return res;
+}
+
+static bool cache_matches(struct rsa_keypair_cache *c, const rsa_key *key,
+			  bool crt)
+{
+	if (!c->n.p || mbedtls_mpi_cmp_mpi(&c->n, key->N) ||
+	    mbedtls_mpi_cmp_mpi(&c->e, key->e))
+		return false;
+	if (!crt)
+		return true;
+	return c->p.p && !mbedtls_mpi_cmp_mpi(&c->p, key->p) &&
+	       !mbedtls_mpi_cmp_mpi(&c->q, key->q);
+}
+
+static int cache_update(struct rsa_keypair_cache *c, const rsa_key *key,
+			bool crt)
+{
+	int res = 0;
+
+	if (cache_matches(c, key, crt))
+		return 0;
+
+	cache_reset(c);
+	res = mbedtls_mpi_copy(&c->n, key->N);
+	if (!res)
+		res = mbedtls_mpi_copy(&c->e, key->e);
+	if (!res)
+		res = compute_rr(&c->rr_n, &c->n);
+	if (!res && crt)
+		res = mbedtls_mpi_copy(&c->p, key->p);
+	if (!res && crt)
+		res = mbedtls_mpi_copy(&c->q, key->q);
+	if (!res && crt)
+		res = compute_rr(&c->rr_p, &c->p);
+	if (!res && crt)
+		res = compute_rr(&c->rr_q, &c->q);
+	if (res)
+		cache_reset(c);
+
+	return res;
+}
+
+/*
+ * Updates the blinding pair. The first time a random r is drawn, after
+ * that both values are squared which keeps the relation between them
+ * while being much cheaper than inverting and exponentiating a new r.
+ */
+static int update_blinding(struct rsa_keypair_cache *c)
+{
+	mbedtls_mpi r = { };
+	size_t n = 0;
+	int res = 0;
+
+	if (c->vi.p) {
+		res = mbedtls_mpi_mul_mpi(&c->vi, &c->vi, &c->vi);
+		if (!res)
+			res = mbedtls_mpi_mod_mpi(&c->vi, &c->vi, &c->n);
+		if (!res)
+			res = mbedtls_mpi_mul_mpi(&c->vf, &c->vf, &c->vf);
+		if (!res)
+			res = mbedtls_mpi_mod_mpi(&c->vf, &c->vf, &c->n);
+		return res;
+	}
+
+	mbedtls_mpi_init_mempool(&r);
+	for (n = 0; n < 10; n++) {
+		if (mp_rand(&r, mbedtls_mpi_size(&c->n)) != CRYPT_OK) {
+			res = MBEDTLS_ERR_MPI_ALLOC_FAILED;
+			break;
+		}
+		res = mbedtls_mpi_inv_mod(&c->vf, &r, &c->n);
+		if (res != MBEDTLS_ERR_MPI_NOT_ACCEPTABLE)
+			break;
+	}
+	if (!res)
+		res = mbedtls_mpi_exp_mod(&c->vi, &r, &c->e, &c->n, &c->rr_n);
+	mbedtls_mpi_free(&r);
+	if (res) {
+		mbedtls_mpi_free(&c->vi);
+		mbedtls_mpi_free(&c->vf);
+	}
+
+	return res;
+}
+
+/* Same as rsa_exptmod() for a private key, but using the cache */
+static int cached_private_exptmod(struct rsa_keypair_cache *c,
+				  const rsa_key *key, bool crt,
+				  const unsigned char *in, unsigned long inlen,
+				  unsigned char *out, unsigned long *outlen)
+{
+	size_t x = mbedtls_mpi_size(key->N);
+	mbedtls_mpi tmp = { };
+	mbedtls_mpi tmpa = { };
+	mbedtls_mpi tmpb = { };
+	int res = 0;
+
+	if (x > *outlen) {
+		*outlen = x;
+		return CRYPT_BUFFER_OVERFLOW;
+	}
+
+	mbedtls_mpi_init_mempool(&tmp);
+	mbedtls_mpi_init_mempool(&tmpa);
+	mbedtls_mpi_init_mempool(&tmpb);
+
+	res = mbedtls_mpi_read_binary(&tmp, in, inlen);
+	if (res)
+		goto out;
+	if (mbedtls_mpi_cmp_mpi(key->N, &tmp) < 0) {
+		mbedtls_mpi_free(&tmp);
+		mbedtls_mpi_free(&tmpa);
+		mbedtls_mpi_free(&tmpb);
+		return CRYPT_PK_INVALID_SIZE;
+	}
+
+	res = update_blinding(c);
+	if (!res)
+		res = mbedtls_mpi_mul_mpi(&tmp, &tmp, &c->vi);
+	if (!res)
+		res = mbedtls_mpi_mod_mpi(&tmp, &tmp, &c->n);
+	if (res)
+		goto out;
+
+	if (crt) {
+		/* tmpa = tmp^dP mod p, tmpb = tmp^dQ mod q */
+		res = mbedtls_mpi_exp_mod(&tmpa, &tmp, key->dP, &c->p,
+					  &c->rr_p);
+		if (!res)
+			res = mbedtls_mpi_exp_mod(&tmpb, &tmp, key->dQ, &c->q,
+						  &c->rr_q);
+		/* tmp = tmpb + q * ((tmpa - tmpb) * qInv mod p) */
+		if (!res)
+			res = mbedtls_mpi_sub_mpi(&tmp, &tmpa, &tmpb);
+		if (!res)
+			res = mbedtls_mpi_mul_mpi(&tmp, &tmp, key->qP);
+		if (!res)
+			res = mbedtls_mpi_mod_mpi(&tmp, &tmp, &c->p);
+		if (!res)
+			res = mbedtls_mpi_mul_mpi(&tmp, &tmp, &c->q);
+		if (!res)
+			res = mbedtls_mpi_add_mpi(&tmp, &tmp, &tmpb);
+	} else {
+		res = mbedtls_mpi_exp_mod(&tmpa, &tmp, key->d, &c->n,
+					  &c->rr_n);
+		if (!res)
+			res = mbedtls_mpi_copy(&tmp, &tmpa);
+	}
+
+	/* unblind */
+	if (!res)
+		res = mbedtls_mpi_mul_mpi(&tmp, &tmp, &c->vf);
+	if (!res)
+		res = mbedtls_mpi_mod_mpi(&tmp, &tmp, &c->n);
+	if (res)
+		goto out;
+
+#ifdef LTC_RSA_CRT_HARDENING
+	if (crt) {
+		res = mbedtls_mpi_exp_mod(&tmpa, &tmp, &c->e, &c->n, &c->rr_n);
+		if (!res)
+			res = mbedtls_mpi_read_binary(&tmpb, in, inlen);
+		if (res)
+			goto out;
+		if (mbedtls_mpi_cmp_mpi(&tmpa, &tmpb)) {
+			res = MBEDTLS_ERR_MPI_BAD_INPUT_DATA;
+			goto out;
+		}
+	}
+#endif
+
+	res = mbedtls_mpi_write_binary(&tmp, out, x);
+	if (!res)
+		*outlen = x;
+out:
+	mbedtls_mpi_free(&tmp);
+	mbedtls_mpi_free(&tmpa);
+	mbedtls_mpi_free(&tmpb);
+
+	return mpi_to_ltc_err(res);
+}
+
+int rsa_cache_exptmod(const unsigned char *in, unsigned long inlen,
+		      unsigned char *out, unsigned long *outlen, int which,
+		      const rsa_key *key)
+{
+	const struct ltc_rsa_private_key *k = NULL;
+	struct rsa_keypair_cache *c = NULL;
+	bool crt = false;
+	int res = 0;
+
+	if (which != PK_PRIVATE || key->type != PK_PRIVATE)
+		return rsa_exptmod(in, inlen, out, outlen, which, key);
+
+	k = container_of(key, struct ltc_rsa_private_key, key);
+	c = get_cache(k->kp);
+	if (!c)
+		return rsa_exptmod(in, inlen, out, outlen, which, key);
+
+	/* Same test as in rsa_exptmod() */
+	crt = key->p && mp_get_digit_count(key->p) &&
+	      key->q && mp_get_digit_count(key->q) &&
+	      key->dP && mp_get_digit_count(key->dP) &&
+	      key->dQ && mp_get_digit_count(key->dQ) &&
+	      key->qP && mp_get_digit_count(key->qP);
+
+	mutex_lock(&c->mu);
+	res = mpi_to_ltc_err(cache_update(c, key, crt));
+	if (res == CRYPT_OK)
+		res = cached_private_exptmod(c, key, crt, in, inlen, out,
+					     outlen);
+	mutex_unlock(&c->mu);
+
+	return res;
+}
+#endif /*_CFG_CORE_LTC_RSA_KEY_CACHE*/
+
+static void init_private_key(struct ltc_rsa_private_key *k,
+			     struct rsa_keypair *key)
+{
+	k->kp = key;
+	k->key.type = PK_PRIVATE;
+	k->key.e = key->e;
+	k->key.N = key->n;
+	k->key.d = key->d;
+	if (key->p && crypto_bignum_num_bytes(key->p)) {
+		k->key.p = key->p;
+		k->key.q = key->q;
+		k->key.qP = key->qp;
+		k->key.dP = key->dp;
+		k->key.dQ = key->dq;
+	}
+}
 
 /*
  * Compute the LibTomCrypt "hashindex" given a TEE Algorithm "algo"
@@ -135,6 +473,7 @@ void crypto_acipher_free_rsa_keypair(struct rsa_keypair *s)
 {
 	if (!s)
 		return;
+	crypto_acipher_clear_rsa_keypair_cache(s);
 	crypto_bignum_free(s->e);
 	crypto_bignum_free(s->d);
 	crypto_bignum_free(s->n);
@@ -197,8 +536,8 @@ static TEE_Result rsadorep(rsa_key *ltc_key, const uint8_t *src,
 		goto out;
 	}
 
-	ltc_res = rsa_exptmod(src, src_len, buf, &blen, ltc_key->type,
-			      ltc_key);
+	ltc_res = ltc_mp.rsa_me(src, src_len, buf, &blen, ltc_key->type,
+				ltc_key);
 	switch (ltc_res) {
 	case CRYPT_PK_NOT_PRIVATE:
 	case CRYPT_PK_INVALID_TYPE:
@@ -258,21 +597,11 @@ TEE_Result crypto_acipher_rsanopad_decrypt(struct rsa_keypair *key,
 					   uint8_t *dst, size_t *dst_len)
 {
 	TEE_Result res;
-	rsa_key ltc_key = { 0, };
+	struct ltc_rsa_private_key ltc_key = { };
 
-	ltc_key.type = PK_PRIVATE;
-	ltc_key.e = key->e;
-	ltc_key.N = key->n;
-	ltc_key.d = key->d;
-	if (key->p && crypto_bignum_num_bytes(key->p)) {
-		ltc_key.p = key->p;
-		ltc_key.q = key->q;
-		ltc_key.qP = key->qp;
-		ltc_key.dP = key->dp;
-		ltc_key.dQ = key->dq;
-	}
+	init_private_key(&ltc_key, key);
 
-	res = rsadorep(&ltc_key, src, src_len, dst, dst_len);
+	res = rsadorep(&ltc_key.key, src, src_len, dst, dst_len);
 	return res;
 }
 
@@ -286,19 +615,9 @@ TEE_Result crypto_acipher_rsaes_decrypt(uint32_t algo, struct rsa_keypair *key,
 	unsigned long blen;
 	int ltc_hashindex, ltc_res, ltc_stat, ltc_rsa_algo;
 	size_t mod_size;
-	rsa_key ltc_key = { 0, };
+	struct ltc_rsa_private_key ltc_key = { };
 
-	ltc_key.type = PK_PRIVATE;
-	ltc_key.e = key->e;
-	ltc_key.d = key->d;
-	ltc_key.N = key->n;
-	if (key->p && crypto_bignum_num_bytes(key->p)) {
-		ltc_key.p = key->p;
-		ltc_key.q = key->q;
-		ltc_key.qP = key->qp;
-		ltc_key.dP = key->dp;
-		ltc_key.dQ = key->dq;
-	}
+	init_private_key(&ltc_key, key);
 
 	/* Get the algorithm */
 	res = tee_algo_to_ltc_hashindex(algo, &ltc_hashindex);
@@ -313,7 +632,7 @@ TEE_Result crypto_acipher_rsaes_decrypt(uint32_t algo, struct rsa_keypair *key,
 	 * decrypt. We know the upper bound though.
 	 */
 	if (algo == TEE_ALG_RSAES_PKCS1_V1_5) {
-		mod_size = ltc_mp.unsigned_size((void *)(ltc_key.N));
+		mod_size = ltc_mp.unsigned_size((void *)(ltc_key.key.N));
 		blen = mod_size - 11;
 		ltc_rsa_algo = LTC_PKCS_1_V1_5;
 	} else {
@@ -331,7 +650,7 @@ TEE_Result crypto_acipher_rsaes_decrypt(uint32_t algo, struct rsa_keypair *key,
 	ltc_res = rsa_decrypt_key_ex(src, src_len, buf, &blen,
 				     ((label_len == 0) ? 0 : label), label_len,
 				     ltc_hashindex, ltc_rsa_algo, &ltc_stat,
-				     &ltc_key);
+				     &ltc_key.key);
 	switch (ltc_res) {
 	case CRYPT_PK_INVALID_PADDING:
 	case CRYPT_INVALID_PACKET:
@@ -438,19 +757,9 @@ TEE_Result crypto_acipher_rsassa_sign(uint32_t algo, struct rsa_keypair *key,
 	size_t hash_size, mod_size;
 	int ltc_res, ltc_rsa_algo, ltc_hashindex;
 	unsigned long ltc_sig_len;
-	rsa_key ltc_key = { 0, };
+	struct ltc_rsa_private_key ltc_key = { };
 
-	ltc_key.type = PK_PRIVATE;
-	ltc_key.e = key->e;
-	ltc_key.N = key->n;
-	ltc_key.d = key->d;
-	if (key->p && crypto_bignum_num_bytes(key->p)) {
-		ltc_key.p = key->p;
-		ltc_key.q = key->q;
-		ltc_key.qP = key->qp;
-		ltc_key.dP = key->dp;
-		ltc_key.dQ = key->dq;
-	}
+	init_private_key(&ltc_key, key);
 
 	switch (algo) {
 	case TEE_ALG_RSASSA_PKCS1_V1_5:
@@ -494,7 +803,7 @@ TEE_Result crypto_acipher_rsassa_sign(uint32_t algo, struct rsa_keypair *key,
 		}
 	}
 
-	mod_size = ltc_mp.unsigned_size((void *)(ltc_key.N));
+	mod_size = ltc_mp.unsigned_size((void *)(ltc_key.key.N));
 
 	if (*sig_len < mod_size) {
 		*sig_len = mod_size;
@@ -506,7 +815,7 @@ TEE_Result crypto_acipher_rsassa_sign(uint32_t algo, struct rsa_keypair *key,
 
 	ltc_res = rsa_sign_hash_ex(msg, msg_len, sig, &ltc_sig_len,
 				   ltc_rsa_algo, NULL, find_prng("prng_crypto"),
-				   ltc_hashindex, salt_len, &ltc_key);
+				   ltc_hashindex, salt_len, &ltc_key.key);
 
 	*sig_len = ltc_sig_len;
 
@@ -0,0 +1,6 @@
+srcs-y += chacha20poly1305_add_aad.c
+srcs-y += chacha20poly1305_decrypt.c
+srcs-y += chacha20poly1305_done.c
+srcs-y += chacha20poly1305_encrypt.c
+srcs-y += chacha20poly1305_init.c
+srcs-y += chacha20poly1305_setiv.c
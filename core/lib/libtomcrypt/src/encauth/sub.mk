@@ -1,2 +1,3 @@
 subdirs-$(_CFG_CORE_LTC_CCM) += ccm
+subdirs-$(_CFG_CORE_LTC_CHACHA20_POLY1305) += chachapoly
 subdirs-$(_CFG_CORE_LTC_GCM) += gcm
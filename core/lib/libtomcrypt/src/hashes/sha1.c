@@ -8,6 +8,15 @@
  * guarantee it works.
  */
 #include "tomcrypt_private.h"
+#ifdef _CFG_CORE_LTC_SHA1_ACCEL
+#include <crypto/crypto_accel.h>
+
+/*
+ * The portable compress function is only used if the CPU lacks the
+ * instructions needed by crypto_accel_sha1_compress()
+ */
+#define sha1_compress sha1_sw_compress
+#endif
 
 /**
   @file sha1.c
@@ -156,6 +165,32 @@ static int sha1_compress(hash_state *md, const unsigned char *buf)
 }
 #endif
 
+#ifdef _CFG_CORE_LTC_SHA1_ACCEL
+#undef sha1_compress
+
+static int sha1_compress_nblocks(hash_state *md, const unsigned char *buf,
+                                 int blocks)
+{
+    void *state = md->sha1.state;
+    int i;
+
+    COMPILE_TIME_ASSERT(sizeof(md->sha1.state[0]) == sizeof(uint32_t));
+
+    if (!crypto_accel_sha1_compress(state, buf, blocks))
+       return CRYPT_OK;
+
+    for (i = 0; i < blocks; i++) {
+       sha1_sw_compress(md, buf + i * 64);
+    }
+    return CRYPT_OK;
+}
+
+static int sha1_compress(hash_state *md, const unsigned char *buf)
+{
+    return sha1_compress_nblocks(md, buf, 1);
+}
+#endif
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -181,7 +216,11 @@ int sha1_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
+#ifdef _CFG_CORE_LTC_SHA1_ACCEL
+HASH_PROCESS_NBLOCKS(sha1_process, sha1_compress_nblocks, sha1, 64)
+#else
 HASH_PROCESS(sha1_process, sha1_compress, sha1, 64)
+#endif
 
 /**
    Terminate the hash to get the digest
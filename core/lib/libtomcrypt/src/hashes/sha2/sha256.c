@@ -8,6 +8,15 @@
  * guarantee it works.
  */
 #include "tomcrypt_private.h"
+#ifdef _CFG_CORE_LTC_SHA256_ACCEL
+#include <crypto/crypto_accel.h>
+
+/*
+ * The portable compress function is only used if the CPU lacks the
+ * instructions needed by crypto_accel_sha256_compress()
+ */
+#define sha256_compress sha256_sw_compress
+#endif
 
 /**
   @file sha256.c
@@ -197,6 +206,32 @@ static int sha256_compress(hash_state * md, const unsigned char *buf)
 }
 #endif
 
+#ifdef _CFG_CORE_LTC_SHA256_ACCEL
+#undef sha256_compress
+
+static int sha256_compress_nblocks(hash_state *md, const unsigned char *buf,
+                                   int blocks)
+{
+    void *state = md->sha256.state;
+    int i;
+
+    COMPILE_TIME_ASSERT(sizeof(md->sha256.state[0]) == sizeof(uint32_t));
+
+    if (!crypto_accel_sha256_compress(state, buf, blocks))
+       return CRYPT_OK;
+
+    for (i = 0; i < blocks; i++) {
+       sha256_sw_compress(md, buf + i * 64);
+    }
+    return CRYPT_OK;
+}
+
+static int sha256_compress(hash_state *md, const unsigned char *buf)
+{
+    return sha256_compress_nblocks(md, buf, 1);
+}
+#endif
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -226,7 +261,11 @@ int sha256_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
+#ifdef _CFG_CORE_LTC_SHA256_ACCEL
+HASH_PROCESS_NBLOCKS(sha256_process, sha256_compress_nblocks, sha256, 64)
+#else
 HASH_PROCESS(sha256_process, sha256_compress, sha256, 64)
+#endif
 
 /**
    Terminate the hash to get the digest
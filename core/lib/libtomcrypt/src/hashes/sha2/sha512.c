@@ -8,6 +8,15 @@
  * guarantee it works.
  */
 #include "tomcrypt_private.h"
+#ifdef _CFG_CORE_LTC_SHA512_ACCEL
+#include <crypto/crypto_accel.h>
+
+/*
+ * The portable compress function is only used if the CPU lacks the
+ * instructions needed by crypto_accel_sha512_compress()
+ */
+#define sha512_compress sha512_sw_compress
+#endif
 
 /**
    @param sha512.c
@@ -166,6 +175,32 @@ static int sha512_compress(hash_state * md, const unsigned char *buf)
 }
 #endif
 
+#ifdef _CFG_CORE_LTC_SHA512_ACCEL
+#undef sha512_compress
+
+static int sha512_compress_nblocks(hash_state *md, const unsigned char *buf,
+                                   int blocks)
+{
+    void *state = md->sha512.state;
+    int i;
+
+    COMPILE_TIME_ASSERT(sizeof(md->sha512.state[0]) == sizeof(uint64_t));
+
+    if (!crypto_accel_sha512_compress(state, buf, blocks))
+       return CRYPT_OK;
+
+    for (i = 0; i < blocks; i++) {
+       sha512_sw_compress(md, buf + i * 128);
+    }
+    return CRYPT_OK;
+}
+
+static int sha512_compress(hash_state *md, const unsigned char *buf)
+{
+    return sha512_compress_nblocks(md, buf, 1);
+}
+#endif
+
 /**
    Initialize the hash state
    @param md   The hash state you wish to initialize
@@ -194,7 +229,11 @@ int sha512_init(hash_state * md)
    @param inlen  The length of the data (octets)
    @return CRYPT_OK if successful
 */
+#ifdef _CFG_CORE_LTC_SHA512_ACCEL
+HASH_PROCESS_NBLOCKS(sha512_process, sha512_compress_nblocks, sha512, 128)
+#else
 HASH_PROCESS(sha512_process, sha512_compress, sha512, 128)
+#endif
 
 /**
    Terminate the hash to get the digest
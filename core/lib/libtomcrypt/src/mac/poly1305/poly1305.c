@@ -17,6 +17,77 @@
 
 #ifdef LTC_POLY1305
 
+#if defined(__SIZEOF_INT128__)
+/*
+ * With a 64x64 -> 128 bit multiplier (AArch64 MUL/UMULH for instance)
+ * the accumulator is better kept in base 2^64 while processing blocks,
+ * each block then only needs 5 multiplications instead of 25. The state
+ * is still stored in base 2^26 so that poly1305_done() can be shared with
+ * the 32-bit implementation.
+ */
+typedef unsigned __int128 poly1305_u128;
+
+/* internal only */
+static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
+{
+   const ulong64 hibit = (st->final) ? 0 : 1; /* 1 << 128 */
+   ulong64 r0, r1, s1;
+   ulong64 h0, h1, h2;
+   ulong64 m0, m1, c;
+   poly1305_u128 d0, d1, t;
+
+   /* convert r and h from base 2^26 to base 2^64 */
+   r0 = (ulong64)st->r[0] | ((ulong64)st->r[1] << 26) | ((ulong64)st->r[2] << 52);
+   r1 = ((ulong64)st->r[2] >> 12) | ((ulong64)st->r[3] << 14) | ((ulong64)st->r[4] << 40);
+   /* the low 2 bits of r1 are clamped so this is r1 * 5 / 4 */
+   s1 = r1 + (r1 >> 2);
+
+   t = (poly1305_u128)st->h[0] + ((poly1305_u128)st->h[1] << 26) + ((poly1305_u128)st->h[2] << 52);
+   h0 = (ulong64)t;
+   t = (t >> 64) + ((poly1305_u128)st->h[3] << 14) + ((poly1305_u128)st->h[4] << 40);
+   h1 = (ulong64)t;
+   h2 = (ulong64)(t >> 64);
+
+   while (inlen >= 16) {
+      /* h += in[i] */
+      LOAD64L(m0, in + 0);
+      LOAD64L(m1, in + 8);
+      t = (poly1305_u128)h0 + m0;
+      h0 = (ulong64)t;
+      t = (poly1305_u128)h1 + m1 + (ulong64)(t >> 64);
+      h1 = (ulong64)t;
+      h2 += (ulong64)(t >> 64) + hibit;
+
+      /* h *= r */
+      d0 = (poly1305_u128)h0 * r0 + (poly1305_u128)h1 * s1;
+      d1 = (poly1305_u128)h0 * r1 + (poly1305_u128)h1 * r0 + (poly1305_u128)h2 * s1;
+      h2 = h2 * r0;
+
+      /* (partial) h %= p */
+      h0 = (ulong64)d0;
+      d1 += (ulong64)(d0 >> 64);
+      h1 = (ulong64)d1;
+      h2 += (ulong64)(d1 >> 64);
+      c = (h2 >> 2) + (h2 & ~(ulong64)3);
+      h2 &= 3;
+      t = (poly1305_u128)h0 + c;
+      h0 = (ulong64)t;
+      t = (poly1305_u128)h1 + (ulong64)(t >> 64);
+      h1 = (ulong64)t;
+      h2 += (ulong64)(t >> 64);
+
+      in += 16;
+      inlen -= 16;
+   }
+
+   /* convert h back to base 2^26, h4 may exceed 26 bits by a few bits */
+   st->h[0] = (ulong32)h0 & 0x3ffffff;
+   st->h[1] = (ulong32)(h0 >> 26) & 0x3ffffff;
+   st->h[2] = (ulong32)((h0 >> 52) | (h1 << 12)) & 0x3ffffff;
+   st->h[3] = (ulong32)(h1 >> 14) & 0x3ffffff;
+   st->h[4] = (ulong32)((h1 >> 40) | (h2 << 24));
+}
+#else
 /* internal only */
 static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigned long inlen)
 {
@@ -79,6 +150,7 @@ static void _poly1305_block(poly1305_state *st, const unsigned char *in, unsigne
    st->h[3] = h3;
    st->h[4] = h4;
 }
+#endif
 
 /**
    Initialize an POLY1305 context.
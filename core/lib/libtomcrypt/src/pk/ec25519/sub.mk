@@ -0,0 +1 @@
+srcs-y += tweetnacl.c
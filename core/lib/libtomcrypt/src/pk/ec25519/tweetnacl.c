@@ -18,10 +18,40 @@ typedef unsigned char u8;
 typedef ulong32 u32;
 typedef ulong64 u64;
 typedef long64 i64;
-typedef i64 gf[16];
-
 static const u8
   _9[32] = {9};
+
+#if defined(__SIZEOF_INT128__)
+/*
+ * Field elements are held in radix 2^51 in five 64-bit limbs and the
+ * products are accumulated in 128 bits, which needs 10x fewer
+ * multiplications than the radix 2^16 representation below.
+ *
+ * The limbs are only loosely reduced: M() and S() expect input limbs
+ * below 2^54 and return limbs below 2^51 + 2^13. A() and Z() don't
+ * reduce at all, Z() adds 2p to the difference so the subtrahend must
+ * be the result of M() or S() (or a reduced constant).
+ */
+#define GF_LIMBS 5
+#define GF_MASK ((1ULL << 51) - 1)
+
+typedef unsigned __int128 u128;
+typedef u64 gf[GF_LIMBS];
+
+static const gf
+  gf0,
+  gf1 = {1},
+  _121665 = {121665},
+  D = {0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029, 0x739c663a03cbb, 0x52036cee2b6ff},
+  D2 = {0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff},
+  X = {0x62d608f25d51a, 0x412a4b4f6592a, 0x75b7171a4b31d, 0x1ff60527118fe, 0x216936d3cd6e5},
+  Y = {0x6666666666658, 0x4cccccccccccc, 0x1999999999999, 0x3333333333333, 0x6666666666666},
+  I = {0x61b274a0ea0b0, 0x0d5a5fc8f189d, 0x7ef5e9cbd0c60, 0x78595a6804c9e, 0x2b8324804fc1d};
+#else
+#define GF_LIMBS 16
+
+typedef i64 gf[GF_LIMBS];
+
 static const gf
   gf0,
   gf1 = {1},
@@ -31,6 +61,7 @@ static const gf
   X = {0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c, 0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169},
   Y = {0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666},
   I = {0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43, 0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83};
+#endif
 
 static int vn(const u8 *x,const u8 *y,int n)
 {
@@ -48,9 +79,124 @@ static int tweetnacl_crypto_verify_32(const u8 *x,const u8 *y)
 sv set25519(gf r, const gf a)
 {
   int i;
-  FOR(i,16) r[i]=a[i];
+  FOR(i,GF_LIMBS) r[i]=a[i];
+}
+
+sv A(gf o,const gf a,const gf b)
+{
+  int i;
+  FOR(i,GF_LIMBS) o[i]=a[i]+b[i];
 }
 
+#if defined(__SIZEOF_INT128__)
+sv car25519(gf o)
+{
+  int i;
+  u64 c;
+  FOR(i,4) {
+    c=o[i]>>51;
+    o[i]&=GF_MASK;
+    o[i+1]+=c;
+  }
+  c=o[4]>>51;
+  o[4]&=GF_MASK;
+  o[0]+=19*c;
+}
+
+sv sel25519(gf p,gf q,int b)
+{
+  int i;
+  u64 t,c=0-(u64)b;
+  FOR(i,GF_LIMBS) {
+    t= c&(p[i]^q[i]);
+    p[i]^=t;
+    q[i]^=t;
+  }
+}
+
+sv pack25519(u8 *o,const gf n)
+{
+  int i;
+  u64 c,w[4];
+  gf t;
+  set25519(t,n);
+  car25519(t);
+  car25519(t);
+  /* Now t < 2^255 + 19 < 2p, subtract p if t >= p */
+  c=(t[0]+19)>>51;
+  FOR(i,4) c=(t[i+1]+c)>>51;
+  t[0]+=19*c;
+  FOR(i,4) {
+    t[i+1]+=t[i]>>51;
+    t[i]&=GF_MASK;
+  }
+  t[4]&=GF_MASK;
+  w[0]=t[0]|(t[1]<<51);
+  w[1]=(t[1]>>13)|(t[2]<<38);
+  w[2]=(t[2]>>26)|(t[3]<<25);
+  w[3]=(t[3]>>39)|(t[4]<<12);
+  FOR(i,32) o[i]=w[i/8]>>(8*(i%8));
+}
+
+sv unpack25519(gf o, const u8 *n)
+{
+  int i;
+  u64 w[4]={0};
+  FOR(i,32) w[i/8]|=(u64)n[i]<<(8*(i%8));
+  o[0]=w[0]&GF_MASK;
+  o[1]=((w[0]>>51)|(w[1]<<13))&GF_MASK;
+  o[2]=((w[1]>>38)|(w[2]<<26))&GF_MASK;
+  o[3]=((w[2]>>25)|(w[3]<<39))&GF_MASK;
+  o[4]=(w[3]>>12)&GF_MASK;
+}
+
+sv Z(gf o,const gf a,const gf b)
+{
+  int i;
+  o[0]=a[0]+0xfffffffffffdaULL-b[0];
+  for(i=1;i<GF_LIMBS;i++) o[i]=a[i]+0xffffffffffffeULL-b[i];
+}
+
+/* Reduces the 128-bit column sums in t into o */
+sv red25519(gf o,u128 t[5])
+{
+  int i;
+  u64 c;
+  FOR(i,4) {
+    t[i+1]+=(u64)(t[i]>>51);
+    o[i]=(u64)t[i]&GF_MASK;
+  }
+  c=(u64)(t[4]>>51);
+  o[4]=(u64)t[4]&GF_MASK;
+  o[0]+=19*c;
+  o[1]+=o[0]>>51;
+  o[0]&=GF_MASK;
+}
+
+sv M(gf o,const gf a,const gf b)
+{
+  u128 t[5];
+  u64 b1=19*b[1],b2=19*b[2],b3=19*b[3],b4=19*b[4];
+  t[0]=(u128)a[0]*b[0]+(u128)a[1]*b4+(u128)a[2]*b3+(u128)a[3]*b2+(u128)a[4]*b1;
+  t[1]=(u128)a[0]*b[1]+(u128)a[1]*b[0]+(u128)a[2]*b4+(u128)a[3]*b3+(u128)a[4]*b2;
+  t[2]=(u128)a[0]*b[2]+(u128)a[1]*b[1]+(u128)a[2]*b[0]+(u128)a[3]*b4+(u128)a[4]*b3;
+  t[3]=(u128)a[0]*b[3]+(u128)a[1]*b[2]+(u128)a[2]*b[1]+(u128)a[3]*b[0]+(u128)a[4]*b4;
+  t[4]=(u128)a[0]*b[4]+(u128)a[1]*b[3]+(u128)a[2]*b[2]+(u128)a[3]*b[1]+(u128)a[4]*b[0];
+  red25519(o,t);
+}
+
+sv S(gf o,const gf a)
+{
+  u128 t[5];
+  u64 a0=2*a[0],a1=2*a[1],a2=2*a[2],a3=19*a[3],a4=19*a[4];
+  t[0]=(u128)a[0]*a[0]+(u128)a1*a4+(u128)a2*a3;
+  t[1]=(u128)a0*a[1]+(u128)a2*a4+(u128)a[3]*a3;
+  t[2]=(u128)a0*a[2]+(u128)a[1]*a[1]+(u128)(2*a[3])*a4;
+  t[3]=(u128)a0*a[3]+(u128)a1*a[2]+(u128)a[4]*a4;
+  t[4]=(u128)a0*a[4]+(u128)a1*a[3]+(u128)a[2]*a[2];
+  red25519(o,t);
+}
+#else
 sv car25519(gf o)
 {
   int i;
@@ -98,21 +244,6 @@ sv pack25519(u8 *o,const gf n)
   }
 }
 
-static int neq25519(const gf a, const gf b)
-{
-  u8 c[32],d[32];
-  pack25519(c,a);
-  pack25519(d,b);
-  return tweetnacl_crypto_verify_32(c,d);
-}
-
-static u8 par25519(const gf a)
-{
-  u8 d[32];
-  pack25519(d,a);
-  return d[0]&1;
-}
-
 sv unpack25519(gf o, const u8 *n)
 {
   int i;
@@ -120,12 +251,6 @@ sv unpack25519(gf o, const u8 *n)
   o[15]&=0x7fff;
 }
 
-sv A(gf o,const gf a,const gf b)
-{
-  int i;
-  FOR(i,16) o[i]=a[i]+b[i];
-}
-
 sv Z(gf o,const gf a,const gf b)
 {
   int i;
@@ -147,45 +272,92 @@ sv S(gf o,const gf a)
 {
   M(o,a,a);
 }
+#endif
+
+static int neq25519(const gf a, const gf b)
+{
+  u8 c[32],d[32];
+  pack25519(c,a);
+  pack25519(d,b);
+  return tweetnacl_crypto_verify_32(c,d);
+}
+
+static u8 par25519(const gf a)
+{
+  u8 d[32];
+  pack25519(d,a);
+  return d[0]&1;
+}
 
+/* o = a^(2^n) */
+sv nsq25519(gf o,const gf a,int n)
+{
+  int i;
+  S(o,a);
+  for(i=1;i<n;i++) S(o,o);
+}
+
+/*
+ * Computes i^(2^250 - 1) and i^11, the common part of the addition chains
+ * used by inv25519() and pow2523(). These need 11 multiplications where
+ * square-and-multiply needs about 250.
+ */
+sv pow22501(gf o,gf z11,const gf i)
+{
+  gf z2,t0,t1,t2;
+  S(z2,i);
+  nsq25519(t0,z2,2);
+  M(t0,t0,i);
+  M(z11,t0,z2);
+  S(t1,z11);
+  M(t0,t1,t0);
+  nsq25519(t1,t0,5);
+  M(t0,t1,t0);
+  nsq25519(t1,t0,10);
+  M(t1,t1,t0);
+  nsq25519(t2,t1,20);
+  M(t1,t2,t1);
+  nsq25519(t1,t1,10);
+  M(t0,t1,t0);
+  nsq25519(t1,t0,50);
+  M(t1,t1,t0);
+  nsq25519(t2,t1,100);
+  M(t1,t2,t1);
+  nsq25519(t1,t1,50);
+  M(o,t1,t0);
+}
+
+/* o = i^(p - 2) = i^(2^255 - 21) */
 sv inv25519(gf o,const gf i)
 {
-  gf c;
-  int a;
-  FOR(a,16) c[a]=i[a];
-  for(a=253;a>=0;a--) {
-    S(c,c);
-    if(a!=2&&a!=4) M(c,c,i);
-  }
-  FOR(a,16) o[a]=c[a];
+  gf t,z11;
+  pow22501(t,z11,i);
+  nsq25519(t,t,5);
+  M(o,t,z11);
 }
 
+/* o = i^((p - 5) / 8) = i^(2^252 - 3) */
 sv pow2523(gf o,const gf i)
 {
-  gf c;
-  int a;
-  FOR(a,16) c[a]=i[a];
-  for(a=250;a>=0;a--) {
-    S(c,c);
-    if(a!=1) M(c,c,i);
-  }
-  FOR(a,16) o[a]=c[a];
+  gf t,z11;
+  pow22501(t,z11,i);
+  nsq25519(t,t,2);
+  M(o,t,i);
 }
 
 int tweetnacl_crypto_scalarmult(u8 *q,const u8 *n,const u8 *p)
 {
   u8 z[32];
-  i64 x[80],r,i;
-  gf a,b,c,d,e,f;
+  int r,i;
+  gf x,a,b,c,d,e,f;
   FOR(i,31) z[i]=n[i];
   z[31]=(n[31]&127)|64;
   z[0]&=248;
   unpack25519(x,p);
-  FOR(i,16) {
-    b[i]=x[i];
-    d[i]=a[i]=c[i]=0;
-  }
-  a[0]=d[0]=1;
+  set25519(a,gf1);
+  set25519(b,x);
+  set25519(c,gf0);
+  set25519(d,gf1);
   for(i=254;i>=0;--i) {
     r=(z[i>>3]>>(i&7))&1;
     sel25519(a,b,r);
@@ -211,15 +383,10 @@ int tweetnacl_crypto_scalarmult(u8 *q,const u8 *n,const u8 *p)
     sel25519(a,b,r);
     sel25519(c,d,r);
   }
-  FOR(i,16) {
-    x[i+16]=a[i];
-    x[i+32]=c[i];
-    x[i+48]=b[i];
-    x[i+64]=d[i];
-  }
-  inv25519(x+32,x+32);
-  M(x+16,x+16,x+32);
-  pack25519(q,x+16);
+  inv25519(c,c);
+  M(a,a,c);
+  pack25519(q,a);
+  zeromem(z, sizeof(z));
   return 0;
 }
 
@@ -267,6 +434,31 @@ sv add(gf p[4],gf q[4])
   M(p[3], e, h);
 }
 
+/*
+ * Dedicated doubling for a = -1 in extended coordinates, 4M + 4S instead
+ * of the 9M of add(p,p). T isn't used on input.
+ */
+sv dbl(gf p[4])
+{
+  gf a,b,c,e,f,g,h;
+
+  S(a, p[0]);
+  S(b, p[1]);
+  S(c, p[2]);
+  A(c, c, c);
+  A(h, a, b);
+  A(e, p[0], p[1]);
+  S(e, e);
+  Z(e, h, e);
+  Z(g, a, b);
+  A(f, g, c);
+
+  M(p[0], e, f);
+  M(p[1], g, h);
+  M(p[2], f, g);
+  M(p[3], e, h);
+}
+
 sv cswap(gf p[4],gf q[4],u8 b)
 {
   int i;
@@ -295,7 +487,7 @@ sv scalarmult(gf p[4],gf q[4],const u8 *s)
     u8 b = (s[i/8]>>(i&7))&1;
     cswap(p,q,b);
     add(q,p);
-    add(p,p);
+    dbl(p);
     cswap(p,q,b);
   }
 }
@@ -14,6 +14,9 @@
  */
 
 #include "tomcrypt_private.h"
+#ifdef _CFG_CORE_LTC_CHACHA20_ACCEL
+#include <crypto/crypto_accel.h>
+#endif
 
 #ifdef LTC_CHACHA
 
@@ -72,6 +75,23 @@ int chacha_crypt(chacha_state *st, const unsigned char *in, unsigned long inlen,
       out += j;
       in  += j;
    }
+#ifdef _CFG_CORE_LTC_CHACHA20_ACCEL
+   if (inlen >= 64) {
+     /*
+      * Whole blocks are handled by the accelerated implementation as
+      * long as the low word of the counter doesn't wrap, anything else
+      * is left to the loop below.
+      */
+     j = MIN(inlen / 64, (unsigned long)(0xFFFFFFFFUL - st->input[12]));
+     if (j > 0) {
+       crypto_accel_chacha_xor(st->input, out, in, j, st->rounds);
+       inlen -= j * 64;
+       if (inlen == 0) return CRYPT_OK;
+       out += j * 64;
+       in  += j * 64;
+     }
+   }
+#endif
    for (;;) {
      _chacha_block(buf, st->input, st->rounds);
      if (st->ivlen == 8) {
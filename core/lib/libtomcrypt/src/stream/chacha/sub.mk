@@ -0,0 +1,6 @@
+srcs-y += chacha_crypt.c
+srcs-y += chacha_done.c
+srcs-y += chacha_ivctr32.c
+srcs-y += chacha_ivctr64.c
+srcs-y += chacha_keystream.c
+srcs-y += chacha_setup.c
@@ -0,0 +1 @@
+subdirs-y += chacha
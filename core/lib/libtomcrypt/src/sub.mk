@@ -5,4 +5,7 @@ subdirs-$(_CFG_CORE_LTC_MAC) += mac
 subdirs-$(_CFG_CORE_LTC_ACIPHER) += math
 subdirs-y += misc
 subdirs-y += modes
-subdirs-$(_CFG_CORE_LTC_ACIPHER) += pk
+ifneq (,$(filter y,$(_CFG_CORE_LTC_ACIPHER) $(_CFG_CORE_LTC_CURVE25519)))
+subdirs-y += pk
+endif
+subdirs-$(_CFG_CORE_LTC_CHACHA20_POLY1305) += stream
@@ -70,6 +70,10 @@ endif
 ifeq ($(_CFG_CORE_LTC_GCM),y)
 	cppflags-lib-y += -DLTC_GCM_MODE
 endif
+ifeq ($(_CFG_CORE_LTC_CHACHA20_POLY1305),y)
+	cppflags-lib-y += -DLTC_CHACHA -DLTC_POLY1305
+	cppflags-lib-y += -DLTC_CHACHA20POLY1305_MODE
+endif
 
 cppflags-lib-y += -DLTC_NO_PK
 
@@ -100,6 +104,9 @@ endif
 ifneq (,$(filter y,$(_CFG_CORE_LTC_SM2_DSA) $(_CFG_CORE_LTC_SM2_PKE)))
    cppflags-lib-y += -DLTC_ECC_SM2
 endif
+ifeq ($(_CFG_CORE_LTC_CURVE25519),y)
+   cppflags-lib-y += -DLTC_CURVE25519
+endif
 
 cppflags-lib-y += -DLTC_NO_PKCS
 
@@ -120,19 +127,19 @@ srcs-$(_CFG_CORE_LTC_CTR) += ctr.c
 srcs-$(_CFG_CORE_LTC_XTS) += xts.c
 srcs-$(_CFG_CORE_LTC_CCM) += ccm.c
 srcs-$(_CFG_CORE_LTC_GCM) += gcm.c
+srcs-$(_CFG_CORE_LTC_CHACHA20_POLY1305) += chachapoly.c
 srcs-$(_CFG_CORE_LTC_DSA) += dsa.c
 srcs-$(_CFG_CORE_LTC_ECC) += ecc.c
+srcs-$(_CFG_CORE_LTC_ECC_FIXED_BASE) += ecc_comb.c
 srcs-$(_CFG_CORE_LTC_RSA) += rsa.c
 srcs-$(_CFG_CORE_LTC_DH) += dh.c
 srcs-$(_CFG_CORE_LTC_AES) += aes.c
 srcs-$(_CFG_CORE_LTC_AES_ACCEL) += aes_accel.c
-srcs-$(_CFG_CORE_LTC_SHA1_ACCEL) += sha1_accel.c
-ifeq ($(_CFG_CORE_LTC_SHA256_DESC),y)
-srcs-$(_CFG_CORE_LTC_SHA256_ACCEL) += sha256_accel.c
-endif
 srcs-$(_CFG_CORE_LTC_SM2_DSA) += sm2-dsa.c
 srcs-$(_CFG_CORE_LTC_SM2_PKE) += sm2-pke.c
 srcs-$(_CFG_CORE_LTC_SM2_KEP) += sm2-kep.c
+srcs-$(_CFG_CORE_LTC_X25519) += x25519.c
+srcs-$(_CFG_CORE_LTC_ED25519) += ed25519.c
 
 ifeq ($(_CFG_CORE_LTC_ACIPHER),y)
 srcs-y += mpi_desc.c
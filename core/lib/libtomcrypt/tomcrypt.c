@@ -4,6 +4,7 @@
  */
 
 #include <crypto/crypto.h>
+#include <crypto/crypto_accel.h>
 #include <tee_api_types.h>
 #include <tee_api_defines.h>
 #include <tomcrypt_private.h>
@@ -93,7 +94,12 @@ static const struct ltc_prng_descriptor prng_crypto_desc = {
 static void tee_ltc_reg_algs(void)
 {
 #if defined(_CFG_CORE_LTC_AES) || defined(_CFG_CORE_LTC_AES_DESC)
-	register_cipher(&aes_desc);
+#if defined(_CFG_CORE_LTC_AES_ACCEL)
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		register_cipher(&aes_accel_desc);
+	else
+#endif
+		register_cipher(&aes_desc);
 #endif
 #if defined(_CFG_CORE_LTC_DES)
 	register_cipher(&des_desc);
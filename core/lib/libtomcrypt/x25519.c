@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tee_api_types.h>
+#include <utee_defines.h>
+
+#include "acipher_helpers.h"
+
+/* X25519 key is an octet string of 256 bits */
+#define X25519_KEY_SIZE		256
+#define X25519_KEY_SIZE_BYTES	UL(32)
+
+TEE_Result crypto_acipher_alloc_x25519_keypair(struct x25519_keypair *key,
+					       size_t key_size)
+{
+	if (!key || key_size != X25519_KEY_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	memset(key, 0, sizeof(*key));
+
+	key->priv = calloc(1, X25519_KEY_SIZE_BYTES);
+	if (!key->priv)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	key->pub = calloc(1, X25519_KEY_SIZE_BYTES);
+	if (!key->pub) {
+		free(key->priv);
+		key->priv = NULL;
+		return TEE_ERROR_OUT_OF_MEMORY;
+	}
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result crypto_acipher_gen_x25519_key(struct x25519_keypair *key,
+					 size_t key_size)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+	curve25519_key ltc_key = { };
+	uint8_t priv[X25519_KEY_SIZE_BYTES] = { };
+
+	if (key_size != X25519_KEY_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* Any 32 bytes is a valid private key, the scalar is clamped on use */
+	res = crypto_rng_read(priv, sizeof(priv));
+	if (res)
+		return res;
+
+	if (x25519_set_key(priv, sizeof(priv), NULL, 0, &ltc_key) != CRYPT_OK) {
+		res = TEE_ERROR_BAD_PARAMETERS;
+		goto out;
+	}
+
+	memcpy(key->priv, ltc_key.priv, X25519_KEY_SIZE_BYTES);
+	memcpy(key->pub, ltc_key.pub, X25519_KEY_SIZE_BYTES);
+out:
+	memzero_explicit(priv, sizeof(priv));
+	memzero_explicit(&ltc_key, sizeof(ltc_key));
+
+	return res;
+}
+
+TEE_Result crypto_acipher_x25519_shared_secret(struct x25519_keypair
+					       *private_key,
+					       const void *public_key,
+					       void *secret,
+					       unsigned long *secret_len)
+{
+	TEE_Result res = TEE_SUCCESS;
+	curve25519_key ltc_private_key = {
+		.type = PK_PRIVATE,
+		.algo = PKA_X25519,
+	};
+	curve25519_key ltc_public_key = {
+		.type = PK_PUBLIC,
+		.algo = PKA_X25519,
+	};
+
+	if (!private_key || !public_key || !secret || !secret_len)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/*
+	 * The public part of the private key isn't used, so the LTC key is
+	 * set up directly instead of with x25519_set_key() which would
+	 * derive it again.
+	 */
+	memcpy(ltc_private_key.priv, private_key->priv,
+	       sizeof(ltc_private_key.priv));
+	memcpy(ltc_public_key.pub, public_key, sizeof(ltc_public_key.pub));
+
+	if (x25519_shared_secret(&ltc_private_key, &ltc_public_key, secret,
+				 secret_len) != CRYPT_OK)
+		res = TEE_ERROR_BAD_PARAMETERS;
+
+	memzero_explicit(&ltc_private_key, sizeof(ltc_private_key));
+
+	return res;
+}
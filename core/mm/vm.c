@@ -919,6 +919,36 @@ static int cmp_param_mem(const void *a0, const void *a1)
 	return CMP_TRILEAN(m0->size, m1->size);
 }
 
+/*
+ * Returns true if @mem, a merged parameter mapping, covers a memory
+ * reference parameter the TA is allowed to write to.
+ */
+static bool param_mem_is_writable(struct tee_ta_param *param,
+				  struct param_mem *mem)
+{
+	size_t n = 0;
+
+	for (n = 0; n < TEE_NUM_PARAMS; n++) {
+		uint32_t param_type = TEE_PARAM_TYPE_GET(param->types, n);
+		size_t offs = 0;
+
+		if (param_type != TEE_PARAM_TYPE_MEMREF_OUTPUT &&
+		    param_type != TEE_PARAM_TYPE_MEMREF_INOUT)
+			continue;
+		if (param->u[n].mem.mobj != mem->mobj)
+			continue;
+
+		offs = mobj_get_phys_offs(mem->mobj,
+					  CORE_MMU_USER_PARAM_SIZE) +
+		       param->u[n].mem.offs;
+		if (core_is_buffer_intersect(mem->offs, mem->size, offs,
+					     MAX(param->u[n].mem.size, 1UL)))
+			return true;
+	}
+
+	return false;
+}
+
 TEE_Result vm_map_param(struct user_mode_ctx *uctx, struct tee_ta_param *param,
 			void *param_va[TEE_NUM_PARAMS])
 {
@@ -985,10 +1015,18 @@ TEE_Result vm_map_param(struct user_mode_ctx *uctx, struct tee_ta_param *param,
 	check_param_map_empty(uctx);
 
 	for (n = 0; n < m; n++) {
+		uint32_t prot = TEE_MATTR_PRW | TEE_MATTR_URW;
 		vaddr_t va = 0;
 
-		res = vm_map(uctx, &va, mem[n].size,
-			     TEE_MATTR_PRW | TEE_MATTR_URW,
+		/*
+		 * The TA may only read input-only memrefs. Non-secure
+		 * memory can still be changed by normal world at any time.
+		 */
+		if (IS_ENABLED(CFG_USER_TA_MAP_INPUT_RO) &&
+		    !param_mem_is_writable(param, mem + n))
+			prot = TEE_MATTR_PR | TEE_MATTR_UR;
+
+		res = vm_map(uctx, &va, mem[n].size, prot,
 			     VM_FLAG_EPHEMERAL | VM_FLAG_SHAREABLE,
 			     mem[n].mobj, mem[n].offs);
 		if (res)
@@ -3,14 +3,20 @@
  * Copyright (c) 2015, Linaro Limited
  */
 #include <compiler.h>
+#ifdef CFG_CRYPTO_DRV_BALANCE
+#include <drvcrypt_balance.h>
+#endif
 #include <stdio.h>
 #include <trace.h>
 #include <kernel/pseudo_ta.h>
+#include <mm/mobj.h>
 #include <mm/tee_pager.h>
 #include <mm/tee_mm.h>
 #include <string.h>
 #include <string_ext.h>
 #include <malloc.h>
+#include <tee/tee_svc.h>
+#include <util.h>
 
 #define TA_NAME		"stats.ta"
 
@@ -21,6 +27,9 @@
 #define STATS_CMD_PAGER_STATS		0
 #define STATS_CMD_ALLOC_STATS		1
 #define STATS_CMD_MEMLEAK_STATS		2
+#define STATS_CMD_SHM_STATS		3
+#define STATS_CMD_PARAM_COPY_STATS	4
+#define STATS_CMD_CRYPTO_BALANCE_STATS	5
 
 #define STATS_NB_POOLS			4
 
@@ -137,6 +146,96 @@ static TEE_Result get_memleak_stats(uint32_t type,
 	return TEE_SUCCESS;
 }
 
+#if defined(CFG_CORE_DYN_SHM) && !defined(CFG_CORE_FFA)
+static TEE_Result get_shm_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct mobj_reg_shm_stats stats = { };
+
+	/*
+	 * p[0].value.a = number of registered shared memory maps
+	 * p[0].value.b = number of registered shared memory unmaps
+	 * p[1].value.a = number of maps served from the mapping cache
+	 * p[1].value.b = number of unused mappings currently cached
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mobj_reg_shm_get_stats(&stats);
+	p[0].value.a = stats.map_count;
+	p[0].value.b = stats.unmap_count;
+	p[1].value.a = stats.map_cache_hits;
+	p[1].value.b = stats.map_cache_count;
+
+	return TEE_SUCCESS;
+}
+#endif
+
+#ifdef CFG_WITH_USER_TA
+static TEE_Result get_param_copy_stats(uint32_t type,
+				       TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct tee_svc_param_copy_stats stats = { };
+
+	/*
+	 * p[0].value.a = number of TA to TA requests
+	 * p[0].value.b = number of those requests using a bounce buffer
+	 * p[1].value.a-b = bytes copied into bounce buffers (high, low)
+	 * p[2].value.a-b = bytes copied back from bounce buffers (high, low)
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	tee_svc_get_param_copy_stats(&stats);
+	p[0].value.a = stats.num_requests;
+	p[0].value.b = stats.num_copied;
+	reg_pair_from_64(stats.bytes_in, &p[1].value.a, &p[1].value.b);
+	reg_pair_from_64(stats.bytes_out, &p[2].value.a, &p[2].value.b);
+
+	return TEE_SUCCESS;
+}
+#endif
+
+#ifdef CFG_CRYPTO_DRV_BALANCE
+static TEE_Result get_crypto_balance_stats(uint32_t type,
+					   TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct drvcrypt_balance_stats stats = { };
+	TEE_Result res = TEE_SUCCESS;
+
+	/*
+	 * p[0].value.a = [in] class: 0 hash, 1 cipher, 2 MAC, 3 authenc
+	 * p[0].value.b = requests moved to software while the driver was busy
+	 * p[1].value.a = requests processed by the driver
+	 * p[1].value.b = requests processed in software
+	 * p[2].value.a-b = bytes processed by the driver (high, low)
+	 * p[3].value.a-b = bytes processed in software (high, low)
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INOUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = drvcrypt_balance_get_stats(p[0].value.a, &stats);
+	if (res)
+		return res;
+
+	p[0].value.b = stats.busy_count;
+	p[1].value.a = MIN(stats.hw_requests, (uint64_t)UINT32_MAX);
+	p[1].value.b = MIN(stats.sw_requests, (uint64_t)UINT32_MAX);
+	reg_pair_from_64(stats.hw_bytes, &p[2].value.a, &p[2].value.b);
+	reg_pair_from_64(stats.sw_bytes, &p[3].value.a, &p[3].value.b);
+
+	return TEE_SUCCESS;
+}
+#endif
+
 /*
  * Trusted Application Entry Points
  */
@@ -152,6 +251,18 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_alloc_stats(ptypes, params);
 	case STATS_CMD_MEMLEAK_STATS:
 		return get_memleak_stats(ptypes, params);
+#if defined(CFG_CORE_DYN_SHM) && !defined(CFG_CORE_FFA)
+	case STATS_CMD_SHM_STATS:
+		return get_shm_stats(ptypes, params);
+#endif
+#ifdef CFG_WITH_USER_TA
+	case STATS_CMD_PARAM_COPY_STATS:
+		return get_param_copy_stats(ptypes, params);
+#endif
+#ifdef CFG_CRYPTO_DRV_BALANCE
+	case STATS_CMD_CRYPTO_BALANCE_STATS:
+		return get_crypto_balance_stats(ptypes, params);
+#endif
 	default:
 		break;
 	}
@@ -42,7 +42,7 @@ static uint8_t aes_iv[] = {
 
 static void free_ctx(void **ctx, uint32_t algo)
 {
-	if (algo == TEE_ALG_AES_GCM)
+	if (TEE_ALG_GET_CLASS(algo) == TEE_OPERATION_AE)
 		crypto_authenc_free_ctx(*ctx);
 	else
 		crypto_cipher_free_ctx(*ctx);
@@ -78,6 +78,7 @@ static TEE_Result init_ctx(void **ctx, uint32_t algo, TEE_OperationMode mode,
 		res = crypto_cipher_alloc_ctx(ctx, algo);
 		break;
 	case TEE_ALG_AES_GCM:
+	case TEE_ALG_CHACHA20_POLY1305:
 		res = crypto_authenc_alloc_ctx(ctx, algo);
 		break;
 	default:
@@ -103,6 +104,11 @@ static TEE_Result init_ctx(void **ctx, uint32_t algo, TEE_OperationMode mode,
 					  sizeof(aes_iv), TEE_AES_BLOCK_SIZE,
 					  0, payload_len);
 		break;
+	case TEE_ALG_CHACHA20_POLY1305:
+		/* The first 96 bits of the AES IV are used as nonce */
+		res = crypto_authenc_init(*ctx, mode, aes_key, key_len, aes_iv,
+					  12, 16, 0, payload_len);
+		break;
 	default:
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
@@ -138,7 +144,7 @@ static TEE_Result do_update(void *ctx, uint32_t algo, TEE_OperationMode mode,
 	unsigned int n = 0;
 	unsigned int m = 0;
 
-	if (algo == TEE_ALG_AES_GCM)
+	if (TEE_ALG_GET_CLASS(algo) == TEE_OPERATION_AE)
 		update_func = update_ae;
 	else
 		update_func = update_cipher;
@@ -192,6 +198,9 @@ TEE_Result core_aes_perf_tests(uint32_t param_types,
 	case PTA_INVOKE_TESTS_AES_GCM:
 		algo = TEE_ALG_AES_GCM;
 		break;
+	case PTA_INVOKE_TESTS_CHACHA20_POLY1305:
+		algo = TEE_ALG_CHACHA20_POLY1305;
+		break;
 	default:
 		return TEE_ERROR_BAD_PARAMETERS;
 	}
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+/* Stands in for the digest of the message, the value doesn't matter */
+static const uint8_t ecc_digest[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+	0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F
+};
+
+static TEE_Result run_ecdsa(uint32_t algo, struct ecc_keypair *key,
+			    struct ecc_public_key *pub_key, bool verify,
+			    unsigned int rep_count, uint32_t *ops_per_sec)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t digest_len = key->curve == TEE_ECC_CURVE_NIST_P256 ? 32 : 48;
+	uint8_t sig[2 * 48] = { };
+	size_t sig_len = sizeof(sig);
+	TEE_Time start = { };
+	unsigned int n = 0;
+
+	/* Untimed first round, computes the tables if they're needed */
+	res = crypto_acipher_ecc_sign(algo, key, ecc_digest, digest_len, sig,
+				      &sig_len);
+	if (!res && verify)
+		res = crypto_acipher_ecc_verify(algo, pub_key, ecc_digest,
+						digest_len, sig, sig_len);
+	if (res)
+		return res;
+
+	res = tee_time_get_sys_time(&start);
+	if (res)
+		return res;
+
+	for (n = 0; n < rep_count; n++) {
+		if (verify) {
+			res = crypto_acipher_ecc_verify(algo, pub_key,
+							ecc_digest, digest_len,
+							sig, sig_len);
+		} else {
+			sig_len = sizeof(sig);
+			res = crypto_acipher_ecc_sign(algo, key, ecc_digest,
+						      digest_len, sig,
+						      &sig_len);
+		}
+		if (res)
+			return res;
+	}
+
+	*ops_per_sec = perf_rate(rep_count, perf_elapsed_ms(&start));
+	return TEE_SUCCESS;
+}
+
+TEE_Result core_ecc_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	struct ecc_public_key pub_key = { };
+	struct ecc_keypair key = { };
+	unsigned int rep_count = 0;
+	size_t key_size_bits = 0;
+	bool precomp = false;
+	uint32_t algo = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	switch (params[0].value.a) {
+	case TEE_ECC_CURVE_NIST_P256:
+		algo = TEE_ALG_ECDSA_P256;
+		key_size_bits = 256;
+		break;
+	case TEE_ECC_CURVE_NIST_P384:
+		algo = TEE_ALG_ECDSA_P384;
+		key_size_bits = 384;
+		break;
+	default:
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+	rep_count = params[0].value.b;
+
+	res = crypto_acipher_alloc_ecc_keypair(&key, TEE_TYPE_ECDSA_KEYPAIR,
+					       key_size_bits);
+	if (res)
+		return res;
+	res = crypto_acipher_alloc_ecc_public_key(&pub_key,
+						  TEE_TYPE_ECDSA_PUBLIC_KEY,
+						  key_size_bits);
+	if (res)
+		goto out;
+
+	key.curve = params[0].value.a;
+	res = crypto_acipher_gen_ecc_key(&key, key_size_bits);
+	if (res)
+		goto out;
+	pub_key.curve = key.curve;
+	crypto_bignum_copy(pub_key.x, key.x);
+	crypto_bignum_copy(pub_key.y, key.y);
+
+	precomp = crypto_acipher_ecc_precomp_enable(false);
+	res = run_ecdsa(algo, &key, &pub_key, false, rep_count,
+			&params[1].value.a);
+	if (!res)
+		res = run_ecdsa(algo, &key, &pub_key, true, rep_count,
+				&params[2].value.a);
+	crypto_acipher_ecc_precomp_enable(true);
+	if (!res)
+		res = run_ecdsa(algo, &key, &pub_key, false, rep_count,
+				&params[1].value.b);
+	if (!res)
+		res = run_ecdsa(algo, &key, &pub_key, true, rep_count,
+				&params[2].value.b);
+	crypto_acipher_ecc_precomp_enable(precomp);
+
+	DMSG("ECDSA sign %"PRIu32" -> %"PRIu32" ops/s, verify %"PRIu32
+	     " -> %"PRIu32" ops/s", params[1].value.a, params[1].value.b,
+	     params[2].value.a, params[2].value.b);
+out:
+	crypto_bignum_free(key.d);
+	crypto_bignum_free(key.x);
+	crypto_bignum_free(key.y);
+	if (pub_key.ops)
+		crypto_acipher_free_ecc_public_key(&pub_key);
+	return res;
+}
@@ -432,6 +432,16 @@ static TEE_Result invoke_command(void *pSessionContext __unused,
 		return core_lockdep_tests(nParamTypes, pParams);
 	case PTA_INVOKE_TEST_CMD_AES_PERF:
 		return core_aes_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_SM_PERF:
+		return core_sm_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_ECC_PERF:
+		return core_ecc_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_RNG_PERF:
+		return core_rng_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_PBKDF2_PERF:
+		return core_pbkdf2_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_MPI_PERF:
+		return core_mpi_perf_tests(nParamTypes, pParams);
 	default:
 		break;
 	}
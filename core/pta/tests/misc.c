@@ -3,11 +3,17 @@
  * Copyright (c) 2014, STMicroelectronics International N.V.
  */
 #include <assert.h>
+#include <crypto/crypto.h>
 #include <malloc.h>
 #include <stdbool.h>
+#include <string.h>
 #include <trace.h>
 #include <kernel/panic.h>
+#include <mbedtls/bignum.h>
+#include <mempool.h>
+#include <tee/tee_cryp_pbkdf2.h>
 #include <util.h>
+#include <utee_defines.h>
 
 #include "misc.h"
 
@@ -548,14 +554,972 @@ static int self_test_nex_malloc(void)
 	return 0;
 }
 #endif
+
+#ifdef CFG_CRYPTO_SHA512
+/*
+ * Known answer tests for SHA-512, the second one is fed in chunks spanning
+ * several blocks to exercise the multi-block (possibly accelerated)
+ * compression path.
+ */
+static int self_test_sha512(void)
+{
+	static const uint8_t digest_abc[] = {
+		0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba,
+		0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31,
+		0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2,
+		0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a,
+		0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
+		0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
+		0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
+		0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f
+	};
+	/* SHA-512 of 1000 'a' */
+	static const uint8_t digest_a1000[] = {
+		0x67, 0xba, 0x55, 0x35, 0xa4, 0x6e, 0x3f, 0x86,
+		0xdb, 0xfb, 0xed, 0x8c, 0xbb, 0xaf, 0x01, 0x25,
+		0xc7, 0x6e, 0xd5, 0x49, 0xff, 0x8b, 0x0b, 0x9e,
+		0x03, 0xe0, 0xc8, 0x8c, 0xf9, 0x0f, 0xa6, 0x34,
+		0xfa, 0x7b, 0x12, 0xb4, 0x7d, 0x77, 0xb6, 0x94,
+		0xde, 0x48, 0x8a, 0xce, 0x8d, 0x9a, 0x65, 0x96,
+		0x7d, 0xc9, 0x6d, 0xf5, 0x99, 0x72, 0x7d, 0x32,
+		0x92, 0xa8, 0xd9, 0xd4, 0x47, 0x70, 0x9c, 0x97
+	};
+	uint8_t digest[TEE_SHA512_HASH_SIZE] = { };
+	uint8_t buf[300] = { };
+	void *ctx = NULL;
+	size_t n = 0;
+	int ret = -1;
+
+	LOG("sha512 tests:");
+	if (crypto_hash_alloc_ctx(&ctx, TEE_ALG_SHA512))
+		return -1;
+
+	if (crypto_hash_init(ctx) ||
+	    crypto_hash_update(ctx, (const uint8_t *)"abc", 3) ||
+	    crypto_hash_final(ctx, digest, sizeof(digest)) ||
+	    memcmp(digest, digest_abc, sizeof(digest)))
+		goto out;
+
+	memset(buf, 'a', sizeof(buf));
+	if (crypto_hash_init(ctx))
+		goto out;
+	for (n = 0; n < 1000; n += MIN(sizeof(buf), 1000 - n))
+		if (crypto_hash_update(ctx, buf, MIN(sizeof(buf), 1000 - n)))
+			goto out;
+	if (crypto_hash_final(ctx, digest, sizeof(digest)) ||
+	    memcmp(digest, digest_a1000, sizeof(digest)))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	crypto_hash_free_ctx(ctx);
+	return ret;
+}
+#else
+static int self_test_sha512(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef CFG_CRYPTO_SM3
+/* Known answer tests for SM3, see self_test_sha512() */
+static int self_test_sm3(void)
+{
+	static const uint8_t digest_abc[] = {
+		0x66, 0xc7, 0xf0, 0xf4, 0x62, 0xee, 0xed, 0xd9,
+		0xd1, 0xf2, 0xd4, 0x6b, 0xdc, 0x10, 0xe4, 0xe2,
+		0x41, 0x67, 0xc4, 0x87, 0x5c, 0xf2, 0xf7, 0xa2,
+		0x29, 0x7d, 0xa0, 0x2b, 0x8f, 0x4b, 0xa8, 0xe0
+	};
+	/* SM3 of 1000 'a' */
+	static const uint8_t digest_a1000[] = {
+		0xf4, 0xbe, 0xdc, 0xa9, 0x73, 0x22, 0x7d, 0x45,
+		0xc5, 0xb8, 0x22, 0x55, 0x1d, 0x2e, 0x76, 0x2d,
+		0x4c, 0xfb, 0x0e, 0x9a, 0xf7, 0x0b, 0x24, 0x14,
+		0x52, 0x54, 0x57, 0x27, 0xb5, 0xfb, 0x04, 0x6f
+	};
+	uint8_t digest[TEE_SM3_HASH_SIZE] = { };
+	uint8_t buf[300] = { };
+	void *ctx = NULL;
+	size_t n = 0;
+	int ret = -1;
+
+	LOG("sm3 tests:");
+	if (crypto_hash_alloc_ctx(&ctx, TEE_ALG_SM3))
+		return -1;
+
+	if (crypto_hash_init(ctx) ||
+	    crypto_hash_update(ctx, (const uint8_t *)"abc", 3) ||
+	    crypto_hash_final(ctx, digest, sizeof(digest)) ||
+	    memcmp(digest, digest_abc, sizeof(digest)))
+		goto out;
+
+	memset(buf, 'a', sizeof(buf));
+	if (crypto_hash_init(ctx))
+		goto out;
+	for (n = 0; n < 1000; n += MIN(sizeof(buf), 1000 - n))
+		if (crypto_hash_update(ctx, buf, MIN(sizeof(buf), 1000 - n)))
+			goto out;
+	if (crypto_hash_final(ctx, digest, sizeof(digest)) ||
+	    memcmp(digest, digest_a1000, sizeof(digest)))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	crypto_hash_free_ctx(ctx);
+	return ret;
+}
+#else
+static int self_test_sm3(void)
+{
+	return 0;
+}
+#endif
+
+#if defined(CFG_CRYPTO_SM4) && defined(CFG_CRYPTO_ECB) && \
+	defined(CFG_CRYPTO_CBC) && defined(CFG_CRYPTO_CTR)
+#define SM4_TEST_BLOCKS	5
+
+static int sm4_test_cipher(uint32_t algo, TEE_OperationMode mode,
+			   const uint8_t *key, const uint8_t *iv,
+			   const uint8_t *src, uint8_t *dst, size_t len)
+{
+	void *ctx = NULL;
+	int ret = -1;
+
+	if (crypto_cipher_alloc_ctx(&ctx, algo))
+		return -1;
+	if (!crypto_cipher_init(ctx, mode, key, 16, NULL, 0, iv,
+				iv ? 16 : 0) &&
+	    !crypto_cipher_update(ctx, mode, true, src, len, dst))
+		ret = 0;
+	crypto_cipher_final(ctx);
+	crypto_cipher_free_ctx(ctx);
+	return ret;
+}
+
+/*
+ * Tests of SM4 on several blocks at once to exercise the multi-block
+ * (possibly accelerated) paths. ECB is checked against the example of
+ * GM/T 0002-2012, CBC decryption against the software CBC encryption and
+ * CTR against ECB encryption of the counter blocks. The low half of the
+ * initial counter is all ones to check the carry into the high half.
+ */
+static int self_test_sm4(void)
+{
+	static const uint8_t key[] = {
+		0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+		0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10
+	};
+	static const uint8_t ct[] = {
+		0x68, 0x1e, 0xdf, 0x34, 0xd2, 0x06, 0x96, 0x5e,
+		0x86, 0xb3, 0xe9, 0x4f, 0x53, 0x6e, 0x42, 0x46
+	};
+	static const uint8_t iv[] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe
+	};
+	uint8_t src[SM4_TEST_BLOCKS * 16] = { };
+	uint8_t dst[SM4_TEST_BLOCKS * 16] = { };
+	uint8_t tmp[SM4_TEST_BLOCKS * 16] = { };
+	size_t n = 0;
+	int ret = -1;
+
+	LOG("sm4 tests:");
+
+	/* The example plaintext is the same as the key */
+	for (n = 0; n < SM4_TEST_BLOCKS; n++)
+		memcpy(src + n * 16, key, 16);
+	if (sm4_test_cipher(TEE_ALG_SM4_ECB_NOPAD, TEE_MODE_ENCRYPT, key,
+			    NULL, src, dst, sizeof(dst)))
+		goto out;
+	for (n = 0; n < SM4_TEST_BLOCKS; n++)
+		if (memcmp(dst + n * 16, ct, 16))
+			goto out;
+	if (sm4_test_cipher(TEE_ALG_SM4_ECB_NOPAD, TEE_MODE_DECRYPT, key,
+			    NULL, dst, tmp, sizeof(tmp)) ||
+	    memcmp(tmp, src, sizeof(src)))
+		goto out;
+
+	for (n = 0; n < sizeof(src); n++)
+		src[n] = n;
+	if (sm4_test_cipher(TEE_ALG_SM4_CBC_NOPAD, TEE_MODE_ENCRYPT, key, iv,
+			    src, dst, sizeof(dst)) ||
+	    sm4_test_cipher(TEE_ALG_SM4_CBC_NOPAD, TEE_MODE_DECRYPT, key, iv,
+			    dst, tmp, sizeof(tmp)) ||
+	    memcmp(tmp, src, sizeof(src)))
+		goto out;
+
+	/* Counter blocks iv, iv + 1, ... */
+	memcpy(tmp, iv, sizeof(iv));
+	for (n = 1; n < SM4_TEST_BLOCKS; n++) {
+		size_t i = 16;
+
+		memcpy(tmp + n * 16, tmp + (n - 1) * 16, 16);
+		while (i && !++tmp[n * 16 + i - 1])
+			i--;
+	}
+	if (sm4_test_cipher(TEE_ALG_SM4_ECB_NOPAD, TEE_MODE_ENCRYPT, key,
+			    NULL, tmp, tmp, sizeof(tmp)))
+		goto out;
+	for (n = 0; n < sizeof(tmp); n++)
+		tmp[n] ^= src[n];
+	if (sm4_test_cipher(TEE_ALG_SM4_CTR, TEE_MODE_ENCRYPT, key, iv, src,
+			    dst, sizeof(dst)) ||
+	    memcmp(dst, tmp, sizeof(dst)))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	return ret;
+}
+#else
+static int self_test_sm4(void)
+{
+	return 0;
+}
+#endif
+
+#if defined(CFG_CRYPTO_AES) && defined(CFG_CRYPTO_CBC) && \
+	defined(CFG_CRYPTO_XTS)
+#define AES_TEST_SIZE	(4096 + 3 * TEE_AES_BLOCK_SIZE)
+
+static int aes_test_cipher(uint32_t algo, TEE_OperationMode mode,
+			   const uint8_t *key, size_t key_len,
+			   const uint8_t *iv, const uint8_t *src, uint8_t *dst,
+			   size_t len, size_t split)
+{
+	void *ctx = NULL;
+	int ret = -1;
+
+	if (crypto_cipher_alloc_ctx(&ctx, algo))
+		return -1;
+	if (algo == TEE_ALG_AES_XTS) {
+		if (crypto_cipher_init(ctx, mode, key, key_len / 2,
+				       key + key_len / 2, key_len / 2, iv,
+				       TEE_AES_BLOCK_SIZE))
+			goto out;
+	} else {
+		if (crypto_cipher_init(ctx, mode, key, key_len, NULL, 0, iv,
+				       TEE_AES_BLOCK_SIZE))
+			goto out;
+	}
+	if (crypto_cipher_update(ctx, mode, false, src, split, dst) ||
+	    crypto_cipher_update(ctx, mode, true, src + split, len - split,
+				 dst + split))
+		goto out;
+	ret = 0;
+out:
+	crypto_cipher_final(ctx);
+	crypto_cipher_free_ctx(ctx);
+	return ret;
+}
+
+/*
+ * Tests of AES-CBC decryption and AES-XTS on a 4 KiB sector and a few
+ * more blocks to exercise the interleaved (possibly accelerated) paths.
+ * The data is processed both in one go and split in two updates, where
+ * the first one ends on a multiple of four blocks, and must give the
+ * same result. Decryption must give back the plaintext.
+ */
+static int self_test_aes_modes(void)
+{
+	static const uint32_t algos[] = { TEE_ALG_AES_CBC_NOPAD,
+					  TEE_ALG_AES_XTS };
+	static const size_t splits[] = { 4 * TEE_AES_BLOCK_SIZE,
+					 9 * TEE_AES_BLOCK_SIZE };
+	uint8_t iv[TEE_AES_BLOCK_SIZE] = { };
+	uint8_t key[64] = { };
+	uint8_t *src = NULL;
+	uint8_t *dst = NULL;
+	uint8_t *tmp = NULL;
+	size_t n = 0;
+	size_t m = 0;
+	int ret = -1;
+
+	LOG("aes modes tests:");
+	src = malloc(AES_TEST_SIZE);
+	dst = malloc(AES_TEST_SIZE);
+	tmp = malloc(AES_TEST_SIZE);
+	if (!src || !dst || !tmp)
+		goto out;
+
+	for (n = 0; n < AES_TEST_SIZE; n++)
+		src[n] = n * 7;
+	for (n = 0; n < sizeof(key); n++)
+		key[n] = n;
+	for (n = 0; n < sizeof(iv); n++)
+		iv[n] = 0xf0 + n;
+
+	for (n = 0; n < ARRAY_SIZE(algos); n++) {
+		if (aes_test_cipher(algos[n], TEE_MODE_ENCRYPT, key, 32, iv,
+				    src, dst, AES_TEST_SIZE, AES_TEST_SIZE))
+			goto out;
+		for (m = 0; m < ARRAY_SIZE(splits); m++) {
+			if (aes_test_cipher(algos[n], TEE_MODE_ENCRYPT, key,
+					    32, iv, src, tmp, AES_TEST_SIZE,
+					    splits[m]) ||
+			    memcmp(tmp, dst, AES_TEST_SIZE))
+				goto out;
+			if (aes_test_cipher(algos[n], TEE_MODE_DECRYPT, key,
+					    32, iv, dst, tmp, AES_TEST_SIZE,
+					    splits[m]) ||
+			    memcmp(tmp, src, AES_TEST_SIZE))
+				goto out;
+		}
+	}
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	free(src);
+	free(dst);
+	free(tmp);
+	return ret;
+}
+#else
+static int self_test_aes_modes(void)
+{
+	return 0;
+}
+#endif
+
+#if defined(CFG_CRYPTO_AES) && defined(CFG_CRYPTO_CTR) && \
+	defined(CFG_CRYPTO_GCM)
+#define REINIT_TEST_SIZE	100
+
+/* Encrypts src with a new context or by reinitializing ctx */
+static int reinit_test_ctr(void *ctx, const uint8_t *key, const uint8_t *iv,
+			   const uint8_t *src, uint8_t *dst)
+{
+	void *c = ctx;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!c && crypto_cipher_alloc_ctx(&c, TEE_ALG_AES_CTR))
+		return -1;
+
+	if (ctx)
+		res = crypto_cipher_reinit(c, TEE_MODE_ENCRYPT, iv,
+					   TEE_AES_BLOCK_SIZE);
+	else
+		res = crypto_cipher_init(c, TEE_MODE_ENCRYPT, key, 16, NULL,
+					 0, iv, TEE_AES_BLOCK_SIZE);
+	if (!res)
+		res = crypto_cipher_update(c, TEE_MODE_ENCRYPT, true, src,
+					   REINIT_TEST_SIZE, dst);
+	crypto_cipher_final(c);
+	if (!ctx)
+		crypto_cipher_free_ctx(c);
+
+	return res ? -1 : 0;
+}
+
+static int reinit_test_gcm(void *ctx, const uint8_t *key, const uint8_t *iv,
+			   const uint8_t *src, uint8_t *dst, uint8_t *tag)
+{
+	size_t tag_len = TEE_AES_BLOCK_SIZE;
+	size_t dst_len = REINIT_TEST_SIZE;
+	TEE_Result res = TEE_SUCCESS;
+	void *c = ctx;
+
+	if (!c && crypto_authenc_alloc_ctx(&c, TEE_ALG_AES_GCM))
+		return -1;
+
+	if (ctx)
+		res = crypto_authenc_reinit(c, TEE_MODE_ENCRYPT, iv, 12,
+					    tag_len, 0, REINIT_TEST_SIZE);
+	else
+		res = crypto_authenc_init(c, TEE_MODE_ENCRYPT, key, 16, iv, 12,
+					  tag_len, 0, REINIT_TEST_SIZE);
+	if (!res)
+		res = crypto_authenc_enc_final(c, src, REINIT_TEST_SIZE, dst,
+					       &dst_len, tag, &tag_len);
+	crypto_authenc_final(c);
+	if (!ctx)
+		crypto_authenc_free_ctx(c);
+
+	return res ? -1 : 0;
+}
+
+/*
+ * A context reinitialized with a new IV must give the same result as a
+ * new context initialized with the key and that IV.
+ */
+static int self_test_cipher_reinit(void)
+{
+	uint8_t tag[2][TEE_AES_BLOCK_SIZE] = { };
+	uint8_t dst[2][REINIT_TEST_SIZE] = { };
+	uint8_t src[REINIT_TEST_SIZE] = { };
+	uint8_t iv[TEE_AES_BLOCK_SIZE] = { };
+	uint8_t key[16] = { };
+	void *cipher_ctx = NULL;
+	void *ae_ctx = NULL;
+	size_t n = 0;
+	int ret = -1;
+
+	LOG("cipher reinit tests:");
+	for (n = 0; n < sizeof(src); n++)
+		src[n] = n;
+	for (n = 0; n < sizeof(key); n++)
+		key[n] = 0x40 + n;
+
+	if (crypto_cipher_alloc_ctx(&cipher_ctx, TEE_ALG_AES_CTR)) {
+		cipher_ctx = NULL;
+		goto out;
+	}
+	if (reinit_test_ctr(NULL, key, iv, src, dst[0]) ||
+	    crypto_cipher_init(cipher_ctx, TEE_MODE_ENCRYPT, key, sizeof(key),
+			       NULL, 0, iv, sizeof(iv)))
+		goto out;
+	crypto_cipher_final(cipher_ctx);
+	iv[0] = 1;
+	/* Implementations without reinit are left out */
+	if (crypto_cipher_reinit(cipher_ctx, TEE_MODE_ENCRYPT, iv,
+				 sizeof(iv)) != TEE_ERROR_NOT_SUPPORTED &&
+	    (reinit_test_ctr(cipher_ctx, key, iv, src, dst[0]) ||
+	     reinit_test_ctr(NULL, key, iv, src, dst[1]) ||
+	     memcmp(dst[0], dst[1], sizeof(dst[0]))))
+		goto out;
+
+	if (crypto_authenc_alloc_ctx(&ae_ctx, TEE_ALG_AES_GCM)) {
+		ae_ctx = NULL;
+		goto out;
+	}
+	iv[0] = 0;
+	if (crypto_authenc_init(ae_ctx, TEE_MODE_ENCRYPT, key, sizeof(key), iv,
+				12, sizeof(tag[0]), 0, sizeof(src)))
+		goto out;
+	crypto_authenc_final(ae_ctx);
+	iv[0] = 1;
+	if (crypto_authenc_reinit(ae_ctx, TEE_MODE_ENCRYPT, iv, 12,
+				  sizeof(tag[0]), 0,
+				  sizeof(src)) != TEE_ERROR_NOT_SUPPORTED &&
+	    (reinit_test_gcm(ae_ctx, key, iv, src, dst[0], tag[0]) ||
+	     reinit_test_gcm(NULL, key, iv, src, dst[1], tag[1]) ||
+	     memcmp(dst[0], dst[1], sizeof(dst[0])) ||
+	     memcmp(tag[0], tag[1], sizeof(tag[0]))))
+		goto out;
+
+	ret = 0;
+out:
+	crypto_cipher_free_ctx(cipher_ctx);
+	crypto_authenc_free_ctx(ae_ctx);
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	return ret;
+}
+#else
+static int self_test_cipher_reinit(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef CFG_CRYPTO_CHACHA20_POLY1305
+#define CHACHAPOLY_TEST_SIZE	1000
+#define CHACHAPOLY_TAG_SIZE	16
+
+static int chachapoly_test(TEE_OperationMode mode, const uint8_t *key,
+			   const uint8_t *nonce, const uint8_t *aad,
+			   size_t aad_len, const uint8_t *src, uint8_t *dst,
+			   size_t len, size_t split, uint8_t *tag)
+{
+	size_t tag_len = CHACHAPOLY_TAG_SIZE;
+	size_t dlen = split;
+	void *ctx = NULL;
+	int ret = -1;
+
+	if (crypto_authenc_alloc_ctx(&ctx, TEE_ALG_CHACHA20_POLY1305))
+		return -1;
+	if (crypto_authenc_init(ctx, mode, key, 32, nonce, 12, tag_len,
+				aad_len, len) ||
+	    crypto_authenc_update_aad(ctx, mode, aad, aad_len) ||
+	    crypto_authenc_update_payload(ctx, mode, src, split, dst, &dlen))
+		goto out;
+	dlen = len - split;
+	if (mode == TEE_MODE_ENCRYPT) {
+		if (crypto_authenc_enc_final(ctx, src + split, len - split,
+					     dst + split, &dlen, tag,
+					     &tag_len))
+			goto out;
+	} else {
+		if (crypto_authenc_dec_final(ctx, src + split, len - split,
+					     dst + split, &dlen, tag,
+					     tag_len))
+			goto out;
+	}
+	ret = 0;
+out:
+	crypto_authenc_final(ctx);
+	crypto_authenc_free_ctx(ctx);
+	return ret;
+}
+
+/*
+ * Tests of ChaCha20-Poly1305, the known answer test is the example of
+ * RFC 8439 section 2.8.2. A larger buffer is then processed in one go
+ * and split at an offset which isn't a multiple of the ChaCha20 block
+ * size to exercise the (possibly accelerated) multi-block path, the
+ * result must be the same and decryption must give back the plaintext.
+ * A modified tag must be rejected.
+ */
+static int self_test_chacha20_poly1305(void)
+{
+	static const uint8_t nonce[] = {
+		0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43,
+		0x44, 0x45, 0x46, 0x47
+	};
+	static const uint8_t aad[] = {
+		0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3,
+		0xc4, 0xc5, 0xc6, 0xc7
+	};
+	static const char pt[] = "Ladies and Gentlemen of the class of '99: "
+				 "If I could offer you only one tip for the "
+				 "future, sunscreen would be it.";
+	static const uint8_t ct[] = {
+		0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb,
+		0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+		0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+		0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+		0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12,
+		0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+		0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29,
+		0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+		0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+		0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+		0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94,
+		0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+		0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d,
+		0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+		0x61, 0x16
+	};
+	static const uint8_t ct_tag[] = {
+		0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+		0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+	};
+	uint8_t tag[CHACHAPOLY_TAG_SIZE] = { };
+	uint8_t tag2[CHACHAPOLY_TAG_SIZE] = { };
+	uint8_t key[32] = { };
+	uint8_t *src = NULL;
+	uint8_t *dst = NULL;
+	uint8_t *tmp = NULL;
+	size_t n = 0;
+	int ret = -1;
+
+	LOG("chacha20-poly1305 tests:");
+	src = malloc(CHACHAPOLY_TEST_SIZE);
+	dst = malloc(CHACHAPOLY_TEST_SIZE);
+	tmp = malloc(CHACHAPOLY_TEST_SIZE);
+	if (!src || !dst || !tmp)
+		goto out;
+
+	for (n = 0; n < sizeof(key); n++)
+		key[n] = 0x80 + n;
+
+	if (chachapoly_test(TEE_MODE_ENCRYPT, key, nonce, aad, sizeof(aad),
+			    (const uint8_t *)pt, dst, sizeof(ct), 64, tag) ||
+	    memcmp(dst, ct, sizeof(ct)) || memcmp(tag, ct_tag, sizeof(tag)))
+		goto out;
+	if (chachapoly_test(TEE_MODE_DECRYPT, key, nonce, aad, sizeof(aad),
+			    ct, tmp, sizeof(ct), 0, tag) ||
+	    memcmp(tmp, pt, sizeof(ct)))
+		goto out;
+
+	for (n = 0; n < CHACHAPOLY_TEST_SIZE; n++)
+		src[n] = n * 7;
+	if (chachapoly_test(TEE_MODE_ENCRYPT, key, nonce, aad, sizeof(aad),
+			    src, dst, CHACHAPOLY_TEST_SIZE, 0, tag) ||
+	    chachapoly_test(TEE_MODE_ENCRYPT, key, nonce, aad, sizeof(aad),
+			    src, tmp, CHACHAPOLY_TEST_SIZE, 100, tag2) ||
+	    memcmp(tmp, dst, CHACHAPOLY_TEST_SIZE) ||
+	    memcmp(tag, tag2, sizeof(tag)))
+		goto out;
+	if (chachapoly_test(TEE_MODE_DECRYPT, key, nonce, aad, sizeof(aad),
+			    dst, tmp, CHACHAPOLY_TEST_SIZE, 100, tag) ||
+	    memcmp(tmp, src, CHACHAPOLY_TEST_SIZE))
+		goto out;
+	tag[0] ^= 1;
+	if (!chachapoly_test(TEE_MODE_DECRYPT, key, nonce, aad, sizeof(aad),
+			     dst, tmp, CHACHAPOLY_TEST_SIZE, 100, tag))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	free(src);
+	free(dst);
+	free(tmp);
+	return ret;
+}
+#else
+static int self_test_chacha20_poly1305(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef CFG_CRYPTO_X25519
+/* Test vector from RFC 7748 section 6.1 */
+static int self_test_x25519(void)
+{
+	static const uint8_t alice_priv[] = {
+		0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d,
+		0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+		0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+		0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+	};
+	static const uint8_t alice_pub[] = {
+		0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54,
+		0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+		0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4,
+		0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a
+	};
+	static const uint8_t bob_priv[] = {
+		0x5d, 0xab, 0x08, 0x7e, 0x62, 0x4a, 0x8a, 0x4b,
+		0x79, 0xe1, 0x7f, 0x8b, 0x83, 0x80, 0x0e, 0xe6,
+		0x6f, 0x3b, 0xb1, 0x29, 0x26, 0x18, 0xb6, 0xfd,
+		0x1c, 0x2f, 0x8b, 0x27, 0xff, 0x88, 0xe0, 0xeb
+	};
+	static const uint8_t bob_pub[] = {
+		0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4,
+		0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+		0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+		0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f
+	};
+	static const uint8_t shared[] = {
+		0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1,
+		0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+		0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+		0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42
+	};
+	struct x25519_keypair key = { };
+	uint8_t secret[sizeof(shared)] = { };
+	unsigned long secret_len = sizeof(secret);
+	int ret = -1;
+
+	LOG("x25519 tests:");
+	if (crypto_acipher_alloc_x25519_keypair(&key, 256))
+		goto out;
+
+	memcpy(key.priv, alice_priv, sizeof(alice_priv));
+	if (crypto_acipher_x25519_shared_secret(&key, bob_pub, secret,
+						&secret_len) ||
+	    secret_len != sizeof(shared) ||
+	    memcmp(secret, shared, sizeof(shared)))
+		goto out;
+
+	memcpy(key.priv, bob_priv, sizeof(bob_priv));
+	secret_len = sizeof(secret);
+	if (crypto_acipher_x25519_shared_secret(&key, alice_pub, secret,
+						&secret_len) ||
+	    secret_len != sizeof(shared) ||
+	    memcmp(secret, shared, sizeof(shared)))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	free(key.priv);
+	free(key.pub);
+	return ret;
+}
+#else
+static int self_test_x25519(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef CFG_CRYPTO_ED25519
+/* Test 2 from RFC 8032 section 7.1 */
+static int self_test_ed25519(void)
+{
+	static const uint8_t sk[] = {
+		0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda,
+		0x9d, 0xb6, 0xc3, 0x46, 0xec, 0x11, 0x4e, 0x0f,
+		0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+		0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb
+	};
+	static const uint8_t pk[] = {
+		0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a,
+		0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+		0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+		0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c
+	};
+	static const uint8_t msg[] = { 0x72 };
+	static const uint8_t ref_sig[] = {
+		0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8,
+		0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+		0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+		0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+		0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e,
+		0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+		0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee,
+		0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00
+	};
+	struct ed25519_keypair key = { };
+	struct ed25519_public_key pub_key = { };
+	uint8_t sig[sizeof(ref_sig)] = { };
+	size_t sig_len = sizeof(sig);
+	int ret = -1;
+
+	LOG("ed25519 tests:");
+	if (crypto_acipher_alloc_ed25519_keypair(&key, 256) ||
+	    crypto_acipher_alloc_ed25519_public_key(&pub_key, 256))
+		goto out;
+
+	memcpy(key.priv, sk, sizeof(sk));
+	memcpy(key.pub, pk, sizeof(pk));
+	memcpy(pub_key.pub, pk, sizeof(pk));
+	if (crypto_acipher_ed25519_sign(&key, msg, sizeof(msg), sig,
+					&sig_len) ||
+	    sig_len != sizeof(ref_sig) ||
+	    memcmp(sig, ref_sig, sizeof(ref_sig)))
+		goto out;
+	if (crypto_acipher_ed25519_verify(&pub_key, msg, sizeof(msg), sig,
+					  sig_len))
+		goto out;
+	sig[0] ^= 1;
+	if (!crypto_acipher_ed25519_verify(&pub_key, msg, sizeof(msg), sig,
+					   sig_len))
+		goto out;
+
+	ret = 0;
+out:
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	free(key.priv);
+	free(key.pub);
+	free(pub_key.pub);
+	return ret;
+}
+#else
+static int self_test_ed25519(void)
+{
+	return 0;
+}
+#endif
+
 /* exported entry points for some basic test */
+#if defined(CFG_CRYPTO_PBKDF2) && defined(CFG_CRYPTO_SHA256)
+/*
+ * Test vector for PBKDF2-HMAC-SHA256 with a derived key of two hash
+ * blocks, the last one truncated
+ */
+static int self_test_pbkdf2(void)
+{
+	static const char password[] = "passwordPASSWORDpassword";
+	static const char salt[] = "saltSALTsaltSALTsaltSALTsaltSALTsalt";
+	static const uint8_t dk[] = {
+		0x34, 0x8c, 0x89, 0xdb, 0xcb, 0xd3, 0x2b, 0x2f,
+		0x32, 0xd8, 0x14, 0xb8, 0x11, 0x6e, 0x84, 0xcf,
+		0x2b, 0x17, 0x34, 0x7e, 0xbc, 0x18, 0x00, 0x18,
+		0x1c, 0x4e, 0x2a, 0x1f, 0xb8, 0xdd, 0x53, 0xe1,
+		0xc6, 0x35, 0x51, 0x8c, 0x7d, 0xac, 0x47, 0xe9
+	};
+	uint8_t out[sizeof(dk)] = { };
+	int ret = -1;
+
+	LOG("pbkdf2 tests:");
+	if (!tee_cryp_pbkdf2(TEE_MAIN_ALGO_SHA256, (const uint8_t *)password,
+			     sizeof(password) - 1, (const uint8_t *)salt,
+			     sizeof(salt) - 1, 4096, out, sizeof(out)) &&
+	    !memcmp(out, dk, sizeof(dk)))
+		ret = 0;
+
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	return ret;
+}
+#else
+static int self_test_pbkdf2(void)
+{
+	return 0;
+}
+#endif
+
+/* x = a * b by shifts and additions, x must not be a or b */
+static int mpi_ref_mul(mbedtls_mpi *x, const mbedtls_mpi *a,
+		       const mbedtls_mpi *b)
+{
+	mbedtls_mpi t = { };
+	size_t n = 0;
+	int ret = 0;
+
+	mbedtls_mpi_init(&t);
+	ret = mbedtls_mpi_copy(&t, a);
+	if (!ret)
+		ret = mbedtls_mpi_lset(x, 0);
+	for (n = 0; !ret && n < mbedtls_mpi_bitlen(b); n++) {
+		if (mbedtls_mpi_get_bit(b, n))
+			ret = mbedtls_mpi_add_abs(x, x, &t);
+		if (!ret)
+			ret = mbedtls_mpi_shift_l(&t, 1);
+	}
+	mbedtls_mpi_free(&t);
+
+	return ret;
+}
+
+/* x = a^e mod n by square and multiply with mpi_ref_mul() */
+static int mpi_ref_exp_mod(mbedtls_mpi *x, const mbedtls_mpi *a,
+			   const mbedtls_mpi *e, const mbedtls_mpi *n)
+{
+	mbedtls_mpi t = { };
+	size_t i = 0;
+	int ret = 0;
+
+	mbedtls_mpi_init(&t);
+	ret = mbedtls_mpi_lset(x, 1);
+	for (i = mbedtls_mpi_bitlen(e); !ret && i > 0; i--) {
+		ret = mpi_ref_mul(&t, x, x);
+		if (!ret)
+			ret = mbedtls_mpi_mod_mpi(x, &t, n);
+		if (!ret && mbedtls_mpi_get_bit(e, i - 1)) {
+			ret = mpi_ref_mul(&t, x, a);
+			if (!ret)
+				ret = mbedtls_mpi_mod_mpi(x, &t, n);
+		}
+	}
+	mbedtls_mpi_free(&t);
+
+	return ret;
+}
+
+/*
+ * Checks the schoolbook, Karatsuba and squaring paths of the bignum
+ * multiplication and the Montgomery squaring of the modular exponentiation
+ * against results computed without them.
+ */
+static int self_test_mpi(void)
+{
+	/* Operand sizes in limbs, around the Karatsuba threshold */
+	static const size_t limbs[] = { 1, 7, 31, 32, 33, 48, 64, 65 };
+	static const size_t mod_limbs[] = { 17, 33, 64 };
+	size_t len = 0;
+	size_t i = 0;
+	mbedtls_mpi a = { };
+	mbedtls_mpi b = { };
+	mbedtls_mpi e = { };
+	mbedtls_mpi n = { };
+	mbedtls_mpi x = { };
+	mbedtls_mpi y = { };
+	int ret = -1;
+
+	LOG("mpi tests:");
+	mbedtls_mpi_init(&a);
+	mbedtls_mpi_init(&b);
+	mbedtls_mpi_init(&e);
+	mbedtls_mpi_init(&n);
+	mbedtls_mpi_init(&x);
+	mbedtls_mpi_init(&y);
+
+	for (i = 0; i < ARRAY_SIZE(limbs); i++) {
+		len = limbs[i] * sizeof(mbedtls_mpi_uint);
+
+		/* Operands of different sizes */
+		if (mbedtls_mpi_fill_random(&a, len, test_mpi_rng, NULL) ||
+		    mbedtls_mpi_fill_random(&b, len - len / 4, test_mpi_rng,
+					    NULL) ||
+		    mbedtls_mpi_mul_mpi(&x, &a, &b) ||
+		    mpi_ref_mul(&y, &a, &b) || mbedtls_mpi_cmp_mpi(&x, &y))
+			goto out;
+
+		/* Operands of the same size */
+		if (mbedtls_mpi_fill_random(&b, len, test_mpi_rng, NULL) ||
+		    mbedtls_mpi_mul_mpi(&x, &a, &b) ||
+		    mpi_ref_mul(&y, &a, &b) || mbedtls_mpi_cmp_mpi(&x, &y))
+			goto out;
+
+		/* Square, also in place */
+		if (mbedtls_mpi_mul_mpi(&x, &a, &a) ||
+		    mpi_ref_mul(&y, &a, &a) || mbedtls_mpi_cmp_mpi(&x, &y) ||
+		    mbedtls_mpi_copy(&x, &a) ||
+		    mbedtls_mpi_mul_mpi(&x, &x, &x) ||
+		    mbedtls_mpi_cmp_mpi(&x, &y))
+			goto out;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(mod_limbs); i++) {
+		len = mod_limbs[i] * sizeof(mbedtls_mpi_uint);
+
+		if (mbedtls_mpi_fill_random(&n, len, test_mpi_rng, NULL) ||
+		    mbedtls_mpi_set_bit(&n, len * 8 - 1, 1) ||
+		    mbedtls_mpi_set_bit(&n, 0, 1) ||
+		    mbedtls_mpi_fill_random(&a, len, test_mpi_rng, NULL) ||
+		    mbedtls_mpi_mod_mpi(&a, &a, &n) ||
+		    mbedtls_mpi_fill_random(&e, 2, test_mpi_rng, NULL) ||
+		    mbedtls_mpi_exp_mod(&x, &a, &e, &n, NULL) ||
+		    mpi_ref_exp_mod(&y, &a, &e, &n) ||
+		    mbedtls_mpi_cmp_mpi(&x, &y))
+			goto out;
+	}
+
+	ret = 0;
+out:
+	mbedtls_mpi_free(&y);
+	mbedtls_mpi_free(&x);
+	mbedtls_mpi_free(&n);
+	mbedtls_mpi_free(&e);
+	mbedtls_mpi_free(&b);
+	mbedtls_mpi_free(&a);
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	return ret;
+}
+
+/* Checks the reuse of freed arena items and the fallback to the pool */
+static int self_test_mempool_arena(void)
+{
+	struct mempool *pool = mempool_default;
+	uint8_t *big = NULL;
+	uint8_t *p0 = NULL;
+	uint8_t *p1 = NULL;
+	int ret = 0;
+
+	if (!pool)
+		return 0;
+
+	LOG("mempool arena tests:");
+	mempool_arena_begin(pool, 1024);
+	mempool_arena_begin(pool, 1024);
+	p0 = mempool_alloc(pool, 100);
+	p1 = mempool_alloc(pool, 200);
+	/* Larger than the arena, taken from the pool */
+	big = mempool_alloc(pool, 2048);
+	if (!p0 || !p1 || !big || p1 <= p0 || (big >= p0 && big <= p1))
+		ret = -1;
+
+	/* Out of order, p0 is reclaimed with p1 */
+	if (p0)
+		mempool_free(pool, p0);
+	if (p1)
+		mempool_free(pool, p1);
+	p1 = mempool_alloc(pool, 300);
+	if (!p1 || p1 != p0)
+		ret = -1;
+
+	if (p1)
+		mempool_free(pool, p1);
+	if (big)
+		mempool_free(pool, big);
+	mempool_arena_end(pool);
+	mempool_arena_end(pool);
+	LOG("  => test %s", ret ? "FAILED" : "ok");
+	return ret;
+}
+
 TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 		TEE_Param pParams[TEE_NUM_PARAMS] __unused)
 {
 	if (self_test_mul_signed_overflow() || self_test_add_overflow() ||
 	    self_test_sub_overflow() || self_test_mul_unsigned_overflow() ||
 	    self_test_division() || self_test_malloc() ||
-	    self_test_nex_malloc()) {
+	    self_test_nex_malloc() || self_test_sha512() ||
+	    self_test_sm3() || self_test_sm4() || self_test_aes_modes() ||
+	    self_test_chacha20_poly1305() || self_test_x25519() ||
+	    self_test_ed25519() || self_test_pbkdf2() || self_test_mpi() ||
+	    self_test_mempool_arena() || self_test_cipher_reinit()) {
 		EMSG("some self_test_xxx failed! you should enable local LOG");
 		return TEE_ERROR_GENERIC;
 	}
@@ -6,9 +6,20 @@
 #define CORE_PTA_TESTS_MISC_H
 
 #include <compiler.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <tee_api_types.h>
 #include <tee_api_defines.h>
 
+/* Milliseconds elapsed since @start, at least 1 */
+uint32_t perf_elapsed_ms(const TEE_Time *start);
+
+/* Events per second for @count events in @ms milliseconds, saturated */
+uint32_t perf_rate(uint64_t count, uint32_t ms);
+
+/* RNG callback for mbedtls_mpi_fill_random() and friends */
+int test_mpi_rng(void *ctx, unsigned char *buf, size_t len);
+
 /* basic run-time tests */
 TEE_Result core_self_tests(uint32_t nParamTypes,
 			   TEE_Param pParams[TEE_NUM_PARAMS]);
@@ -34,4 +45,37 @@ static inline TEE_Result core_lockdep_tests(
 TEE_Result core_aes_perf_tests(uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS]);
 
+TEE_Result core_sm_perf_tests(uint32_t param_types,
+			      TEE_Param params[TEE_NUM_PARAMS]);
+
+TEE_Result core_rng_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS]);
+
+TEE_Result core_mpi_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS]);
+
+#ifdef CFG_CRYPTO_HMAC
+TEE_Result core_pbkdf2_perf_tests(uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result core_pbkdf2_perf_tests(
+		uint32_t param_types __unused,
+		TEE_Param params[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#ifdef CFG_CRYPTO_ECC
+TEE_Result core_ecc_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result core_ecc_perf_tests(
+		uint32_t param_types __unused,
+		TEE_Param params[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 #endif /*CORE_PTA_TESTS_MISC_H*/
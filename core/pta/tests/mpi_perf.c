@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <kernel/tee_time.h>
+#include <mbedtls/bignum.h>
+#include <pta_invoke_tests.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+static TEE_Result run_exp_mod(mbedtls_mpi *a, const mbedtls_mpi *e,
+			      const mbedtls_mpi *n, unsigned int rep_count,
+			      uint32_t *ops_per_sec)
+{
+	mbedtls_mpi rr = { };
+	mbedtls_mpi x = { };
+	TEE_Result res = TEE_SUCCESS;
+	TEE_Time start = { };
+	unsigned int i = 0;
+
+	mbedtls_mpi_init(&rr);
+	mbedtls_mpi_init(&x);
+
+	/* Untimed first round, computes R^2 mod N reused by the others */
+	if (mbedtls_mpi_exp_mod(&x, a, e, n, &rr)) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	res = tee_time_get_sys_time(&start);
+	if (res)
+		goto out;
+
+	for (i = 0; i < rep_count; i++) {
+		if (mbedtls_mpi_exp_mod(&x, a, e, n, &rr)) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
+	}
+
+	*ops_per_sec = perf_rate(rep_count, perf_elapsed_ms(&start));
+out:
+	mbedtls_mpi_free(&x);
+	mbedtls_mpi_free(&rr);
+	return res;
+}
+
+TEE_Result core_mpi_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int rep_count = 0;
+	size_t bits = 0;
+	mbedtls_mpi a = { };
+	mbedtls_mpi e = { };
+	mbedtls_mpi n = { };
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	bits = params[0].value.a;
+	rep_count = params[0].value.b;
+	if (bits < 512 || bits > CFG_CORE_BIGNUM_MAX_BITS || bits % 64)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mbedtls_mpi_init(&a);
+	mbedtls_mpi_init(&e);
+	mbedtls_mpi_init(&n);
+
+	/* Odd modulus of exactly the requested size, base below it */
+	if (mbedtls_mpi_fill_random(&n, bits / 8, test_mpi_rng, NULL) ||
+	    mbedtls_mpi_set_bit(&n, bits - 1, 1) ||
+	    mbedtls_mpi_set_bit(&n, 0, 1) ||
+	    mbedtls_mpi_fill_random(&a, bits / 8, test_mpi_rng, NULL) ||
+	    mbedtls_mpi_mod_mpi(&a, &a, &n)) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	/* Private key operation, exponent of the size of the modulus */
+	if (mbedtls_mpi_fill_random(&e, bits / 8, test_mpi_rng, NULL)) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+	res = run_exp_mod(&a, &e, &n, rep_count, &params[1].value.a);
+	if (res)
+		goto out;
+
+	/* Public key operation */
+	if (mbedtls_mpi_lset(&e, 65537)) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+	res = run_exp_mod(&a, &e, &n, rep_count, &params[1].value.b);
+	if (res)
+		goto out;
+
+	DMSG("modexp %zu bits: %"PRIu32" ops/s private, %"PRIu32
+	     " ops/s public", bits, params[1].value.a, params[1].value.b);
+out:
+	mbedtls_mpi_free(&n);
+	mbedtls_mpi_free(&e);
+	mbedtls_mpi_free(&a);
+	return res;
+}
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "misc.h"
+
+static const uint8_t password[] = "correct horse battery staple";
+static const uint8_t salt[] = "0123456789abcdef";
+
+/* First block of PBKDF2-HMAC-SHA256, rekeying the MAC for each iteration */
+static TEE_Result pbkdf2_mac(uint32_t iter, uint8_t out[TEE_SHA256_HASH_SIZE])
+{
+	uint8_t u[TEE_SHA256_HASH_SIZE] = { };
+	const uint8_t be_one[] = { 0, 0, 0, 1 };
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+	uint32_t i = 0;
+	size_t j = 0;
+
+	res = crypto_mac_alloc_ctx(&ctx, TEE_ALG_HMAC_SHA256);
+	if (res)
+		return res;
+
+	memset(out, 0, TEE_SHA256_HASH_SIZE);
+	for (i = 0; i < iter; i++) {
+		res = crypto_mac_init(ctx, password, sizeof(password) - 1);
+		if (res)
+			goto out;
+		if (!i) {
+			res = crypto_mac_update(ctx, salt, sizeof(salt) - 1);
+			if (!res)
+				res = crypto_mac_update(ctx, be_one,
+							sizeof(be_one));
+		} else {
+			res = crypto_mac_update(ctx, u, sizeof(u));
+		}
+		if (!res)
+			res = crypto_mac_final(ctx, u, sizeof(u));
+		if (res)
+			goto out;
+		for (j = 0; j < sizeof(u); j++)
+			out[j] ^= u[j];
+	}
+out:
+	crypto_mac_free_ctx(ctx);
+	return res;
+}
+
+/* Same as pbkdf2_mac() but with precomputed HMAC pads */
+static TEE_Result pbkdf2_pads(uint32_t iter,
+			      uint8_t out[TEE_SHA256_HASH_SIZE])
+{
+	uint8_t u[TEE_SHA256_HASH_SIZE] = { };
+	const uint8_t be_one[] = { 0, 0, 0, 1 };
+	struct crypto_hmac_pads pads = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t i = 0;
+	size_t j = 0;
+
+	res = crypto_hmac_pads_init(&pads, TEE_ALG_SHA256, password,
+				    sizeof(password) - 1);
+	if (res)
+		return res;
+
+	memset(out, 0, TEE_SHA256_HASH_SIZE);
+	for (i = 0; i < iter; i++) {
+		crypto_hmac_pads_start(&pads);
+		if (!i) {
+			res = crypto_hmac_pads_update(&pads, salt,
+						      sizeof(salt) - 1);
+			if (!res)
+				res = crypto_hmac_pads_update(&pads, be_one,
+							      sizeof(be_one));
+		} else {
+			res = crypto_hmac_pads_update(&pads, u, sizeof(u));
+		}
+		if (!res)
+			res = crypto_hmac_pads_final(&pads, u);
+		if (res)
+			goto out;
+		for (j = 0; j < sizeof(u); j++)
+			out[j] ^= u[j];
+	}
+out:
+	crypto_hmac_pads_free(&pads);
+	return res;
+}
+
+TEE_Result core_pbkdf2_perf_tests(uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE);
+	uint8_t out_mac[TEE_SHA256_HASH_SIZE] = { };
+	uint8_t out_pads[TEE_SHA256_HASH_SIZE] = { };
+	TEE_Result res = TEE_SUCCESS;
+	TEE_Time start = { };
+	uint32_t iter = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	iter = params[0].value.a;
+	if (!iter)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = tee_time_get_sys_time(&start);
+	if (!res)
+		res = pbkdf2_mac(iter, out_mac);
+	if (res)
+		return res;
+	params[1].value.a = perf_rate(iter, perf_elapsed_ms(&start));
+
+	res = tee_time_get_sys_time(&start);
+	if (!res)
+		res = pbkdf2_pads(iter, out_pads);
+	if (res)
+		return res;
+	params[1].value.b = perf_rate(iter, perf_elapsed_ms(&start));
+
+	if (memcmp(out_mac, out_pads, sizeof(out_mac)))
+		return TEE_ERROR_GENERIC;
+
+	DMSG("PBKDF2-HMAC-SHA256 %"PRIu32" iterations: %"PRIu32
+	     " -> %"PRIu32" iterations/s", iter, params[1].value.a,
+	     params[1].value.b);
+
+	return TEE_SUCCESS;
+}
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <mbedtls/bignum.h>
+#include <util.h>
+
+#include "misc.h"
+
+uint32_t perf_elapsed_ms(const TEE_Time *start)
+{
+	TEE_Time now = { };
+	uint64_t ms = 0;
+
+	if (tee_time_get_sys_time(&now))
+		return 1;
+
+	ms = (now.seconds - start->seconds) * 1000ULL + now.millis -
+	     start->millis;
+
+	if (!ms)
+		return 1;
+	return MIN(ms, (uint64_t)UINT32_MAX);
+}
+
+uint32_t perf_rate(uint64_t count, uint32_t ms)
+{
+	uint64_t rate = count * 1000 / MAX(ms, 1U);
+
+	return MIN(rate, (uint64_t)UINT32_MAX);
+}
+
+int test_mpi_rng(void *ctx __unused, unsigned char *buf, size_t len)
+{
+	if (crypto_rng_read(buf, len))
+		return MBEDTLS_ERR_MPI_BAD_INPUT_DATA;
+	return 0;
+}
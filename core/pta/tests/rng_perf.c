@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <stdlib.h>
+#include <string_ext.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+#define MAX_REQ_SIZE	SIZE_1M
+
+TEE_Result core_rng_perf_tests(uint32_t param_types,
+			       TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE);
+	TEE_Result res = TEE_SUCCESS;
+	size_t req_size = 0;
+	unsigned int rep_count = 0;
+	TEE_Time start = { };
+	uint32_t ms = 0;
+	uint8_t *buf = NULL;
+	unsigned int n = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	req_size = params[0].value.a;
+	rep_count = params[0].value.b;
+	if (!req_size || req_size > MAX_REQ_SIZE || !rep_count)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf = malloc(req_size);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	res = tee_time_get_sys_time(&start);
+	if (res)
+		goto out;
+
+	for (n = 0; n < rep_count; n++) {
+		res = crypto_rng_read(buf, req_size);
+		if (res)
+			goto out;
+	}
+
+	ms = perf_elapsed_ms(&start);
+	params[1].value.a = perf_rate(rep_count, ms);
+	params[1].value.b = perf_rate((uint64_t)rep_count * req_size, ms);
+
+	DMSG("RNG %zu byte requests: %"PRIu32" calls/s, %"PRIu32" bytes/s",
+	     req_size, params[1].value.a, params[1].value.b);
+out:
+	memzero_explicit(buf, req_size);
+	free(buf);
+	return res;
+}
@@ -0,0 +1,156 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2021, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <stdlib.h>
+#include <string_ext.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+#define MAX_BUF_SIZE	SIZE_1M
+#define SM3_DIGEST_SIZE	32
+
+static const uint8_t sm4_key[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t sm4_iv[] = {
+	0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+	0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF
+};
+
+static TEE_Result sm3_perf(uint8_t *buf, size_t size, unsigned int rep_count)
+{
+	uint8_t digest[SM3_DIGEST_SIZE] = { };
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+	unsigned int n = 0;
+
+	res = crypto_hash_alloc_ctx(&ctx, TEE_ALG_SM3);
+	if (res)
+		return res;
+
+	for (n = 0; n < rep_count; n++) {
+		res = crypto_hash_init(ctx);
+		if (!res)
+			res = crypto_hash_update(ctx, buf, size);
+		if (!res)
+			res = crypto_hash_final(ctx, digest, sizeof(digest));
+		if (res)
+			break;
+	}
+
+	crypto_hash_free_ctx(ctx);
+	return res;
+}
+
+static TEE_Result sm4_perf(uint32_t algo, TEE_OperationMode mode,
+			   uint8_t *buf, size_t size, unsigned int rep_count)
+{
+	TEE_Result res = TEE_SUCCESS;
+	const uint8_t *iv = NULL;
+	size_t iv_len = 0;
+	void *ctx = NULL;
+	unsigned int n = 0;
+
+	if (algo != TEE_ALG_SM4_ECB_NOPAD) {
+		iv = sm4_iv;
+		iv_len = sizeof(sm4_iv);
+	}
+
+	res = crypto_cipher_alloc_ctx(&ctx, algo);
+	if (res)
+		return res;
+
+	res = crypto_cipher_init(ctx, mode, sm4_key, sizeof(sm4_key), NULL, 0,
+				 iv, iv_len);
+	if (res)
+		goto out;
+
+	for (n = 0; n < rep_count; n++) {
+		res = crypto_cipher_update(ctx, mode, false, buf, size, buf);
+		if (res)
+			break;
+	}
+
+	crypto_cipher_final(ctx);
+out:
+	crypto_cipher_free_ctx(ctx);
+	return res;
+}
+
+TEE_Result core_sm_perf_tests(uint32_t param_types,
+			      TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_OUTPUT,
+						   TEE_PARAM_TYPE_NONE);
+	TEE_OperationMode mode = TEE_MODE_ENCRYPT;
+	TEE_Result res = TEE_SUCCESS;
+	unsigned int rep_count = 0;
+	TEE_Time start = { };
+	uint8_t *buf = NULL;
+	size_t size = 0;
+	uint32_t ms = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (params[0].value.b)
+		mode = TEE_MODE_DECRYPT;
+	size = params[1].value.a;
+	rep_count = params[1].value.b;
+	if (!size || size > MAX_BUF_SIZE || size % 16 || !rep_count)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf = calloc(1, size);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	res = tee_time_get_sys_time(&start);
+	if (res)
+		goto out;
+
+	switch (params[0].value.a) {
+	case PTA_INVOKE_TESTS_SM3:
+		res = sm3_perf(buf, size, rep_count);
+		break;
+	case PTA_INVOKE_TESTS_SM4_ECB:
+		res = sm4_perf(TEE_ALG_SM4_ECB_NOPAD, mode, buf, size,
+			       rep_count);
+		break;
+	case PTA_INVOKE_TESTS_SM4_CBC:
+		res = sm4_perf(TEE_ALG_SM4_CBC_NOPAD, mode, buf, size,
+			       rep_count);
+		break;
+	case PTA_INVOKE_TESTS_SM4_CTR:
+		res = sm4_perf(TEE_ALG_SM4_CTR, mode, buf, size, rep_count);
+		break;
+	default:
+		res = TEE_ERROR_BAD_PARAMETERS;
+		break;
+	}
+	if (res)
+		goto out;
+
+	ms = perf_elapsed_ms(&start);
+	params[2].value.a = perf_rate((uint64_t)rep_count * size, ms);
+
+	DMSG("SM alg %"PRIu32" %zu byte buffers: %"PRIu32" bytes/s",
+	     params[0].value.a, size, params[2].value.a);
+out:
+	memzero_explicit(buf, size);
+	free(buf);
+	return res;
+}
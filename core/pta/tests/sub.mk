@@ -4,4 +4,10 @@ srcs-$(CFG_LOCKDEP) += lockdep.c
 srcs-y += misc.c
 cflags-misc.c-y += -fno-builtin
 srcs-y += mutex.c
+srcs-y += perf.c
 srcs-y += aes_perf.c
+srcs-y += sm_perf.c
+srcs-y += rng_perf.c
+srcs-y += mpi_perf.c
+srcs-$(CFG_CRYPTO_HMAC) += pbkdf2_perf.c
+srcs-$(CFG_CRYPTO_ECC) += ecc_perf.c
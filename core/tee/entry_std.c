@@ -4,6 +4,7 @@
  * Copyright (c) 2014, STMicroelectronics International N.V.
  */
 
+#include <arm.h>
 #include <assert.h>
 #include <bench.h>
 #include <compiler.h>
@@ -11,6 +12,7 @@
 #include <io.h>
 #include <kernel/linker.h>
 #include <kernel/msg_param.h>
+#include <kernel/mutex.h>
 #include <kernel/notif.h>
 #include <kernel/panic.h>
 #include <kernel/tee_misc.h>
@@ -19,7 +21,9 @@
 #include <mm/mobj.h>
 #include <optee_msg.h>
 #include <sm/optee_smc.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/queue.h>
 #include <tee/entry_std.h>
 #include <tee/tee_cryp_utl.h>
 #include <tee/uuid.h>
@@ -424,11 +428,17 @@ out:
 	arg->ret_origin = TEE_ORIGIN_TEE;
 }
 
-static void entry_invoke_command(struct optee_msg_arg *arg, uint32_t num_params)
+/*
+ * Invokes a command in session @s, or in the session referenced by @arg if
+ * @s is NULL. If @s is supplied the caller is expected to hold it with
+ * exclusive access.
+ */
+static void invoke_command(struct tee_ta_session *s, struct optee_msg_arg *arg,
+			   uint32_t num_params)
 {
 	TEE_Result res;
 	TEE_ErrorOrigin err_orig = TEE_ORIGIN_TEE;
-	struct tee_ta_session *s;
+	struct tee_ta_session *sess = s;
 	struct tee_ta_param param = { 0 };
 	uint64_t saved_attr[TEE_NUM_PARAMS] = { 0 };
 
@@ -443,18 +453,22 @@ static void entry_invoke_command(struct optee_msg_arg *arg, uint32_t num_params)
 	if (res != TEE_SUCCESS)
 		goto cleanup_shm_refs;
 
-	s = tee_ta_get_session(arg->session, true, &tee_open_sessions);
-	if (!s) {
-		res = TEE_ERROR_BAD_PARAMETERS;
-		goto cleanup_shm_refs;
+	if (!sess) {
+		sess = tee_ta_get_session(arg->session, true,
+					  &tee_open_sessions);
+		if (!sess) {
+			res = TEE_ERROR_BAD_PARAMETERS;
+			goto cleanup_shm_refs;
+		}
 	}
 
-	res = tee_ta_invoke_command(&err_orig, s, NSAPP_IDENTITY,
+	res = tee_ta_invoke_command(&err_orig, sess, NSAPP_IDENTITY,
 				    TEE_TIMEOUT_INFINITE, arg->func, &param);
 
 	bm_timestamp();
 
-	tee_ta_put_session(s);
+	if (!s)
+		tee_ta_put_session(sess);
 
 	copy_out_param(&param, num_params, arg->params, saved_attr);
 
@@ -466,6 +480,11 @@ out:
 	arg->ret_origin = err_orig;
 }
 
+static void entry_invoke_command(struct optee_msg_arg *arg, uint32_t num_params)
+{
+	invoke_command(NULL, arg, num_params);
+}
+
 static void entry_cancel(struct optee_msg_arg *arg, uint32_t num_params)
 {
 	TEE_Result res;
@@ -530,6 +549,290 @@ static void unregister_shm(struct optee_msg_arg *arg, uint32_t num_params)
 		arg->ret_origin = TEE_ORIGIN_TEE;
 	}
 }
+
+#ifdef CFG_CORE_INVOKE_RING
+/*
+ * An invoke ring is a struct optee_msg_ring header followed by slots of
+ * struct optee_msg_arg in registered shared memory, bound to one session.
+ * The ring stays mapped until it's unregistered or the session is closed.
+ *
+ * A ring is only registered or drained while holding its session
+ * exclusively, and tee_ta_close_session() releases it through
+ * release_invoke_ring() while holding the session the same way, so no ring
+ * outlives its session.
+ */
+struct invoke_ring {
+	struct mobj *mobj;
+	struct optee_msg_ring *hdr;
+	uint8_t *slots;
+	uint32_t session;
+	uint32_t num_entries;
+	uint32_t cons;
+	bool busy;
+	SLIST_ENTRY(invoke_ring) link;
+};
+
+static SLIST_HEAD(, invoke_ring) invoke_rings =
+	SLIST_HEAD_INITIALIZER(invoke_rings);
+static struct mutex invoke_ring_mu = MUTEX_INITIALIZER;
+static struct condvar invoke_ring_cv = CONDVAR_INITIALIZER;
+
+static struct invoke_ring *find_invoke_ring(uint32_t session)
+{
+	struct invoke_ring *r = NULL;
+
+	SLIST_FOREACH(r, &invoke_rings, link)
+		if (r->session == session)
+			return r;
+
+	return NULL;
+}
+
+static void free_invoke_ring(struct invoke_ring *r)
+{
+	mobj_dec_map(r->mobj);
+	mobj_put(r->mobj);
+	free(r);
+}
+
+/* Called with invoke_ring_mu held, returns with it held */
+static struct invoke_ring *unlink_invoke_ring(uint32_t session)
+{
+	struct invoke_ring *r = NULL;
+
+	while (true) {
+		r = find_invoke_ring(session);
+		if (!r || !r->busy)
+			break;
+		condvar_wait(&invoke_ring_cv, &invoke_ring_mu);
+	}
+
+	if (r)
+		SLIST_REMOVE(&invoke_rings, r, invoke_ring, link);
+
+	return r;
+}
+
+/*
+ * Registered with tee_ta_set_session_destroy_cb(), called by
+ * tee_ta_close_session() while holding the session exclusively.
+ */
+static void release_invoke_ring(struct tee_ta_session *s,
+				struct tee_ta_session_head *open_sessions)
+{
+	struct invoke_ring *r = NULL;
+
+	/* Only sessions opened from normal world may own a ring */
+	if (open_sessions != &tee_open_sessions)
+		return;
+
+	mutex_lock(&invoke_ring_mu);
+	r = unlink_invoke_ring(s->id);
+	mutex_unlock(&invoke_ring_mu);
+
+	if (r)
+		free_invoke_ring(r);
+}
+
+static void register_ring(struct optee_msg_arg *arg, uint32_t num_params)
+{
+	TEE_Result res = TEE_ERROR_BAD_PARAMETERS;
+	struct optee_msg_ring *hdr = NULL;
+	struct tee_ta_session *s = NULL;
+	struct param_mem mem = { };
+	struct invoke_ring *r = NULL;
+	uint32_t num_entries = 0;
+	size_t ring_size = 0;
+
+	if (num_params != 1 ||
+	    READ_ONCE(arg->params[0].attr) != OPTEE_MSG_ATTR_TYPE_RMEM_INOUT)
+		goto out;
+
+	/* Only a session opened from normal world may own a ring */
+	s = tee_ta_get_session(arg->session, true, &tee_open_sessions);
+	if (!s)
+		goto out;
+
+	res = set_rmem_param(&arg->params[0].u.rmem, &mem);
+	if (res)
+		goto out_put_mobj;
+
+	res = mobj_inc_map(mem.mobj);
+	if (res)
+		goto out_put_mobj;
+
+	res = TEE_ERROR_BAD_PARAMETERS;
+	hdr = mobj_get_va(mem.mobj, mem.offs, mem.size);
+	if (!hdr || mem.size < sizeof(*hdr) ||
+	    !IS_ALIGNED_WITH_TYPE(hdr, uint64_t))
+		goto out_dec_map;
+
+	/* The ring geometry is read once and kept in secure memory */
+	num_entries = READ_ONCE(hdr->num_entries);
+	if (!num_entries || !IS_POWER_OF_TWO(num_entries) ||
+	    MUL_OVERFLOW(num_entries, OPTEE_MSG_RING_SLOT_SIZE, &ring_size) ||
+	    ADD_OVERFLOW(ring_size, sizeof(*hdr), &ring_size) ||
+	    ring_size > mem.size)
+		goto out_dec_map;
+
+	r = calloc(1, sizeof(*r));
+	if (!r) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out_dec_map;
+	}
+	r->mobj = mem.mobj;
+	r->hdr = hdr;
+	r->slots = (uint8_t *)(hdr + 1);
+	r->session = arg->session;
+	r->num_entries = num_entries;
+	r->cons = READ_ONCE(hdr->cons);
+
+	mutex_lock(&invoke_ring_mu);
+	if (find_invoke_ring(r->session)) {
+		res = TEE_ERROR_BAD_STATE;
+	} else {
+		SLIST_INSERT_HEAD(&invoke_rings, r, link);
+		res = TEE_SUCCESS;
+	}
+	mutex_unlock(&invoke_ring_mu);
+
+	if (!res)
+		goto out_put_sess;
+
+	free(r);
+out_dec_map:
+	mobj_dec_map(mem.mobj);
+out_put_mobj:
+	mobj_put(mem.mobj);
+out_put_sess:
+	tee_ta_put_session(s);
+out:
+	arg->ret = res;
+	arg->ret_origin = TEE_ORIGIN_TEE;
+}
+
+static struct optee_msg_arg *ring_slot(struct invoke_ring *r, uint32_t idx)
+{
+	size_t offs = (idx & (r->num_entries - 1)) * OPTEE_MSG_RING_SLOT_SIZE;
+
+	return (struct optee_msg_arg *)(r->slots + offs);
+}
+
+static void drain_ring_slot(struct invoke_ring *r, struct tee_ta_session *s,
+			    struct optee_msg_arg *slot)
+{
+	uint32_t num_params = READ_ONCE(slot->num_params);
+
+	if (READ_ONCE(slot->cmd) != OPTEE_MSG_CMD_INVOKE_COMMAND ||
+	    READ_ONCE(slot->session) != r->session ||
+	    num_params > OPTEE_MSG_RING_NUM_PARAMS) {
+		slot->ret = TEE_ERROR_BAD_PARAMETERS;
+		slot->ret_origin = TEE_ORIGIN_TEE;
+		return;
+	}
+
+	invoke_command(s, slot, num_params);
+}
+
+static void drain_ring(struct optee_msg_arg *arg, uint32_t num_params)
+{
+	TEE_Result res = TEE_ERROR_BAD_PARAMETERS;
+	struct tee_ta_session *s = NULL;
+	struct invoke_ring *r = NULL;
+	uint32_t count = 0;
+	uint32_t prod = 0;
+
+	if (num_params)
+		goto out;
+
+	s = tee_ta_get_session(arg->session, true, &tee_open_sessions);
+	if (!s)
+		goto out;
+
+	mutex_lock(&invoke_ring_mu);
+	r = find_invoke_ring(arg->session);
+	if (r) {
+		if (r->busy) {
+			res = TEE_ERROR_BUSY;
+			r = NULL;
+		} else {
+			r->busy = true;
+		}
+	}
+	mutex_unlock(&invoke_ring_mu);
+	if (!r)
+		goto out_put;
+
+	/*
+	 * Process at most one ring worth of requests per call to bound
+	 * the time spent here, normal world checks hdr->cons to see how
+	 * far we got.
+	 */
+	res = TEE_SUCCESS;
+	while (count < r->num_entries) {
+		prod = READ_ONCE(r->hdr->prod);
+		/* Slots must not be read before prod is */
+		dsb_ish();
+		if (prod == r->cons)
+			break;
+		if (prod - r->cons > r->num_entries) {
+			res = TEE_ERROR_BAD_STATE;
+			break;
+		}
+
+		while (r->cons != prod && count < r->num_entries) {
+			drain_ring_slot(r, s, ring_slot(r, r->cons));
+			r->cons++;
+			count++;
+			/* Publish the result before the consumer index */
+			dsb_ish();
+			WRITE_ONCE(r->hdr->cons, r->cons);
+		}
+	}
+
+	mutex_lock(&invoke_ring_mu);
+	r->busy = false;
+	condvar_broadcast(&invoke_ring_cv);
+	mutex_unlock(&invoke_ring_mu);
+out_put:
+	tee_ta_put_session(s);
+out:
+	arg->ret = res;
+	arg->ret_origin = TEE_ORIGIN_TEE;
+}
+
+static void unregister_ring(struct optee_msg_arg *arg, uint32_t num_params)
+{
+	struct invoke_ring *r = NULL;
+
+	arg->ret_origin = TEE_ORIGIN_TEE;
+	if (num_params) {
+		arg->ret = TEE_ERROR_BAD_PARAMETERS;
+		return;
+	}
+
+	mutex_lock(&invoke_ring_mu);
+	r = unlink_invoke_ring(arg->session);
+	mutex_unlock(&invoke_ring_mu);
+
+	if (!r) {
+		arg->ret = TEE_ERROR_ITEM_NOT_FOUND;
+		return;
+	}
+
+	free_invoke_ring(r);
+	arg->ret = TEE_SUCCESS;
+}
+
+static TEE_Result invoke_ring_init(void)
+{
+	tee_ta_set_session_destroy_cb(release_invoke_ring);
+
+	return TEE_SUCCESS;
+}
+
+service_init(invoke_ring_init);
+#endif /*CFG_CORE_INVOKE_RING*/
 #endif /*CFG_CORE_DYN_SHM*/
 #endif
 
@@ -575,6 +878,17 @@ uint32_t __tee_entry_std(struct optee_msg_arg *arg, uint32_t num_params)
 	case OPTEE_MSG_CMD_UNREGISTER_SHM:
 		unregister_shm(arg, num_params);
 		break;
+#ifdef CFG_CORE_INVOKE_RING
+	case OPTEE_MSG_CMD_REGISTER_RING:
+		register_ring(arg, num_params);
+		break;
+	case OPTEE_MSG_CMD_DRAIN_RING:
+		drain_ring(arg, num_params);
+		break;
+	case OPTEE_MSG_CMD_UNREGISTER_RING:
+		unregister_ring(arg, num_params);
+		break;
+#endif
 #endif
 #endif
 
@@ -6,66 +6,60 @@
 #include <crypto/crypto.h>
 #include <stdlib.h>
 #include <string.h>
+#include <string_ext.h>
 #include <tee/tee_cryp_pbkdf2.h>
 #include <tee/tee_cryp_utl.h>
 #include <utee_defines.h>
 
-struct hmac_parms {
-	uint32_t algo;
-	size_t hash_len;
-	void *ctx;
-};
-
 struct pbkdf2_parms {
-	const uint8_t *password;
-	size_t password_len;
 	const uint8_t *salt;
 	size_t salt_len;
 	uint32_t iteration_count;
 };
 
 static TEE_Result pbkdf2_f(uint8_t *out, size_t len, uint32_t idx,
-			   struct hmac_parms *h, struct pbkdf2_parms *p)
+			   struct crypto_hmac_pads *h, struct pbkdf2_parms *p)
 {
-	TEE_Result res;
+	TEE_Result res = TEE_SUCCESS;
 	uint8_t u[TEE_MAX_HASH_SIZE];
 	uint32_t be_index;
 	size_t i, j;
 
 	memset(out, 0, len);
 	for (i = 1; i <= p->iteration_count; i++) {
-		res = crypto_mac_init(h->ctx, p->password, p->password_len);
-		if (res != TEE_SUCCESS)
-			return res;
+		/* The pads were derived from the password in tee_cryp_pbkdf2() */
+		crypto_hmac_pads_start(h);
 
 		if (i == 1) {
 			if (p->salt && p->salt_len) {
-				res = crypto_mac_update(h->ctx, p->salt,
-							p->salt_len);
+				res = crypto_hmac_pads_update(h, p->salt,
+							      p->salt_len);
 				if (res != TEE_SUCCESS)
-					return res;
+					goto out;
 			}
 
 			be_index = TEE_U32_TO_BIG_ENDIAN(idx);
 
-			res = crypto_mac_update(h->ctx, (uint8_t *)&be_index,
-						sizeof(be_index));
+			res = crypto_hmac_pads_update(h, (uint8_t *)&be_index,
+						      sizeof(be_index));
 			if (res != TEE_SUCCESS)
-				return res;
+				goto out;
 		} else {
-			res = crypto_mac_update(h->ctx, u, h->hash_len);
+			res = crypto_hmac_pads_update(h, u, h->digest_len);
 			if (res != TEE_SUCCESS)
-				return res;
+				goto out;
 		}
 
-		res = crypto_mac_final(h->ctx, u, sizeof(u));
+		res = crypto_hmac_pads_final(h, u);
 		if (res != TEE_SUCCESS)
-			return res;
+			goto out;
 
 		for (j = 0; j < len; j++)
 			out[j] ^= u[j];
 	}
-	return TEE_SUCCESS;
+out:
+	memzero_explicit(u, sizeof(u));
+	return res;
 }
 
 TEE_Result tee_cryp_pbkdf2(uint32_t hash_id, const uint8_t *password,
@@ -77,38 +71,30 @@ TEE_Result tee_cryp_pbkdf2(uint32_t hash_id, const uint8_t *password,
 	size_t i, l, r;
 	uint8_t *out = derived_key;
 	struct pbkdf2_parms pbkdf2_parms;
-	struct hmac_parms hmac_parms = {0, };
-
-	hmac_parms.algo = TEE_ALG_HMAC_ALGO(hash_id);
-
-	res = tee_alg_get_digest_size(hmac_parms.algo, &hmac_parms.hash_len);
-	if (res != TEE_SUCCESS)
-		return res;
+	struct crypto_hmac_pads pads = { };
 
-	res = crypto_mac_alloc_ctx(&hmac_parms.ctx, hmac_parms.algo);
+	res = crypto_hmac_pads_init(&pads, TEE_ALG_HASH_ALGO(hash_id),
+				    password, password_len);
 	if (res != TEE_SUCCESS)
 		return res;
 
-	pbkdf2_parms.password = password;
-	pbkdf2_parms.password_len = password_len;
 	pbkdf2_parms.salt = salt;
 	pbkdf2_parms.salt_len = salt_len;
 	pbkdf2_parms.iteration_count = iteration_count;
 
-	l = derived_key_len / hmac_parms.hash_len;
-	r = derived_key_len % hmac_parms.hash_len;
+	l = derived_key_len / pads.digest_len;
+	r = derived_key_len % pads.digest_len;
 
 	for (i = 1; i <= l; i++) {
-		res = pbkdf2_f(out, hmac_parms.hash_len, i, &hmac_parms,
-			       &pbkdf2_parms);
+		res = pbkdf2_f(out, pads.digest_len, i, &pads, &pbkdf2_parms);
 		if (res != TEE_SUCCESS)
 			goto out;
-		out += hmac_parms.hash_len;
+		out += pads.digest_len;
 	}
 	if (r)
-		res = pbkdf2_f(out, r, i, &hmac_parms, &pbkdf2_parms);
+		res = pbkdf2_f(out, r, i, &pads, &pbkdf2_parms);
 
 out:
-	crypto_mac_free_ctx(hmac_parms.ctx);
+	crypto_hmac_pads_free(&pads);
 	return res;
 }
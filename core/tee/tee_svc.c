@@ -7,6 +7,7 @@
 #include <compiler.h>
 #include <kernel/chip_services.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/spinlock.h>
 #include <kernel/tee_common.h>
 #include <kernel/tee_common_otp.h>
 #include <kernel/tee_ta_manager.h>
@@ -29,6 +30,36 @@
 
 vaddr_t tee_svc_uref_base;
 
+static struct tee_svc_param_copy_stats param_copy_stats;
+static unsigned int param_copy_stats_lock = SPINLOCK_UNLOCK;
+
+static void count_param_request(bool bounced, size_t bytes_in)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&param_copy_stats_lock);
+
+	param_copy_stats.num_requests++;
+	if (bounced)
+		param_copy_stats.num_copied++;
+	param_copy_stats.bytes_in += bytes_in;
+	cpu_spin_unlock_xrestore(&param_copy_stats_lock, exceptions);
+}
+
+static void count_param_copy_out(size_t bytes_out)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&param_copy_stats_lock);
+
+	param_copy_stats.bytes_out += bytes_out;
+	cpu_spin_unlock_xrestore(&param_copy_stats_lock, exceptions);
+}
+
+void tee_svc_get_param_copy_stats(struct tee_svc_param_copy_stats *stats)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&param_copy_stats_lock);
+
+	*stats = param_copy_stats;
+	cpu_spin_unlock_xrestore(&param_copy_stats_lock, exceptions);
+}
+
 void syscall_log(const void *buf __maybe_unused, size_t len __maybe_unused)
 {
 #ifdef CFG_TEE_CORE_TA_TRACE
@@ -624,6 +655,7 @@ static TEE_Result tee_svc_copy_param(struct ts_session *sess,
 	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
 	bool ta_private_memref[TEE_NUM_PARAMS] = { false, };
 	TEE_Result res = TEE_SUCCESS;
+	size_t bytes_in = 0;
 	size_t dst_offs = 0;
 	size_t req_mem = 0;
 	uint8_t *dst = 0;
@@ -651,6 +683,7 @@ static TEE_Result tee_svc_copy_param(struct ts_session *sess,
 
 	if (called_sess && is_pseudo_ta_ctx(called_sess->ctx)) {
 		/* pseudo TA borrows the mapping of the calling TA */
+		count_param_request(false, 0);
 		return TEE_SUCCESS;
 	}
 
@@ -691,8 +724,10 @@ static TEE_Result tee_svc_copy_param(struct ts_session *sess,
 		}
 	}
 
-	if (req_mem == 0)
+	if (req_mem == 0) {
+		count_param_request(false, 0);
 		return TEE_SUCCESS;
+	}
 
 	res = alloc_temp_sec_mem(req_mem, mobj_tmp, &dst);
 	if (res != TEE_SUCCESS)
@@ -721,6 +756,7 @@ static TEE_Result tee_svc_copy_param(struct ts_session *sess,
 				tmp_buf_size[n] = param->u[n].mem.size;
 				dst += s;
 				dst_offs += s;
+				bytes_in += param->u[n].mem.size;
 			}
 			break;
 
@@ -741,6 +777,8 @@ static TEE_Result tee_svc_copy_param(struct ts_session *sess,
 		}
 	}
 
+	count_param_request(true, bytes_in);
+
 	return TEE_SUCCESS;
 }
 
@@ -786,6 +824,7 @@ static TEE_Result tee_svc_update_out_param(
 					res = copy_to_user(dst, src, sz);
 					if (res != TEE_SUCCESS)
 						return res;
+					count_param_copy_out(sz);
 				}
 			}
 			usr_param->vals[n * 2 + 1] = sz;
@@ -50,6 +50,9 @@ struct tee_cryp_state {
 	void *ctx;
 	tee_cryp_ctx_finalize_func_t ctx_finalize;
 	enum cryp_state state;
+	/* Generations of the keys ctx holds the key schedule of, 0 if none */
+	uint64_t key1_gen;
+	uint64_t key2_gen;
 };
 
 struct tee_cryp_obj_secret {
@@ -78,6 +81,10 @@ struct tee_cryp_obj_secret {
 #define ATTR_OPS_INDEX_BIGNUM     1
     /* Convert to/from value attribute depending on direction */
 #define ATTR_OPS_INDEX_VALUE      2
+    /* Fixed size 32 bytes buffer of a Curve25519 key */
+#define ATTR_OPS_INDEX_25519      3
+
+#define KEY_SIZE_BYTES_25519	32
 
 struct tee_cryp_obj_type_attrs {
 	uint32_t attr_id;
@@ -383,6 +390,54 @@ static const struct tee_cryp_obj_type_attrs tee_cryp_obj_ecc_keypair_attrs[] = {
 	},
 };
 
+#if defined(CFG_CRYPTO_X25519)
+static const struct tee_cryp_obj_type_attrs
+	tee_cryp_obj_x25519_keypair_attrs[] = {
+	{
+	.attr_id = TEE_ATTR_X25519_PRIVATE_VALUE,
+	.flags = TEE_TYPE_ATTR_REQUIRED,
+	.ops_index = ATTR_OPS_INDEX_25519,
+	RAW_DATA(struct x25519_keypair, priv)
+	},
+
+	{
+	.attr_id = TEE_ATTR_X25519_PUBLIC_VALUE,
+	.flags = TEE_TYPE_ATTR_REQUIRED,
+	.ops_index = ATTR_OPS_INDEX_25519,
+	RAW_DATA(struct x25519_keypair, pub)
+	},
+};
+#endif
+
+#if defined(CFG_CRYPTO_ED25519)
+static const struct tee_cryp_obj_type_attrs
+	tee_cryp_obj_ed25519_pub_key_attrs[] = {
+	{
+	.attr_id = TEE_ATTR_ED25519_PUBLIC_VALUE,
+	.flags = TEE_TYPE_ATTR_REQUIRED,
+	.ops_index = ATTR_OPS_INDEX_25519,
+	RAW_DATA(struct ed25519_public_key, pub)
+	},
+};
+
+static const struct tee_cryp_obj_type_attrs
+	tee_cryp_obj_ed25519_keypair_attrs[] = {
+	{
+	.attr_id = TEE_ATTR_ED25519_PRIVATE_VALUE,
+	.flags = TEE_TYPE_ATTR_REQUIRED,
+	.ops_index = ATTR_OPS_INDEX_25519,
+	RAW_DATA(struct ed25519_keypair, priv)
+	},
+
+	{
+	.attr_id = TEE_ATTR_ED25519_PUBLIC_VALUE,
+	.flags = TEE_TYPE_ATTR_REQUIRED,
+	.ops_index = ATTR_OPS_INDEX_25519,
+	RAW_DATA(struct ed25519_keypair, pub)
+	},
+};
+#endif
+
 struct tee_cryp_obj_type_props {
 	TEE_ObjectType obj_type;
 	uint16_t min_size;	/* may not be smaller than this */
@@ -413,6 +468,9 @@ static const struct tee_cryp_obj_type_props tee_cryp_obj_props[] = {
 	PROP(TEE_TYPE_SM4, 128, 128, 128,
 		128 / 8 + sizeof(struct tee_cryp_obj_secret),
 		tee_cryp_obj_secret_value_attrs),
+	PROP(TEE_TYPE_CHACHA20, 8, 256, 256,
+		256 / 8 + sizeof(struct tee_cryp_obj_secret),
+		tee_cryp_obj_secret_value_attrs),
 	PROP(TEE_TYPE_HMAC_MD5, 8, 64, 512,
 		512 / 8 + sizeof(struct tee_cryp_obj_secret),
 		tee_cryp_obj_secret_value_attrs),
@@ -511,6 +569,22 @@ static const struct tee_cryp_obj_type_props tee_cryp_obj_props[] = {
 	PROP(TEE_TYPE_SM2_KEP_KEYPAIR, 1, 256, 256,
 	     sizeof(struct ecc_keypair),
 	     tee_cryp_obj_ecc_keypair_attrs),
+
+#if defined(CFG_CRYPTO_X25519)
+	PROP(TEE_TYPE_X25519_KEYPAIR, 1, 256, 256,
+	     sizeof(struct x25519_keypair),
+	     tee_cryp_obj_x25519_keypair_attrs),
+#endif
+
+#if defined(CFG_CRYPTO_ED25519)
+	PROP(TEE_TYPE_ED25519_PUBLIC_KEY, 1, 256, 256,
+	     sizeof(struct ed25519_public_key),
+	     tee_cryp_obj_ed25519_pub_key_attrs),
+
+	PROP(TEE_TYPE_ED25519_KEYPAIR, 1, 256, 256,
+	     sizeof(struct ed25519_keypair),
+	     tee_cryp_obj_ed25519_keypair_attrs),
+#endif
 };
 
 struct attr_ops {
@@ -832,6 +906,106 @@ static void op_attr_value_clear(void *attr)
 	*v = 0;
 }
 
+static TEE_Result op_attr_25519_from_user(void *attr, const void *buffer,
+					  size_t size)
+{
+	uint8_t **key = attr;
+
+	if (size != KEY_SIZE_BYTES_25519 || !*key)
+		return TEE_ERROR_SECURITY;
+
+	memcpy(*key, buffer, size);
+	return TEE_SUCCESS;
+}
+
+static TEE_Result op_attr_25519_to_user(void *attr,
+					struct ts_session *sess __unused,
+					void *buffer, uint64_t *size)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t **key = attr;
+	uint64_t s = 0;
+	uint64_t key_size = KEY_SIZE_BYTES_25519;
+
+	res = copy_from_user(&s, size, sizeof(s));
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = copy_to_user(size, &key_size, sizeof(key_size));
+	if (res != TEE_SUCCESS)
+		return res;
+
+	if (s < key_size || !buffer)
+		return TEE_ERROR_SHORT_BUFFER;
+
+	return copy_to_user(buffer, *key, key_size);
+}
+
+static TEE_Result op_attr_25519_to_binary(void *attr, void *data,
+					  size_t data_len, size_t *offs)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t **key = attr;
+	size_t next_offs = 0;
+
+	res = op_u32_to_binary_helper(KEY_SIZE_BYTES_25519, data, data_len,
+				      offs);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	if (ADD_OVERFLOW(*offs, KEY_SIZE_BYTES_25519, &next_offs))
+		return TEE_ERROR_OVERFLOW;
+
+	if (data && next_offs <= data_len)
+		memcpy((uint8_t *)data + *offs, *key, KEY_SIZE_BYTES_25519);
+	(*offs) = next_offs;
+
+	return TEE_SUCCESS;
+}
+
+static bool op_attr_25519_from_binary(void *attr, const void *data,
+				      size_t data_len, size_t *offs)
+{
+	uint8_t **key = attr;
+	uint32_t s = 0;
+
+	if (!op_u32_from_binary_helper(&s, data, data_len, offs))
+		return false;
+
+	if (s != KEY_SIZE_BYTES_25519 || (*offs + s) > data_len)
+		return false;
+
+	memcpy(*key, (const uint8_t *)data + *offs, s);
+	(*offs) += s;
+	return true;
+}
+
+static TEE_Result op_attr_25519_from_obj(void *attr, void *src_attr)
+{
+	uint8_t **key = attr;
+	uint8_t **src_key = src_attr;
+
+	memcpy(*key, *src_key, KEY_SIZE_BYTES_25519);
+	return TEE_SUCCESS;
+}
+
+static void op_attr_25519_clear(void *attr)
+{
+	uint8_t **key = attr;
+
+	if (*key)
+		memzero_explicit(*key, KEY_SIZE_BYTES_25519);
+}
+
+static void op_attr_25519_free(void *attr)
+{
+	uint8_t **key = attr;
+
+	op_attr_25519_clear(attr);
+	free(*key);
+	*key = NULL;
+}
+
 static const struct attr_ops attr_ops[] = {
 	[ATTR_OPS_INDEX_SECRET] = {
 		.from_user = op_attr_secret_value_from_user,
@@ -860,6 +1034,15 @@ static const struct attr_ops attr_ops[] = {
 		.free = op_attr_value_clear, /* not a typo */
 		.clear = op_attr_value_clear,
 	},
+	[ATTR_OPS_INDEX_25519] = {
+		.from_user = op_attr_25519_from_user,
+		.to_user = op_attr_25519_to_user,
+		.to_binary = op_attr_25519_to_binary,
+		.from_binary = op_attr_25519_from_binary,
+		.from_obj = op_attr_25519_from_obj,
+		.free = op_attr_25519_free,
+		.clear = op_attr_25519_clear,
+	},
 };
 
 static TEE_Result get_user_u64_as_size_t(size_t *dst, uint64_t *src)
@@ -954,6 +1137,7 @@ static void set_attribute(struct tee_obj *o,
 	if (idx < 0)
 		return;
 	o->have_attrs |= BIT(idx);
+	o->generation++;
 }
 
 /* Get an attribute on an object */
@@ -1018,6 +1202,10 @@ void tee_obj_attr_free(struct tee_obj *o)
 	if (!tp)
 		return;
 
+	if (o->info.objectType == TEE_TYPE_RSA_KEYPAIR)
+		crypto_acipher_clear_rsa_keypair_cache(o->attr);
+	o->generation++;
+
 	for (n = 0; n < tp->num_type_attrs; n++) {
 		const struct tee_cryp_obj_type_attrs *ta = tp->type_attrs + n;
 
@@ -1036,6 +1224,10 @@ void tee_obj_attr_clear(struct tee_obj *o)
 	if (!tp)
 		return;
 
+	if (o->info.objectType == TEE_TYPE_RSA_KEYPAIR)
+		crypto_acipher_clear_rsa_keypair_cache(o->attr);
+	o->generation++;
+
 	for (n = 0; n < tp->num_type_attrs; n++) {
 		const struct tee_cryp_obj_type_attrs *ta = tp->type_attrs + n;
 
@@ -1093,6 +1285,7 @@ TEE_Result tee_obj_attr_from_binary(struct tee_obj *o, const void *data,
 	if (!tp)
 		return TEE_ERROR_BAD_STATE;
 
+	o->generation++;
 	for (n = 0; n < tp->num_type_attrs; n++) {
 		const struct tee_cryp_obj_type_attrs *ta = tp->type_attrs + n;
 		void *attr = (uint8_t *)o->attr + ta->raw_offs;
@@ -1122,6 +1315,7 @@ TEE_Result tee_obj_attr_copy_from(struct tee_obj *o, const struct tee_obj *src)
 	if (!tp)
 		return TEE_ERROR_BAD_STATE;
 
+	o->generation++;
 	if (o->info.objectType == src->info.objectType) {
 		have_attrs = src->have_attrs;
 		for (n = 0; n < tp->num_type_attrs; n++) {
@@ -1157,6 +1351,9 @@ TEE_Result tee_obj_attr_copy_from(struct tee_obj *o, const struct tee_obj *src)
 		} else if (o->info.objectType == TEE_TYPE_SM2_KEP_PUBLIC_KEY) {
 			if (src->info.objectType != TEE_TYPE_SM2_KEP_KEYPAIR)
 				return TEE_ERROR_BAD_PARAMETERS;
+		} else if (o->info.objectType == TEE_TYPE_ED25519_PUBLIC_KEY) {
+			if (src->info.objectType != TEE_TYPE_ED25519_KEYPAIR)
+				return TEE_ERROR_BAD_PARAMETERS;
 		} else {
 			return TEE_ERROR_BAD_PARAMETERS;
 		}
@@ -1286,6 +1483,18 @@ TEE_Result tee_obj_set_type(struct tee_obj *o, uint32_t obj_type,
 		res = crypto_acipher_alloc_ecc_keypair(o->attr, obj_type,
 						       max_key_size);
 		break;
+	case TEE_TYPE_X25519_KEYPAIR:
+		res = crypto_acipher_alloc_x25519_keypair(o->attr,
+							  max_key_size);
+		break;
+	case TEE_TYPE_ED25519_PUBLIC_KEY:
+		res = crypto_acipher_alloc_ed25519_public_key(o->attr,
+							      max_key_size);
+		break;
+	case TEE_TYPE_ED25519_KEYPAIR:
+		res = crypto_acipher_alloc_ed25519_keypair(o->attr,
+							   max_key_size);
+		break;
 	default:
 		if (obj_type != TEE_TYPE_DATA) {
 			struct tee_cryp_obj_secret *key = o->attr;
@@ -1558,6 +1767,7 @@ static TEE_Result tee_svc_cryp_obj_populate_type(
 	const struct attr_ops *ops = NULL;
 	void *attr = NULL;
 
+	o->generation++;
 	for (n = 0; n < attr_count; n++) {
 		idx = tee_svc_cryp_obj_find_type_attr_idx(
 							attrs[n].attributeID,
@@ -1787,6 +1997,7 @@ static TEE_Result tee_svc_obj_generate_key_rsa(
 
 	/* Set bits for all known attributes for this object type */
 	o->have_attrs = (1 << type_props->num_type_attrs) - 1;
+	o->generation++;
 
 	return TEE_SUCCESS;
 }
@@ -1809,6 +2020,7 @@ static TEE_Result tee_svc_obj_generate_key_dsa(
 
 	/* Set bits for all known attributes for this object type */
 	o->have_attrs = (1 << type_props->num_type_attrs) - 1;
+	o->generation++;
 
 	return TEE_SUCCESS;
 }
@@ -1872,6 +2084,50 @@ static TEE_Result tee_svc_obj_generate_key_ecc(
 	return TEE_SUCCESS;
 }
 
+static TEE_Result tee_svc_obj_generate_key_x25519(
+	struct tee_obj *o, const struct tee_cryp_obj_type_props *type_props,
+	uint32_t key_size, const TEE_Attribute *params, uint32_t param_count)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	/* Copy the present attributes into the obj before starting */
+	res = tee_svc_cryp_obj_populate_type(o, type_props, params,
+					     param_count);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = crypto_acipher_gen_x25519_key(o->attr, key_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	/* Set bits for the generated public and private key */
+	set_attribute(o, type_props, TEE_ATTR_X25519_PRIVATE_VALUE);
+	set_attribute(o, type_props, TEE_ATTR_X25519_PUBLIC_VALUE);
+	return TEE_SUCCESS;
+}
+
+static TEE_Result tee_svc_obj_generate_key_ed25519(
+	struct tee_obj *o, const struct tee_cryp_obj_type_props *type_props,
+	uint32_t key_size, const TEE_Attribute *params, uint32_t param_count)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	/* Copy the present attributes into the obj before starting */
+	res = tee_svc_cryp_obj_populate_type(o, type_props, params,
+					     param_count);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = crypto_acipher_gen_ed25519_key(o->attr, key_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	/* Set bits for the generated public and private key */
+	set_attribute(o, type_props, TEE_ATTR_ED25519_PRIVATE_VALUE);
+	set_attribute(o, type_props, TEE_ATTR_ED25519_PUBLIC_VALUE);
+	return TEE_SUCCESS;
+}
+
 TEE_Result syscall_obj_generate_key(unsigned long obj, unsigned long key_size,
 			const struct utee_attribute *usr_params,
 			unsigned long param_count)
@@ -1928,6 +2184,7 @@ TEE_Result syscall_obj_generate_key(unsigned long obj, unsigned long key_size,
 	case TEE_TYPE_DES:
 	case TEE_TYPE_DES3:
 	case TEE_TYPE_SM4:
+	case TEE_TYPE_CHACHA20:
 	case TEE_TYPE_HMAC_MD5:
 	case TEE_TYPE_HMAC_SHA1:
 	case TEE_TYPE_HMAC_SHA224:
@@ -1951,6 +2208,7 @@ TEE_Result syscall_obj_generate_key(unsigned long obj, unsigned long key_size,
 			goto out;
 		}
 
+		o->generation++;
 		res = crypto_rng_read((void *)(key + 1), byte_size);
 		if (res != TEE_SUCCESS)
 			goto out;
@@ -1963,22 +2221,28 @@ TEE_Result syscall_obj_generate_key(unsigned long obj, unsigned long key_size,
 		break;
 
 	case TEE_TYPE_RSA_KEYPAIR:
+		crypto_bignum_arena_begin(key_size);
 		res = tee_svc_obj_generate_key_rsa(o, type_props, key_size,
 						   params, param_count);
+		crypto_bignum_arena_end();
 		if (res != TEE_SUCCESS)
 			goto out;
 		break;
 
 	case TEE_TYPE_DSA_KEYPAIR:
+		crypto_bignum_arena_begin(key_size);
 		res = tee_svc_obj_generate_key_dsa(o, type_props, key_size,
 						   params, param_count);
+		crypto_bignum_arena_end();
 		if (res != TEE_SUCCESS)
 			goto out;
 		break;
 
 	case TEE_TYPE_DH_KEYPAIR:
+		crypto_bignum_arena_begin(key_size);
 		res = tee_svc_obj_generate_key_dh(o, type_props, key_size,
 						  params, param_count);
+		crypto_bignum_arena_end();
 		if (res != TEE_SUCCESS)
 			goto out;
 		break;
@@ -1986,8 +2250,24 @@ TEE_Result syscall_obj_generate_key(unsigned long obj, unsigned long key_size,
 	case TEE_TYPE_ECDSA_KEYPAIR:
 	case TEE_TYPE_ECDH_KEYPAIR:
 	case TEE_TYPE_SM2_PKE_KEYPAIR:
+		crypto_bignum_arena_begin(key_size);
 		res = tee_svc_obj_generate_key_ecc(o, type_props, key_size,
 						  params, param_count);
+		crypto_bignum_arena_end();
+		if (res != TEE_SUCCESS)
+			goto out;
+		break;
+
+	case TEE_TYPE_X25519_KEYPAIR:
+		res = tee_svc_obj_generate_key_x25519(o, type_props, key_size,
+						      params, param_count);
+		if (res != TEE_SUCCESS)
+			goto out;
+		break;
+
+	case TEE_TYPE_ED25519_KEYPAIR:
+		res = tee_svc_obj_generate_key_ed25519(o, type_props, key_size,
+						       params, param_count);
 		if (res != TEE_SUCCESS)
 			goto out;
 		break;
@@ -2095,6 +2375,9 @@ static TEE_Result tee_svc_cryp_check_key_type(const struct tee_obj *o,
 	case TEE_MAIN_ALGO_SM4:
 		req_key_type = TEE_TYPE_SM4;
 		break;
+	case TEE_MAIN_ALGO_CHACHA20:
+		req_key_type = TEE_TYPE_CHACHA20;
+		break;
 	case TEE_MAIN_ALGO_RSA:
 		req_key_type = TEE_TYPE_RSA_KEYPAIR;
 		if (mode == TEE_MODE_ENCRYPT || mode == TEE_MODE_VERIFY)
@@ -2116,6 +2399,14 @@ static TEE_Result tee_svc_cryp_check_key_type(const struct tee_obj *o,
 	case TEE_MAIN_ALGO_ECDH:
 		req_key_type = TEE_TYPE_ECDH_KEYPAIR;
 		break;
+	case TEE_MAIN_ALGO_ED25519:
+		req_key_type = TEE_TYPE_ED25519_KEYPAIR;
+		if (mode == TEE_MODE_VERIFY)
+			req_key_type2 = TEE_TYPE_ED25519_PUBLIC_KEY;
+		break;
+	case TEE_MAIN_ALGO_X25519:
+		req_key_type = TEE_TYPE_X25519_KEYPAIR;
+		break;
 	case TEE_MAIN_ALGO_SM2_PKE:
 		if (mode == TEE_MODE_ENCRYPT)
 			req_key_type = TEE_TYPE_SM2_PKE_PUBLIC_KEY;
@@ -2319,6 +2610,9 @@ TEE_Result syscall_cryp_state_copy(unsigned long dst, unsigned long src)
 
 	cs_dst->state = cs_src->state;
 	cs_dst->ctx_finalize = cs_src->ctx_finalize;
+	/* The key schedule in the context now comes from cs_src */
+	cs_dst->key1_gen = 0;
+	cs_dst->key2_gen = 0;
 
 	return TEE_SUCCESS;
 }
@@ -2535,9 +2829,12 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 	struct ts_session *sess = ts_get_current_session();
 	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
 	struct tee_cryp_obj_secret *key1 = NULL;
+	struct tee_cryp_obj_secret *key2 = NULL;
 	struct tee_cryp_state *cs = NULL;
 	TEE_Result res = TEE_SUCCESS;
 	struct tee_obj *o = NULL;
+	uint64_t key1_gen = 0;
+	uint64_t key2_gen = 0;
 
 	res = tee_svc_cryp_get_state(sess, uref_to_vaddr(state), &cs);
 	if (res != TEE_SUCCESS)
@@ -2560,22 +2857,38 @@ TEE_Result syscall_cipher_init(unsigned long state, const void *iv,
 		return TEE_ERROR_BAD_PARAMETERS;
 
 	key1 = o->attr;
+	key1_gen = o->generation;
 
 	if (tee_obj_get(utc, cs->key2, &o) == TEE_SUCCESS) {
-		struct tee_cryp_obj_secret *key2 = o->attr;
-
 		if ((o->info.handleFlags & TEE_HANDLE_FLAG_INITIALIZED) == 0)
 			return TEE_ERROR_BAD_PARAMETERS;
+		key2 = o->attr;
+		key2_gen = o->generation;
+	}
+
+	/* Same keys as last time, only the IV has to be set */
+	if (cs->key1_gen == key1_gen && cs->key2_gen == key2_gen) {
+		res = crypto_cipher_reinit(cs->ctx, cs->mode, iv, iv_len);
+		if (res != TEE_ERROR_NOT_SUPPORTED)
+			goto out;
+	}
 
+	cs->key1_gen = 0;
+	cs->key2_gen = 0;
+	if (key2)
 		res = crypto_cipher_init(cs->ctx, cs->mode,
 					 (uint8_t *)(key1 + 1), key1->key_size,
 					 (uint8_t *)(key2 + 1), key2->key_size,
 					 iv, iv_len);
-	} else {
+	else
 		res = crypto_cipher_init(cs->ctx, cs->mode,
 					 (uint8_t *)(key1 + 1), key1->key_size,
 					 NULL, 0, iv, iv_len);
+	if (res == TEE_SUCCESS) {
+		cs->key1_gen = key1_gen;
+		cs->key2_gen = key2_gen;
 	}
+out:
 	if (res != TEE_SUCCESS)
 		return res;
 
@@ -2986,8 +3299,10 @@ TEE_Result syscall_cryp_derive_key(unsigned long state,
 		if (pub && ss) {
 			crypto_bignum_bin2bn(params[0].content.ref.buffer,
 					     bin_size, pub);
+			crypto_bignum_arena_begin(ko->info.keySize);
 			res = crypto_acipher_dh_shared_secret(ko->attr,
 							      pub, ss);
+			crypto_bignum_arena_end();
 			if (res == TEE_SUCCESS) {
 				sk->key_size = crypto_bignum_num_bytes(ss);
 				crypto_bignum_bn2bin(ss, (uint8_t *)(sk + 1));
@@ -3001,6 +3316,30 @@ TEE_Result syscall_cryp_derive_key(unsigned long state,
 		}
 		crypto_bignum_free(pub);
 		crypto_bignum_free(ss);
+	} else if (cs->algo == TEE_ALG_X25519) {
+		uint8_t *x25519_pub_key = NULL;
+		uint8_t *pt_secret = NULL;
+		unsigned long pt_secret_len = 0;
+
+		if (param_count != 1 ||
+		    params[0].attributeID != TEE_ATTR_X25519_PUBLIC_VALUE ||
+		    params[0].content.ref.length != KEY_SIZE_BYTES_25519) {
+			res = TEE_ERROR_BAD_PARAMETERS;
+			goto out;
+		}
+
+		x25519_pub_key = params[0].content.ref.buffer;
+		pt_secret = (uint8_t *)(sk + 1);
+		pt_secret_len = sk->alloc_size;
+		res = crypto_acipher_x25519_shared_secret(ko->attr,
+							  x25519_pub_key,
+							  pt_secret,
+							  &pt_secret_len);
+		if (res == TEE_SUCCESS) {
+			sk->key_size = pt_secret_len;
+			so->info.handleFlags |= TEE_HANDLE_FLAG_INITIALIZED;
+			set_attribute(so, type_props, TEE_ATTR_SECRET_VALUE);
+		}
 	} else if (TEE_ALG_GET_MAIN_ALG(cs->algo) == TEE_MAIN_ALGO_ECDH) {
 		struct ecc_public_key key_public;
 		uint8_t *pt_secret;
@@ -3050,9 +3389,11 @@ TEE_Result syscall_cryp_derive_key(unsigned long state,
 
 		pt_secret = (uint8_t *)(sk + 1);
 		pt_secret_len = sk->alloc_size;
+		crypto_bignum_arena_begin(alloc_size);
 		res = crypto_acipher_ecc_shared_secret(ko->attr, &key_public,
 						       pt_secret,
 						       &pt_secret_len);
+		crypto_bignum_arena_end();
 
 		if (res == TEE_SUCCESS) {
 			sk->key_size = pt_secret_len;
@@ -3239,10 +3580,23 @@ TEE_Result syscall_authenc_init(unsigned long state, const void *nonce,
 	if ((o->info.handleFlags & TEE_HANDLE_FLAG_INITIALIZED) == 0)
 		return TEE_ERROR_BAD_PARAMETERS;
 
+	/* Same key as last time, only the nonce has to be set */
+	if (cs->key1_gen == o->generation) {
+		res = crypto_authenc_reinit(cs->ctx, cs->mode, nonce,
+					    nonce_len, tag_len, aad_len,
+					    payload_len);
+		if (res != TEE_ERROR_NOT_SUPPORTED)
+			goto out;
+	}
+
 	key = o->attr;
+	cs->key1_gen = 0;
 	res = crypto_authenc_init(cs->ctx, cs->mode, (uint8_t *)(key + 1),
 				  key->key_size, nonce, nonce_len, tag_len,
 				  aad_len, payload_len);
+	if (res == TEE_SUCCESS)
+		cs->key1_gen = o->generation;
+out:
 	if (res != TEE_SUCCESS)
 		return res;
 
@@ -3498,6 +3852,327 @@ out:
 	return res;
 }
 
+/*
+ * Returns the secret of a key object passed to a one-shot syscall, the
+ * checks done by libutee when the key is set on an operation are done
+ * here instead since no operation is involved.
+ */
+static TEE_Result get_oneshot_key(struct user_ta_ctx *utc, unsigned long key,
+				  uint32_t algo, TEE_OperationMode mode,
+				  uint32_t usage,
+				  struct tee_cryp_obj_secret **secret)
+{
+	TEE_Result res = TEE_SUCCESS;
+	struct tee_obj *o = NULL;
+
+	res = tee_obj_get(utc, uref_to_vaddr(key), &o);
+	if (res != TEE_SUCCESS)
+		return res;
+	if ((o->info.handleFlags & TEE_HANDLE_FLAG_INITIALIZED) == 0)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if ((o->info.objectUsage & usage) != usage)
+		return TEE_ERROR_BAD_PARAMETERS;
+	res = tee_svc_cryp_check_key_type(o, algo, mode);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	*secret = o->attr;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result check_oneshot_buf(struct user_mode_ctx *uctx, uint32_t flags,
+				    uint64_t buf, uint64_t len)
+{
+	vaddr_t va = 0;
+	size_t l = 0;
+
+	if (ADD_OVERFLOW(0, buf, &va) || ADD_OVERFLOW(0, len, &l))
+		return TEE_ERROR_OVERFLOW;
+
+	return vm_check_access_rights(uctx, flags | TEE_MEMORY_ACCESS_ANY_OWNER,
+				      va, l);
+}
+
+static TEE_Result copy_in_oneshot_bufs(struct user_mode_ctx *uctx,
+				       struct utee_cryp_oneshot *b,
+				       const struct utee_cryp_oneshot *usr_b,
+				       bool tag_out)
+{
+	uint32_t rw = TEE_MEMORY_ACCESS_READ | TEE_MEMORY_ACCESS_WRITE;
+	TEE_Result res = TEE_SUCCESS;
+
+	res = copy_from_user(b, usr_b, sizeof(*b));
+	if (res != TEE_SUCCESS)
+		return res;
+
+	if ((!b->src && b->src_len) || (!b->aad && b->aad_len))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = check_oneshot_buf(uctx, TEE_MEMORY_ACCESS_READ, b->iv,
+				b->iv_len);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = check_oneshot_buf(uctx, TEE_MEMORY_ACCESS_READ, b->aad,
+				b->aad_len);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = check_oneshot_buf(uctx, TEE_MEMORY_ACCESS_READ, b->src,
+				b->src_len);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = check_oneshot_buf(uctx, rw, b->dst, b->dst_len);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return check_oneshot_buf(uctx, tag_out ? rw : TEE_MEMORY_ACCESS_READ,
+				 b->tag, b->tag_len);
+}
+
+static uint32_t oneshot_key_usage(TEE_OperationMode mode)
+{
+	if (mode == TEE_MODE_ENCRYPT)
+		return TEE_USAGE_ENCRYPT;
+	return TEE_USAGE_DECRYPT;
+}
+
+/*
+ * The one-shot syscalls below do what syscall_cryp_state_alloc(), the
+ * init, update and final syscalls and syscall_cryp_state_free() do for
+ * an operation, but in a single call. The state is kept on the stack
+ * instead of being registered with the TA.
+ */
+TEE_Result syscall_hash_oneshot(unsigned long algo, unsigned long key,
+				const void *chunk, size_t chunk_size,
+				void *hash, uint64_t *hash_len)
+{
+	struct ts_session *sess = ts_get_current_session();
+	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
+	struct tee_cryp_obj_secret *secret = NULL;
+	TEE_Result res2 = TEE_SUCCESS;
+	TEE_Result res = TEE_SUCCESS;
+	size_t hash_size = 0;
+	void *ctx = NULL;
+	size_t hlen = 0;
+
+	/* No data, but size provided isn't valid parameters. */
+	if (!chunk && chunk_size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	switch (TEE_ALG_GET_CLASS(algo)) {
+	case TEE_OPERATION_DIGEST:
+		if (key)
+			return TEE_ERROR_BAD_PARAMETERS;
+		break;
+	case TEE_OPERATION_MAC:
+		res = get_oneshot_key(utc, key, algo, TEE_MODE_MAC,
+				      TEE_USAGE_MAC, &secret);
+		if (res != TEE_SUCCESS)
+			return res;
+		break;
+	default:
+		return TEE_ERROR_BAD_PARAMETERS;
+	}
+
+	res = vm_check_access_rights(&utc->uctx,
+				     TEE_MEMORY_ACCESS_READ |
+				     TEE_MEMORY_ACCESS_ANY_OWNER,
+				     (uaddr_t)chunk, chunk_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = get_user_u64_as_size_t(&hlen, hash_len);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = vm_check_access_rights(&utc->uctx,
+				     TEE_MEMORY_ACCESS_READ |
+				     TEE_MEMORY_ACCESS_WRITE |
+				     TEE_MEMORY_ACCESS_ANY_OWNER,
+				     (uaddr_t)hash, hlen);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = tee_alg_get_digest_size(algo, &hash_size);
+	if (res != TEE_SUCCESS)
+		return res;
+	if (hlen < hash_size) {
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+
+	if (!secret) {
+		res = tee_hash_createdigest(algo, chunk, chunk_size, hash,
+					    hash_size);
+		if (res != TEE_SUCCESS)
+			return res;
+		goto out;
+	}
+
+	res = crypto_mac_alloc_ctx(&ctx, algo);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = crypto_mac_init(ctx, (uint8_t *)(secret + 1), secret->key_size);
+	if (res == TEE_SUCCESS && chunk_size)
+		res = crypto_mac_update(ctx, chunk, chunk_size);
+	if (res == TEE_SUCCESS)
+		res = crypto_mac_final(ctx, hash, hash_size);
+	crypto_mac_free_ctx(ctx);
+	if (res != TEE_SUCCESS)
+		return res;
+
+out:
+	res2 = put_user_u64(hash_len, hash_size);
+	if (res2 != TEE_SUCCESS)
+		return res2;
+	return res;
+}
+
+TEE_Result syscall_cipher_oneshot(unsigned long algo, unsigned long mode,
+				  unsigned long key,
+				  struct utee_cryp_oneshot *usr_bufs)
+{
+	struct ts_session *sess = ts_get_current_session();
+	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
+	struct tee_cryp_obj_secret *secret = NULL;
+	struct utee_cryp_oneshot b = { };
+	TEE_Result res2 = TEE_SUCCESS;
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+
+	if (TEE_ALG_GET_CLASS(algo) != TEE_OPERATION_CIPHER)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (mode != TEE_MODE_ENCRYPT && mode != TEE_MODE_DECRYPT)
+		return TEE_ERROR_BAD_PARAMETERS;
+	/* Takes two keys */
+	if (algo == TEE_ALG_AES_XTS)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	res = copy_in_oneshot_bufs(&utc->uctx, &b, usr_bufs, false);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = get_oneshot_key(utc, key, algo, mode, oneshot_key_usage(mode),
+			      &secret);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	if (b.dst_len < b.src_len) {
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+
+	res = crypto_cipher_alloc_ctx(&ctx, algo);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = crypto_cipher_init(ctx, mode, (uint8_t *)(secret + 1),
+				 secret->key_size, NULL, 0,
+				 (void *)(vaddr_t)b.iv, b.iv_len);
+	if (res == TEE_SUCCESS) {
+		/* Permit src_len == 0 like syscall_cipher_final() */
+		if (b.src_len)
+			res = tee_do_cipher_update(ctx, algo, mode, true,
+						   (void *)(vaddr_t)b.src,
+						   b.src_len,
+						   (void *)(vaddr_t)b.dst);
+		crypto_cipher_final(ctx);
+	}
+	crypto_cipher_free_ctx(ctx);
+	if (res != TEE_SUCCESS)
+		return res;
+
+out:
+	res2 = put_user_u64(&usr_bufs->dst_len, b.src_len);
+	if (res2 != TEE_SUCCESS)
+		return res2;
+	return res;
+}
+
+TEE_Result syscall_authenc_oneshot(unsigned long algo, unsigned long mode,
+				   unsigned long key,
+				   struct utee_cryp_oneshot *usr_bufs)
+{
+	struct ts_session *sess = ts_get_current_session();
+	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
+	struct tee_cryp_obj_secret *secret = NULL;
+	struct utee_cryp_oneshot b = { };
+	TEE_Result res2 = TEE_SUCCESS;
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+	size_t dlen = 0;
+	size_t tlen = 0;
+
+	if (TEE_ALG_GET_CLASS(algo) != TEE_OPERATION_AE)
+		return TEE_ERROR_BAD_PARAMETERS;
+	if (mode != TEE_MODE_ENCRYPT && mode != TEE_MODE_DECRYPT)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = copy_in_oneshot_bufs(&utc->uctx, &b, usr_bufs,
+				   mode == TEE_MODE_ENCRYPT);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = get_oneshot_key(utc, key, algo, mode, oneshot_key_usage(mode),
+			      &secret);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	dlen = b.src_len;
+	tlen = b.tag_len;
+	if (b.dst_len < b.src_len) {
+		res = TEE_ERROR_SHORT_BUFFER;
+		goto out;
+	}
+
+	res = crypto_authenc_alloc_ctx(&ctx, algo);
+	if (res != TEE_SUCCESS)
+		return res;
+	res = crypto_authenc_init(ctx, mode, (uint8_t *)(secret + 1),
+				  secret->key_size, (void *)(vaddr_t)b.iv,
+				  b.iv_len, tlen, b.aad_len, b.src_len);
+	if (res != TEE_SUCCESS)
+		goto out_free;
+
+	if (b.aad_len)
+		res = crypto_authenc_update_aad(ctx, mode,
+						(void *)(vaddr_t)b.aad,
+						b.aad_len);
+	if (res == TEE_SUCCESS) {
+		if (mode == TEE_MODE_ENCRYPT)
+			res = crypto_authenc_enc_final(ctx,
+						       (void *)(vaddr_t)b.src,
+						       b.src_len,
+						       (void *)(vaddr_t)b.dst,
+						       &dlen,
+						       (void *)(vaddr_t)b.tag,
+						       &tlen);
+		else
+			res = crypto_authenc_dec_final(ctx,
+						       (void *)(vaddr_t)b.src,
+						       b.src_len,
+						       (void *)(vaddr_t)b.dst,
+						       &dlen,
+						       (void *)(vaddr_t)b.tag,
+						       tlen);
+	}
+	crypto_authenc_final(ctx);
+out_free:
+	crypto_authenc_free_ctx(ctx);
+	if (res != TEE_SUCCESS)
+		return res;
+
+out:
+	res2 = put_user_u64(&usr_bufs->dst_len, dlen);
+	if (res2 != TEE_SUCCESS)
+		return res2;
+	if (mode == TEE_MODE_ENCRYPT) {
+		res2 = put_user_u64(&usr_bufs->tag_len, tlen);
+		if (res2 != TEE_SUCCESS)
+			return res2;
+	}
+	return res;
+}
+
 static int pkcs1_get_salt_len(const TEE_Attribute *params, uint32_t num_params,
 			      size_t default_len)
 {
@@ -3578,6 +4253,7 @@ TEE_Result syscall_asymm_operate(unsigned long state,
 		goto out;
 	}
 
+	crypto_bignum_arena_begin(o->info.keySize);
 	switch (cs->algo) {
 	case TEE_ALG_RSA_NOPAD:
 		if (cs->mode == TEE_MODE_ENCRYPT) {
@@ -3678,10 +4354,15 @@ TEE_Result syscall_asymm_operate(unsigned long state,
 		res = crypto_acipher_ecc_sign(cs->algo, o->attr, src_data,
 					      src_len, dst_data, &dlen);
 		break;
+	case TEE_ALG_ED25519:
+		res = crypto_acipher_ed25519_sign(o->attr, src_data, src_len,
+						  dst_data, &dlen);
+		break;
 	default:
 		res = TEE_ERROR_BAD_PARAMETERS;
 		break;
 	}
+	crypto_bignum_arena_end();
 
 out:
 	free_wipe(params);
@@ -3751,6 +4432,7 @@ TEE_Result syscall_asymm_verify(unsigned long state,
 		goto out;
 	}
 
+	crypto_bignum_arena_begin(o->info.keySize);
 	switch (TEE_ALG_GET_MAIN_ALG(cs->algo)) {
 	case TEE_MAIN_ALGO_RSA:
 		if (cs->algo != TEE_ALG_RSASSA_PKCS1_V1_5) {
@@ -3818,9 +4500,25 @@ TEE_Result syscall_asymm_verify(unsigned long state,
 						data_len, sig, sig_len);
 		break;
 
+	case TEE_MAIN_ALGO_ED25519:
+		if (o->info.objectType == TEE_TYPE_ED25519_KEYPAIR) {
+			struct ed25519_keypair *kp = o->attr;
+			struct ed25519_public_key key = { .pub = kp->pub };
+
+			res = crypto_acipher_ed25519_verify(&key, data,
+							    data_len, sig,
+							    sig_len);
+		} else {
+			res = crypto_acipher_ed25519_verify(o->attr, data,
+							    data_len, sig,
+							    sig_len);
+		}
+		break;
+
 	default:
 		res = TEE_ERROR_NOT_SUPPORTED;
 	}
+	crypto_bignum_arena_end();
 
 out:
 	free_wipe(params);
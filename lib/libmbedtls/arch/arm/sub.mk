@@ -0,0 +1 @@
+srcs-$(CFG_ARM64_$(sm)) += bignum_a64.S
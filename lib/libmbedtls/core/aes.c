@@ -12,17 +12,21 @@
 #include <mbedtls/aes.h>
 #include <mbedtls/platform_util.h>
 #include <string.h>
+#include <utee_defines.h>
+#include <util.h>
 
 TEE_Result crypto_aes_expand_enc_key(const void *key, size_t key_len,
 				     void *enc_key, size_t enc_keylen,
 				     unsigned int *rounds)
 {
-#if defined(MBEDTLS_AES_ALT)
-	return crypto_accel_aes_expand_keys(key, key_len, enc_key, NULL,
-					    enc_keylen, rounds);
-#else
 	mbedtls_aes_context ctx;
 
+#if defined(MBEDTLS_AES_ALT)
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return crypto_accel_aes_expand_keys(key, key_len, enc_key, NULL,
+						    enc_keylen, rounds);
+#endif
+
 	memset(&ctx, 0, sizeof(ctx));
 	mbedtls_aes_init(&ctx);
 	if (mbedtls_aes_setkey_enc(&ctx, key, key_len * 8) != 0)
@@ -34,16 +38,25 @@ TEE_Result crypto_aes_expand_enc_key(const void *key, size_t key_len,
 	*rounds = ctx.nr;
 	mbedtls_aes_free(&ctx);
 	return TEE_SUCCESS;
-#endif
 }
 
-void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen __maybe_unused,
-			  unsigned int rounds, const void *src, void *dst)
+void crypto_aes_enc_blocks(const void *enc_key,
+			   size_t enc_keylen __maybe_unused,
+			   unsigned int rounds, const void *src, void *dst,
+			   size_t num_blocks)
 {
-#if defined(MBEDTLS_AES_ALT)
-	crypto_accel_aes_ecb_enc(dst, src, enc_key, rounds, 1);
-#else
 	mbedtls_aes_context ctx;
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	size_t n = 0;
+
+#if defined(MBEDTLS_AES_ALT)
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES)) {
+		crypto_accel_aes_ecb_enc(dst, src, enc_key, rounds,
+					 num_blocks);
+		return;
+	}
+#endif
 
 	memset(&ctx, 0, sizeof(ctx));
 	mbedtls_aes_init(&ctx);
@@ -52,12 +65,23 @@ void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen __maybe_unused,
 	memcpy(ctx.buf, enc_key, enc_keylen);
 	ctx.rk = ctx.buf;
 	ctx.nr = rounds;
-	mbedtls_aes_encrypt(&ctx, src, dst);
+	for (n = 0; n < num_blocks; n++)
+		mbedtls_internal_aes_encrypt(&ctx, s + n * TEE_AES_BLOCK_SIZE,
+					     d + n * TEE_AES_BLOCK_SIZE);
 	mbedtls_aes_free(&ctx);
-#endif
+}
+
+void crypto_aes_enc_block(const void *enc_key, size_t enc_keylen,
+			  unsigned int rounds, const void *src, void *dst)
+{
+	crypto_aes_enc_blocks(enc_key, enc_keylen, rounds, src, dst, 1);
 }
 
 #if defined(MBEDTLS_AES_ALT)
+/*
+ * Without the AES instructions the portable functions from
+ * mbedtls/library/aes.c are used, see crypto_accel_get_caps().
+ */
 void mbedtls_aes_init(mbedtls_aes_context *ctx)
 {
 	assert(ctx);
@@ -73,14 +97,21 @@ void mbedtls_aes_free( mbedtls_aes_context *ctx )
 int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
 			   unsigned int keybits)
 {
+	unsigned int rounds = 0;
+
 	assert(ctx && key);
 
 	if (keybits != 128 && keybits != 192 && keybits != 256)
 		return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
 
-	if (crypto_accel_aes_expand_keys(key, keybits / 8, ctx->key, NULL,
-					 sizeof(ctx->key), &ctx->round_count))
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return mbedtls_aes_setkey_enc_sw(ctx, key, keybits);
+
+	if (crypto_accel_aes_expand_keys(key, keybits / 8, ctx->buf, NULL,
+					 sizeof(ctx->buf), &rounds))
 		return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+	ctx->rk = ctx->buf;
+	ctx->nr = rounds;
 
 	return 0;
 }
@@ -88,17 +119,45 @@ int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
 int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key,
 			   unsigned int keybits)
 {
-	uint32_t enc_key[sizeof(ctx->key)] = { 0 };
+	uint32_t enc_key[ARRAY_SIZE(ctx->buf)] = { 0 };
+	unsigned int rounds = 0;
 
 	assert(ctx && key);
 
 	if (keybits != 128 && keybits != 192 && keybits != 256)
 		return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
 
-	if (crypto_accel_aes_expand_keys(key, keybits / 8, enc_key, ctx->key,
-					 sizeof(ctx->key), &ctx->round_count))
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return mbedtls_aes_setkey_dec_sw(ctx, key, keybits);
+
+	if (crypto_accel_aes_expand_keys(key, keybits / 8, enc_key, ctx->buf,
+					 sizeof(ctx->buf), &rounds))
 		return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
+	ctx->rk = ctx->buf;
+	ctx->nr = rounds;
+
+	return 0;
+}
+
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx,
+				 const unsigned char input[16],
+				 unsigned char output[16])
+{
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return mbedtls_internal_aes_encrypt_sw(ctx, input, output);
+
+	crypto_accel_aes_ecb_enc(output, input, ctx->buf, ctx->nr, 1);
+	return 0;
+}
+
+int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx,
+				 const unsigned char input[16],
+				 unsigned char output[16])
+{
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		return mbedtls_internal_aes_decrypt_sw(ctx, input, output);
 
+	crypto_accel_aes_ecb_dec(output, input, ctx->buf, ctx->nr, 1);
 	return 0;
 }
 #endif /*MBEDTLS_AES_ALT*/
@@ -124,6 +124,29 @@ TEE_Result crypto_aes_cbc_alloc_ctx(struct crypto_cipher_ctx **ctx_ret)
 }
 
 #if defined(MBEDTLS_AES_ALT)
+static void aes_cbc_sw(mbedtls_aes_context *ctx, int mode, size_t length,
+		       unsigned char iv[16], const unsigned char *input,
+		       unsigned char *output)
+{
+	unsigned char temp[16] = { 0 };
+	size_t n = 0;
+
+	for (; length; length -= 16, input += 16, output += 16) {
+		if (mode == MBEDTLS_AES_ENCRYPT) {
+			for (n = 0; n < 16; n++)
+				output[n] = input[n] ^ iv[n];
+			mbedtls_internal_aes_encrypt(ctx, output, output);
+			memcpy(iv, output, 16);
+		} else {
+			memcpy(temp, input, 16);
+			mbedtls_internal_aes_decrypt(ctx, input, output);
+			for (n = 0; n < 16; n++)
+				output[n] ^= iv[n];
+			memcpy(iv, temp, 16);
+		}
+	}
+}
+
 int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length,
 			  unsigned char iv[16], const unsigned char *input,
 			  unsigned char *output)
@@ -131,12 +154,14 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length,
 	if (length % 16)
 		return MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH;
 
-	if (mode == MBEDTLS_AES_ENCRYPT)
-		crypto_accel_aes_cbc_enc(output, input, ctx->key,
-					 ctx->round_count, length / 16, iv);
+	if (!crypto_accel_is_available(CRYPTO_ACCEL_AES))
+		aes_cbc_sw(ctx, mode, length, iv, input, output);
+	else if (mode == MBEDTLS_AES_ENCRYPT)
+		crypto_accel_aes_cbc_enc(output, input, ctx->buf, ctx->nr,
+					 length / 16, iv);
 	else
-		crypto_accel_aes_cbc_dec(output, input, ctx->key,
-					 ctx->round_count, length / 16, iv);
+		crypto_accel_aes_cbc_dec(output, input, ctx->buf, ctx->nr,
+					 length / 16, iv);
 
 	return 0;
 }
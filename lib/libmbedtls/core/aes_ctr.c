@@ -123,9 +123,18 @@ static void next_ctr(unsigned char stream_block[16], mbedtls_aes_context *ctx,
 		     unsigned char nonce_counter[16])
 {
 	const unsigned char zeroes[16] = { 0 };
+	int i = 0;
 
-	crypto_accel_aes_ctr_be_enc(stream_block, zeroes, ctx->key,
-				    ctx->round_count, 1, nonce_counter);
+	if (crypto_accel_is_available(CRYPTO_ACCEL_AES)) {
+		crypto_accel_aes_ctr_be_enc(stream_block, zeroes, ctx->buf,
+					    ctx->nr, 1, nonce_counter);
+		return;
+	}
+
+	mbedtls_internal_aes_encrypt(ctx, nonce_counter, stream_block);
+	for (i = 15; i >= 0; i--)
+		if (++nonce_counter[i])
+			break;
 }
 
 int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length,
@@ -150,11 +159,12 @@ int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length,
 			return 0;
 	}
 
-	if ((length - offs) >= 16) {
+	if ((length - offs) >= 16 &&
+	    crypto_accel_is_available(CRYPTO_ACCEL_AES)) {
 		size_t block_count = (length - offs) / 16;
 
 		crypto_accel_aes_ctr_be_enc(output + offs, input + offs,
-					    ctx->key, ctx->round_count,
+					    ctx->buf, ctx->nr,
 					    block_count, nonce_counter);
 		offs += block_count * 16;
 	}
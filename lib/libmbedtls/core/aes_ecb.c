@@ -132,12 +132,8 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode,
 
 {
 	if (mode == MBEDTLS_AES_ENCRYPT)
-		crypto_accel_aes_ecb_enc(output, input, ctx->key,
-					 ctx->round_count, 1);
+		return mbedtls_internal_aes_encrypt(ctx, input, output);
 	else
-		crypto_accel_aes_ecb_dec(output, input, ctx->key,
-					 ctx->round_count, 1);
-
-	return 0;
+		return mbedtls_internal_aes_decrypt(ctx, input, output);
 }
 #endif /*MBEDTLS_AES_ALT*/
@@ -39,6 +39,15 @@ int32_t crypto_bignum_compare(struct bignum *a, struct bignum *b)
 	return CMP_TRILEAN(ret, 0);
 }
 
+/* Temporaries are taken from the heap, there's no arena to manage */
+void crypto_bignum_arena_begin(size_t size_bits __unused)
+{
+}
+
+void crypto_bignum_arena_end(void)
+{
+}
+
 void crypto_bignum_bn2bin(const struct bignum *from, uint8_t *to)
 {
 	size_t len = 0;
@@ -205,7 +205,8 @@ int mbedtls_internal_sha1_process(mbedtls_sha1_context *ctx,
 	MBEDTLS_INTERNAL_VALIDATE_RET((const unsigned char *)data != NULL,
 				      MBEDTLS_ERR_SHA1_BAD_INPUT_DATA);
 
-	crypto_accel_sha1_compress(ctx->state, data, 1);
+	if (crypto_accel_sha1_compress(ctx->state, data, 1))
+		return mbedtls_internal_sha1_process_sw(ctx, data);
 
 	return 0;
 }
@@ -220,7 +221,8 @@ int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
 	MBEDTLS_INTERNAL_VALIDATE_RET((const unsigned char *)data != NULL,
 				      MBEDTLS_ERR_SHA256_BAD_INPUT_DATA);
 
-	crypto_accel_sha256_compress(ctx->state, data, 1);
+	if (crypto_accel_sha256_compress(ctx->state, data, 1))
+		return mbedtls_internal_sha256_process_sw(ctx, data);
 
 	return 0;
 }
@@ -4,9 +4,25 @@
 #ifndef __MBEDTLS_AES_ALT_H
 #define __MBEDTLS_AES_ALT_H
 
+/*
+ * Same layout as the portable context, the portable functions below use
+ * it when the CPU lacks the AES instructions.
+ */
 typedef struct mbedtls_aes_context {
-	uint32_t key[60];
-	unsigned int round_count;
+	int nr;
+	uint32_t *rk;
+	uint32_t buf[68];
 } mbedtls_aes_context;
 
+int mbedtls_aes_setkey_enc_sw(mbedtls_aes_context *ctx,
+			      const unsigned char *key, unsigned int keybits);
+int mbedtls_aes_setkey_dec_sw(mbedtls_aes_context *ctx,
+			      const unsigned char *key, unsigned int keybits);
+int mbedtls_internal_aes_encrypt_sw(mbedtls_aes_context *ctx,
+				    const unsigned char input[16],
+				    unsigned char output[16]);
+int mbedtls_internal_aes_decrypt_sw(mbedtls_aes_context *ctx,
+				    const unsigned char input[16],
+				    unsigned char output[16]);
+
 #endif /*__MBEDTLS_AES_ALT_H*/
@@ -11,6 +11,9 @@
 #endif
 #define MBEDTLS_BIGNUM_C
 #define MBEDTLS_GENPRIME
+#if defined(__aarch64__) && defined(CFG_MBEDTLS_MPI_ASM)
+#define MBEDTLS_MPI_MLA_A64
+#endif
 
 /* Test if Mbedtls is the primary crypto lib */
 #ifdef CFG_CRYPTOLIB_NAME_mbedtls
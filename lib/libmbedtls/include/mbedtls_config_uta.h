@@ -27,6 +27,9 @@
 
 #define MBEDTLS_BIGNUM_C
 #define MBEDTLS_GENPRIME
+#if defined(__aarch64__) && defined(CFG_MBEDTLS_MPI_ASM)
+#define MBEDTLS_MPI_MLA_A64
+#endif
 #define MBEDTLS_RSA_C
 #define MBEDTLS_ECDH_C
 #define MBEDTLS_ECDSA_C
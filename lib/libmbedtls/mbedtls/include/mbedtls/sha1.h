@@ -185,6 +185,12 @@ int mbedtls_sha1_finish_ret( mbedtls_sha1_context *ctx,
 int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
                                    const unsigned char data[64] );
 
+#if defined(MBEDTLS_SHA1_PROCESS_ALT)
+/* OP-TEE: the portable mbedtls_internal_sha1_process() */
+int mbedtls_internal_sha1_process_sw( mbedtls_sha1_context *ctx,
+                                      const unsigned char data[64] );
+#endif
+
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
 #if defined(MBEDTLS_DEPRECATED_WARNING)
 #define MBEDTLS_DEPRECATED      __attribute__((deprecated))
@@ -152,6 +152,12 @@ int mbedtls_sha256_finish_ret( mbedtls_sha256_context *ctx,
 int mbedtls_internal_sha256_process( mbedtls_sha256_context *ctx,
                                      const unsigned char data[64] );
 
+#if defined(MBEDTLS_SHA256_PROCESS_ALT)
+/* OP-TEE: the portable mbedtls_internal_sha256_process() */
+int mbedtls_internal_sha256_process_sw( mbedtls_sha256_context *ctx,
+                                        const unsigned char data[64] );
+#endif
+
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
 #if defined(MBEDTLS_DEPRECATED_WARNING)
 #define MBEDTLS_DEPRECATED      __attribute__((deprecated))
@@ -49,7 +49,18 @@
 #endif /* MBEDTLS_PLATFORM_C */
 #endif /* MBEDTLS_SELF_TEST */
 
-#if !defined(MBEDTLS_AES_ALT)
+#if defined(MBEDTLS_AES_ALT)
+/*
+ * OP-TEE: the alternative implementation in lib/libmbedtls/core/aes.c
+ * falls back to the portable key schedule and block functions when the
+ * CPU lacks the AES instructions. Build them under other names, the
+ * alternative mbedtls_aes_context has the same layout as the portable one.
+ */
+#define mbedtls_aes_setkey_enc          mbedtls_aes_setkey_enc_sw
+#define mbedtls_aes_setkey_dec          mbedtls_aes_setkey_dec_sw
+#define mbedtls_internal_aes_encrypt    mbedtls_internal_aes_encrypt_sw
+#define mbedtls_internal_aes_decrypt    mbedtls_internal_aes_decrypt_sw
+#endif /* MBEDTLS_AES_ALT */
 
 /* Parameter validation macros based on platform_util.h */
 #define AES_VALIDATE_RET( cond )    \
@@ -510,6 +521,7 @@ static void aes_gen_tables( void )
 
 #endif /* MBEDTLS_AES_FEWER_TABLES */
 
+#if !defined(MBEDTLS_AES_ALT)
 void mbedtls_aes_init( mbedtls_aes_context *ctx )
 {
     AES_VALIDATE( ctx != NULL );
@@ -543,6 +555,7 @@ void mbedtls_aes_xts_free( mbedtls_aes_xts_context *ctx )
     mbedtls_aes_free( &ctx->tweak );
 }
 #endif /* MBEDTLS_CIPHER_MODE_XTS */
+#endif /* !MBEDTLS_AES_ALT */
 
 /*
  * AES key schedule (encryption)
@@ -732,7 +745,7 @@ exit:
 }
 #endif /* !MBEDTLS_AES_SETKEY_DEC_ALT */
 
-#if defined(MBEDTLS_CIPHER_MODE_XTS)
+#if defined(MBEDTLS_CIPHER_MODE_XTS) && !defined(MBEDTLS_AES_ALT)
 static int mbedtls_aes_xts_decode_keys( const unsigned char *key,
                                         unsigned int keybits,
                                         const unsigned char **key1,
@@ -807,7 +820,7 @@ int mbedtls_aes_xts_setkey_dec( mbedtls_aes_xts_context *ctx,
     /* Set crypt key for decryption. */
     return mbedtls_aes_setkey_dec( &ctx->crypt, key1, key1bits );
 }
-#endif /* MBEDTLS_CIPHER_MODE_XTS */
+#endif /* MBEDTLS_CIPHER_MODE_XTS && !MBEDTLS_AES_ALT */
 
 #define AES_FROUND(X0,X1,X2,X3,Y0,Y1,Y2,Y3)                     \
     do                                                          \
@@ -921,14 +934,14 @@ int mbedtls_internal_aes_encrypt( mbedtls_aes_context *ctx,
 }
 #endif /* !MBEDTLS_AES_ENCRYPT_ALT */
 
-#if !defined(MBEDTLS_DEPRECATED_REMOVED)
+#if !defined(MBEDTLS_DEPRECATED_REMOVED) && !defined(MBEDTLS_AES_ALT)
 void mbedtls_aes_encrypt( mbedtls_aes_context *ctx,
                           const unsigned char input[16],
                           unsigned char output[16] )
 {
     mbedtls_internal_aes_encrypt( ctx, input, output );
 }
-#endif /* !MBEDTLS_DEPRECATED_REMOVED */
+#endif /* !MBEDTLS_DEPRECATED_REMOVED && !MBEDTLS_AES_ALT */
 
 /*
  * AES-ECB block decryption
@@ -994,15 +1007,16 @@ int mbedtls_internal_aes_decrypt( mbedtls_aes_context *ctx,
 }
 #endif /* !MBEDTLS_AES_DECRYPT_ALT */
 
-#if !defined(MBEDTLS_DEPRECATED_REMOVED)
+#if !defined(MBEDTLS_DEPRECATED_REMOVED) && !defined(MBEDTLS_AES_ALT)
 void mbedtls_aes_decrypt( mbedtls_aes_context *ctx,
                           const unsigned char input[16],
                           unsigned char output[16] )
 {
     mbedtls_internal_aes_decrypt( ctx, input, output );
 }
-#endif /* !MBEDTLS_DEPRECATED_REMOVED */
+#endif /* !MBEDTLS_DEPRECATED_REMOVED && !MBEDTLS_AES_ALT */
 
+#if !defined(MBEDTLS_AES_ALT)
 /*
  * AES-ECB block encryption/decryption
  */
@@ -1473,6 +1487,13 @@ int mbedtls_aes_crypt_ctr( mbedtls_aes_context *ctx,
 
 #endif /* !MBEDTLS_AES_ALT */
 
+#if defined(MBEDTLS_AES_ALT)
+#undef mbedtls_aes_setkey_enc
+#undef mbedtls_aes_setkey_dec
+#undef mbedtls_internal_aes_encrypt
+#undef mbedtls_internal_aes_decrypt
+#endif /* MBEDTLS_AES_ALT */
+
 #if defined(MBEDTLS_SELF_TEST)
 /*
  * AES test vectors from:
@@ -75,6 +75,18 @@
 #define BITS_TO_LIMBS(i)  ( (i) / biL + ( (i) % biL != 0 ) )
 #define CHARS_TO_LIMBS(i) ( (i) / ciL + ( (i) % ciL != 0 ) )
 
+/*
+ * Products and squares of operands of at least this number of limbs are
+ * computed with the Karatsuba method, smaller ones with the schoolbook
+ * method.
+ */
+#if !defined(MBEDTLS_MPI_KARATSUBA_THRESHOLD)
+#define MBEDTLS_MPI_KARATSUBA_THRESHOLD 32
+#endif
+#if MBEDTLS_MPI_KARATSUBA_THRESHOLD < 8
+#error "MBEDTLS_MPI_KARATSUBA_THRESHOLD must be at least 8"
+#endif
+
 void *mbedtls_mpi_mempool;
 
 /* Implementation that should never be optimized out by the compiler */
@@ -1665,21 +1677,33 @@ int mbedtls_mpi_sub_int( mbedtls_mpi *X, const mbedtls_mpi *A, mbedtls_mpi_sint
     return( mbedtls_mpi_sub_mpi( X, A, &_B ) );
 }
 
+#if defined(MBEDTLS_MPI_MLA_A64)
+/* Assembly kernels, arch/arm/bignum_a64.S */
+#if defined(MBEDTLS_HAVE_INT32)
+mbedtls_mpi_uint mpi_mla_u32_a64( mbedtls_mpi_uint *d,
+                                  const mbedtls_mpi_uint *s, size_t n,
+                                  mbedtls_mpi_uint b );
+#define mpi_mla_asm mpi_mla_u32_a64
+#else
+mbedtls_mpi_uint mpi_mla_u64_a64( mbedtls_mpi_uint *d,
+                                  const mbedtls_mpi_uint *s, size_t n,
+                                  mbedtls_mpi_uint b );
+#define mpi_mla_asm mpi_mla_u64_a64
+#endif
+#endif /* MBEDTLS_MPI_MLA_A64 */
+
 /** Helper for mbedtls_mpi multiplication.
  *
- * Add \p b * \p s to \p d.
+ * Add \p b * \p s to the \p i limbs of \p d.
  *
  * \param i             The number of limbs of \p s.
  * \param[in] s         A bignum to multiply, of size \p i.
  *                      It may overlap with \p d, but only if
  *                      \p d <= \p s.
- *                      Its leading limb must not be \c 0.
- * \param[in,out] d     The bignum to add to.
- *                      It must be sufficiently large to store the
- *                      result of the multiplication. This means
- *                      \p i + 1 limbs if \p d[\p i - 1] started as 0 and \p b
- *                      is not known a priori.
+ * \param[in,out] d     The bignum to add to, of size \p i.
  * \param b             A scalar to multiply.
+ *
+ * \return              The carry out of \p d[\p i - 1].
  */
 static
 #if defined(__APPLE__) && defined(__arm__)
@@ -1689,11 +1713,14 @@ static
  */
 __attribute__ ((noinline))
 #endif
-void mpi_mul_hlp( size_t i,
-                  const mbedtls_mpi_uint *s,
-                  mbedtls_mpi_uint *d,
-                  mbedtls_mpi_uint b )
+mbedtls_mpi_uint mpi_mla_hlp( size_t i,
+                              const mbedtls_mpi_uint *s,
+                              mbedtls_mpi_uint *d,
+                              mbedtls_mpi_uint b )
 {
+#if defined(mpi_mla_asm)
+    return( mpi_mla_asm( d, s, i, b ) );
+#else
     mbedtls_mpi_uint c = 0, t = 0;
 
 #if defined(MULADDC_HUIT)
@@ -1747,26 +1774,306 @@ void mpi_mul_hlp( size_t i,
 
     t++;
 
+    return( c );
+#endif /* mpi_mla_asm */
+}
+
+/** Helper for mbedtls_mpi multiplication.
+ *
+ * Add \p b * \p s to \p d.
+ *
+ * \param i             The number of limbs of \p s.
+ * \param[in] s         A bignum to multiply, of size \p i.
+ *                      It may overlap with \p d, but only if
+ *                      \p d <= \p s.
+ *                      Its leading limb must not be \c 0.
+ * \param[in,out] d     The bignum to add to.
+ *                      It must be sufficiently large to store the
+ *                      result of the multiplication. This means
+ *                      \p i + 1 limbs if \p d[\p i - 1] started as 0 and \p b
+ *                      is not known a priori.
+ * \param b             A scalar to multiply.
+ */
+static void mpi_mul_hlp( size_t i,
+                         const mbedtls_mpi_uint *s,
+                         mbedtls_mpi_uint *d,
+                         mbedtls_mpi_uint b )
+{
+    mbedtls_mpi_uint c;
+
+    c = mpi_mla_hlp( i, s, d, b );
+    d += i;
+
     while( c != 0 )
     {
         *d += c; c = ( *d < c ); d++;
     }
 }
 
+/*
+ * Limb array helpers for the Karatsuba multiplication and the squaring.
+ * They run in constant time with respect to the value of the operands.
+ */
+
+/* d = l + r on n limbs, returns the carry */
+static mbedtls_mpi_uint mpi_add_hlp( size_t n,
+                                     mbedtls_mpi_uint *d,
+                                     const mbedtls_mpi_uint *l,
+                                     const mbedtls_mpi_uint *r )
+{
+    size_t i;
+    mbedtls_mpi_uint c = 0, t, z;
+
+    for( i = 0; i < n; i++ )
+    {
+        t = l[i] + c;  c = ( t < c );
+        z = t + r[i];  c += ( z < t );
+        d[i] = z;
+    }
+
+    return( c );
+}
+
+/* d += cond ? s : 0 on n limbs, cond is 0 or 1, returns the carry */
+static mbedtls_mpi_uint mpi_cond_add_hlp( size_t n,
+                                          mbedtls_mpi_uint *d,
+                                          const mbedtls_mpi_uint *s,
+                                          mbedtls_mpi_uint cond )
+{
+    size_t i;
+    mbedtls_mpi_uint mask = (mbedtls_mpi_uint) 0 - cond;
+    mbedtls_mpi_uint c = 0, t, z;
+
+    for( i = 0; i < n; i++ )
+    {
+        t = d[i] + c;               c = ( t < c );
+        z = t + ( s[i] & mask );    c += ( z < t );
+        d[i] = z;
+    }
+
+    return( c );
+}
+
+/* d += c on n limbs, returns the carry */
+static mbedtls_mpi_uint mpi_inc_hlp( size_t n, mbedtls_mpi_uint *d,
+                                     mbedtls_mpi_uint c )
+{
+    size_t i;
+
+    for( i = 0; i < n; i++ )
+    {
+        d[i] += c; c = ( d[i] < c );
+    }
+
+    return( c );
+}
+
+/* d -= c on n limbs, returns the borrow */
+static mbedtls_mpi_uint mpi_dec_hlp( size_t n, mbedtls_mpi_uint *d,
+                                     mbedtls_mpi_uint c )
+{
+    size_t i;
+    mbedtls_mpi_uint z;
+
+    for( i = 0; i < n; i++ )
+    {
+        z = ( d[i] < c ); d[i] -= c; c = z;
+    }
+
+    return( c );
+}
+
+/*
+ * Schoolbook multiplication: d = a * b  (HAC 14.12)
+ * d has na + nb limbs and doesn't overlap a or b.
+ */
+static void mpi_mul_school( mbedtls_mpi_uint *d,
+                            const mbedtls_mpi_uint *a, size_t na,
+                            const mbedtls_mpi_uint *b, size_t nb )
+{
+    size_t j;
+
+    memset( d, 0, na * ciL );
+
+    for( j = 0; j < nb; j++ )
+        d[na + j] = mpi_mla_hlp( na, a, d + j, b[j] );
+}
+
+/*
+ * Schoolbook squaring: d = a * a  (HAC 14.16)
+ * d has 2 * n limbs and doesn't overlap a.
+ */
+static void mpi_sqr_school( mbedtls_mpi_uint *d,
+                            const mbedtls_mpi_uint *a, size_t n )
+{
+    size_t i;
+    mbedtls_mpi_uint c, t;
+
+    memset( d, 0, 2 * n * ciL );
+
+    /* Cross products a[i] * a[j] with i < j */
+    for( i = 0; i + 1 < n; i++ )
+        d[n + i] = mpi_mla_hlp( n - i - 1, a + i + 1, d + 2 * i + 1, a[i] );
+
+    /* Counted twice */
+    c = 0;
+    for( i = 0; i < 2 * n; i++ )
+    {
+        t = d[i];
+        d[i] = ( t << 1 ) | c;
+        c = t >> ( biL - 1 );
+    }
+
+    /* Plus the squares a[i] * a[i] */
+    c = 0;
+    for( i = 0; i < n; i++ )
+    {
+        d[2 * i] += c;      c = ( d[2 * i] < c );
+        t = mpi_mla_hlp( 1, a + i, d + 2 * i, a[i] );
+        d[2 * i + 1] += t;  c += ( d[2 * i + 1] < t );
+    }
+}
+
+/*
+ * Number of limbs of scratch space needed by mpi_mul_kara() and
+ * mpi_sqr_kara() on n limbs operands.
+ */
+static size_t mpi_kara_scratch( size_t n )
+{
+    size_t l, s = 0;
+
+    while( n >= MBEDTLS_MPI_KARATSUBA_THRESHOLD )
+    {
+        l = n - n / 2;
+        s += 4 * l + 1;
+        n = l;
+    }
+
+    return( s );
+}
+
+/*
+ * Combines the three half size products of the Karatsuba method.
+ *
+ * On entry d holds z0 = a0 * b0 on its 2 * l low limbs and z2 = a1 * b1 on
+ * its 2 * h high limbs, t holds (a0 + a1) * (b0 + b1) on 2 * l + 1 limbs.
+ * On exit d = z2 * R^2 + (t - z0 - z2) * R + z0 with R = 2^(biL * l).
+ */
+static void mpi_kara_merge( mbedtls_mpi_uint *d, mbedtls_mpi_uint *t,
+                            size_t l, size_t h )
+{
+    mbedtls_mpi_uint c;
+
+    c = mpi_sub_hlp( 2 * l, t, t, d );
+    t[2 * l] -= c;
+    c = mpi_sub_hlp( 2 * h, t, t, d + 2 * l );
+    (void) mpi_dec_hlp( 2 * ( l - h ) + 1, t + 2 * h, c );
+
+    c = mpi_add_hlp( 2 * l + 1, d + l, d + l, t );
+    (void) mpi_inc_hlp( 2 * h - l - 1, d + 3 * l + 1, c );
+}
+
+/*
+ * Karatsuba multiplication: d = a * b
+ * a and b have n limbs, d has 2 * n limbs and doesn't overlap a, b or s.
+ * s is scratch space of mpi_kara_scratch(n) limbs.
+ */
+static void mpi_mul_kara( mbedtls_mpi_uint *d, const mbedtls_mpi_uint *a,
+                          const mbedtls_mpi_uint *b, size_t n,
+                          mbedtls_mpi_uint *s )
+{
+    size_t l, h;
+    mbedtls_mpi_uint ca, cb, c, *sa, *sb, *t;
+
+    if( n < MBEDTLS_MPI_KARATSUBA_THRESHOLD )
+    {
+        mpi_mul_school( d, a, n, b, n );
+        return;
+    }
+
+    /* a = a1 * R + a0 and b = b1 * R + b0 with R = 2^(biL * l) */
+    h = n / 2;
+    l = n - h;
+    sa = s;
+    sb = sa + l;
+    t = sb + l;
+    s = t + 2 * l + 1;
+
+    /* sa = a0 + a1 and sb = b0 + b1, with the carries in ca and cb */
+    ca = mpi_add_hlp( h, sa, a, a + l );
+    memcpy( sa + h, a + h, ( l - h ) * ciL );
+    ca = mpi_inc_hlp( l - h, sa + h, ca );
+    cb = mpi_add_hlp( h, sb, b, b + l );
+    memcpy( sb + h, b + h, ( l - h ) * ciL );
+    cb = mpi_inc_hlp( l - h, sb + h, cb );
+
+    /* t = (sa + ca * R) * (sb + cb * R) */
+    mpi_mul_kara( t, sa, sb, l, s );
+    t[2 * l] = ca & cb;
+    c = mpi_cond_add_hlp( l, t + l, sb, ca );
+    c += mpi_cond_add_hlp( l, t + l, sa, cb );
+    t[2 * l] += c;
+
+    mpi_mul_kara( d, a, b, l, s );
+    mpi_mul_kara( d + 2 * l, a + l, b + l, h, s );
+    mpi_kara_merge( d, t, l, h );
+}
+
+/*
+ * Karatsuba squaring: d = a * a
+ * a has n limbs, d has 2 * n limbs and doesn't overlap a or s.
+ * s is scratch space of mpi_kara_scratch(n) limbs.
+ */
+static void mpi_sqr_kara( mbedtls_mpi_uint *d, const mbedtls_mpi_uint *a,
+                          size_t n, mbedtls_mpi_uint *s )
+{
+    size_t l, h;
+    mbedtls_mpi_uint ca, c, *sa, *t;
+
+    if( n < MBEDTLS_MPI_KARATSUBA_THRESHOLD )
+    {
+        mpi_sqr_school( d, a, n );
+        return;
+    }
+
+    h = n / 2;
+    l = n - h;
+    sa = s;
+    t = sa + 2 * l;
+    s = t + 2 * l + 1;
+
+    ca = mpi_add_hlp( h, sa, a, a + l );
+    memcpy( sa + h, a + h, ( l - h ) * ciL );
+    ca = mpi_inc_hlp( l - h, sa + h, ca );
+
+    /* t = (sa + ca * R)^2 */
+    mpi_sqr_kara( t, sa, l, s );
+    t[2 * l] = ca;
+    c = mpi_cond_add_hlp( l, t + l, sa, ca );
+    c += mpi_cond_add_hlp( l, t + l, sa, ca );
+    t[2 * l] += c;
+
+    mpi_sqr_kara( d, a, l, s );
+    mpi_sqr_kara( d + 2 * l, a + l, h, s );
+    mpi_kara_merge( d, t, l, h );
+}
+
 /*
  * Baseline multiplication: X = A * B  (HAC 14.12)
  */
 int mbedtls_mpi_mul_mpi( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi *B )
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
-    size_t i, j;
-    mbedtls_mpi TA, TB;
+    size_t i, j, k;
+    mbedtls_mpi TA, TB, S;
     int result_is_zero = 0;
+    int square = ( A == B );
     MPI_VALIDATE_RET( X != NULL );
     MPI_VALIDATE_RET( A != NULL );
     MPI_VALIDATE_RET( B != NULL );
 
     mbedtls_mpi_init_mempool( &TA ); mbedtls_mpi_init_mempool( &TB );
+    mbedtls_mpi_init_mempool( &S );
 
     if( X == A ) { MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &TA, A ) ); A = &TA; }
     if( X == B ) { MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &TB, B ) ); B = &TB; }
@@ -1783,11 +2090,37 @@ int mbedtls_mpi_mul_mpi( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi
     if( j == 0 )
         result_is_zero = 1;
 
-    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, i + j ) );
-    MBEDTLS_MPI_CHK( mbedtls_mpi_lset( X, 0 ) );
+    k = ( i > j ) ? i : j;
 
-    for( ; j > 0; j-- )
-        mpi_mul_hlp( i, A->p, X->p + j - 1, B->p[j - 1] );
+    if( square && !result_is_zero )
+    {
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, 2 * i ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_lset( X, 0 ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &S, mpi_kara_scratch( i ) ) );
+
+        mpi_sqr_kara( X->p, A->p, i, S.p );
+    }
+    else if( i >= MBEDTLS_MPI_KARATSUBA_THRESHOLD &&
+             j >= MBEDTLS_MPI_KARATSUBA_THRESHOLD &&
+             2 * i >= k && 2 * j >= k )
+    {
+        /* Operands zero padded to k limbs, followed by the scratch space */
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, 2 * k ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_lset( X, 0 ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &S, 2 * k + mpi_kara_scratch( k ) ) );
+        memcpy( S.p, A->p, i * ciL );
+        memcpy( S.p + k, B->p, j * ciL );
+
+        mpi_mul_kara( X->p, S.p, S.p + k, k, S.p + 2 * k );
+    }
+    else
+    {
+        MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, i + j ) );
+        MBEDTLS_MPI_CHK( mbedtls_mpi_lset( X, 0 ) );
+
+        for( ; j > 0; j-- )
+            mpi_mul_hlp( i, A->p, X->p + j - 1, B->p[j - 1] );
+    }
 
     /* If the result is 0, we don't shortcut the operation, which reduces
      * but does not eliminate side channels leaking the zero-ness. We do
@@ -1800,6 +2133,7 @@ int mbedtls_mpi_mul_mpi( mbedtls_mpi *X, const mbedtls_mpi *A, const mbedtls_mpi
 
 cleanup:
 
+    mbedtls_mpi_free( &S );
     mbedtls_mpi_free( &TB ); mbedtls_mpi_free( &TA );
 
     return( ret );
@@ -2221,10 +2555,11 @@ static void mpi_montmul( mbedtls_mpi *A, const mbedtls_mpi *B, const mbedtls_mpi
     size_t i, n, m;
     mbedtls_mpi_uint u0, u1, *d;
 
-    memset( T->p, 0, T->n * ciL );
+    n = N->n;
+    /* Only the low 2 * (n + 1) limbs are used, the rest may be scratch */
+    memset( T->p, 0, 2 * ( n + 1 ) * ciL );
 
     d = T->p;
-    n = N->n;
     m = ( B->n < n ) ? B->n : n;
 
     for( i = 0; i < n; i++ )
@@ -2262,6 +2597,52 @@ static void mpi_montmul( mbedtls_mpi *A, const mbedtls_mpi *B, const mbedtls_mpi
     mpi_safe_cond_assign( n, A->p, d, (unsigned char) d[n] );
 }
 
+/** Montgomery squaring: A = A * A * R^-1 mod N
+ *
+ * Same result as mpi_montmul( A, A, N, mm, T ), computed as a full square
+ * followed by a separate Montgomery reduction (HAC 14.32).
+ *
+ * \param[in,out]   A   The number to square, see mpi_montmul().
+ * \param[in]       N   The modulo. N must be odd.
+ * \param           mm  The value calculated by `mpi_montg_init(&mm, N)`.
+ * \param[in,out]   T   A bignum for temporary storage.
+ *                      It must be at least twice the limb size of N plus 2
+ *                      plus the Karatsuba scratch space
+ *                      (T->n >= 2 * (N->n + 1) + mpi_kara_scratch(N->n)).
+ */
+static void mpi_montsqr( mbedtls_mpi *A, const mbedtls_mpi *N,
+                         mbedtls_mpi_uint mm, const mbedtls_mpi *T )
+{
+    size_t i, n;
+    mbedtls_mpi_uint c, t, z, *d;
+
+    d = T->p;
+    n = N->n;
+
+    mpi_sqr_kara( d, A->p, n, d + 2 * ( n + 1 ) );
+
+    /*
+     * d = d + u * N * 2^(biL * i) for each limb i, with u chosen to clear
+     * d[i]. c is the carry out of d[n + i], added to the next limb.
+     */
+    c = 0;
+    for( i = 0; i < n; i++ )
+    {
+        t = mpi_mla_hlp( n, N->p, d + i, d[i] * mm );
+        z = d[n + i] + t;   t = ( z < t );
+        d[n + i] = z + c;   c = t + ( d[n + i] < z );
+    }
+
+    d += n;
+    d[n] = c;
+
+    /* Conditional subtraction of N, as in mpi_montmul() */
+    memcpy( A->p, d, n * ciL );
+    d[n] += 1;
+    d[n] -= mpi_sub_hlp( n, d, d, N->p );
+    mpi_safe_cond_assign( n, A->p, d, (unsigned char) d[n] );
+}
+
 void mbedtls_mpi_montmul( mbedtls_mpi *A, const mbedtls_mpi *B, const mbedtls_mpi *N, mbedtls_mpi_uint mm,
                           const mbedtls_mpi *T )
 {
@@ -2414,7 +2795,7 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
      */
     MBEDTLS_MPI_CHK( mbedtls_mpi_grow( X, j ) );
 
-    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &T, j * 2 ) );
+    MBEDTLS_MPI_CHK( mbedtls_mpi_grow( &T, j * 2 + mpi_kara_scratch( N->n ) ) );
 
     /*
      * Compensate for negative A (and correct at the end)
@@ -2487,7 +2868,7 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
         MBEDTLS_MPI_CHK( mbedtls_mpi_copy( &W[j], &W[1]    ) );
 
         for( i = 0; i < wsize - 1; i++ )
-            mpi_montmul( &W[j], &W[j], N, mm, &T );
+            mpi_montsqr( &W[j], N, mm, &T );
 
         /*
          * W[i] = W[i - 1] * W[1]
@@ -2534,7 +2915,7 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
             /*
              * out of window, square X
              */
-            mpi_montmul( X, X, N, mm, &T );
+            mpi_montsqr( X, N, mm, &T );
             continue;
         }
 
@@ -2552,7 +2933,7 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
              * X = X^wsize R^-1 mod N
              */
             for( i = 0; i < wsize; i++ )
-                mpi_montmul( X, X, N, mm, &T );
+                mpi_montsqr( X, N, mm, &T );
 
             /*
              * X = X * W[wbits] R^-1 mod N
@@ -2571,7 +2952,7 @@ int mbedtls_mpi_exp_mod( mbedtls_mpi *X, const mbedtls_mpi *A,
      */
     for( i = 0; i < nbits; i++ )
     {
-        mpi_montmul( X, X, N, mm, &T );
+        mpi_montsqr( X, N, mm, &T );
 
         wbits <<= 1;
 
@@ -121,7 +121,15 @@ void mbedtls_sha1_starts( mbedtls_sha1_context *ctx )
 }
 #endif
 
-#if !defined(MBEDTLS_SHA1_PROCESS_ALT)
+#if defined(MBEDTLS_SHA1_PROCESS_ALT)
+/*
+ * OP-TEE: the alternative implementation in lib/libmbedtls/core/hash.c
+ * falls back to the portable function when the CPU lacks the SHA-1
+ * instructions, build it under another name.
+ */
+#define mbedtls_internal_sha1_process mbedtls_internal_sha1_process_sw
+#endif /* MBEDTLS_SHA1_PROCESS_ALT */
+
 int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
                                    const unsigned char data[64] )
 {
@@ -294,6 +302,9 @@ int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
     return( 0 );
 }
 
+#if defined(MBEDTLS_SHA1_PROCESS_ALT)
+#undef mbedtls_internal_sha1_process
+#else /* MBEDTLS_SHA1_PROCESS_ALT */
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
 void mbedtls_sha1_process( mbedtls_sha1_context *ctx,
                            const unsigned char data[64] )
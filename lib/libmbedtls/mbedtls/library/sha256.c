@@ -146,7 +146,15 @@ void mbedtls_sha256_starts( mbedtls_sha256_context *ctx,
 }
 #endif
 
-#if !defined(MBEDTLS_SHA256_PROCESS_ALT)
+#if defined(MBEDTLS_SHA256_PROCESS_ALT)
+/*
+ * OP-TEE: the alternative implementation in lib/libmbedtls/core/hash.c
+ * falls back to the portable function when the CPU lacks the SHA-256
+ * instructions, build it under another name.
+ */
+#define mbedtls_internal_sha256_process mbedtls_internal_sha256_process_sw
+#endif /* MBEDTLS_SHA256_PROCESS_ALT */
+
 static const uint32_t K[] =
 {
     0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
@@ -281,6 +289,9 @@ int mbedtls_internal_sha256_process( mbedtls_sha256_context *ctx,
     return( 0 );
 }
 
+#if defined(MBEDTLS_SHA256_PROCESS_ALT)
+#undef mbedtls_internal_sha256_process
+#else /* MBEDTLS_SHA256_PROCESS_ALT */
 #if !defined(MBEDTLS_DEPRECATED_REMOVED)
 void mbedtls_sha256_process( mbedtls_sha256_context *ctx,
                              const unsigned char data[64] )
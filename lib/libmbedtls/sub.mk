@@ -126,6 +126,8 @@ cflags-lib-y += -Wno-redundant-decls
 cflags-lib-y += -Wno-switch-default
 cflags-lib-y += -Wno-declaration-after-statement
 
+subdirs-$(CFG_MBEDTLS_MPI_ASM) += arch/$(ARCH)
+
 ifeq ($(CFG_CRYPTOLIB_NAME_mbedtls),y)
 subdirs-$(sm-core) += core
 endif
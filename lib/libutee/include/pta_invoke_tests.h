@@ -82,6 +82,8 @@
 #define PTA_INVOKE_TESTS_AES_CTR		2
 #define PTA_INVOKE_TESTS_AES_XTS		3
 #define PTA_INVOKE_TESTS_AES_GCM		4
+/* OP-TEE extension, to compare with AES-GCM, needs a 256-bit key */
+#define PTA_INVOKE_TESTS_CHACHA20_POLY1305	5
 
 /*
  * AES performance tests
@@ -89,6 +91,7 @@
  * [in]     value[0].a	Top 16 bits Decrypt, low 16 bits key size in bits
  * [in]     value[0].b	AES mode, one of
  *			PTA_INVOKE_TESTS_AES_{ECB_NOPAD,CBC_NOPAD,CTR,XTS,GCM}
+ *			or PTA_INVOKE_TESTS_CHACHA20_POLY1305
  * [in]     value[1].a	repetition count
  * [in]     value[1].b	unit size
  * [in]     memref[2]	In buffer
@@ -103,5 +106,70 @@
  */
 #define PTA_INVOKE_TESTS_CMD_MEMREF_NULL	10
 
+#define PTA_INVOKE_TESTS_SM3			0
+#define PTA_INVOKE_TESTS_SM4_ECB		1
+#define PTA_INVOKE_TESTS_SM4_CBC		2
+#define PTA_INVOKE_TESTS_SM4_CTR		3
+
+/*
+ * SM3 and SM4 performance test, a zeroed buffer is hashed or encrypted in
+ * place repeatedly, as a whole each time
+ *
+ * [in]     value[0].a	algorithm, one of PTA_INVOKE_TESTS_SM3 or
+ *			PTA_INVOKE_TESTS_SM4_{ECB,CBC,CTR}
+ * [in]     value[0].b	non-zero to decrypt, ignored for SM3
+ * [in]     value[1].a	buffer size in bytes, a multiple of 16 and at
+ *			most 1 MiB
+ * [in]     value[1].b	repetition count
+ * [out]    value[2].a	bytes per second, saturated at UINT32_MAX
+ */
+#define PTA_INVOKE_TESTS_CMD_SM_PERF		11
+
+/*
+ * ECDSA performance tests, each operation is timed both without and with
+ * the cached precomputed ECC tables
+ *
+ * [in]     value[0].a	TEE_ECC_CURVE_NIST_P256 or TEE_ECC_CURVE_NIST_P384
+ * [in]     value[0].b	repetition count
+ * [out]    value[1].a	signatures per second without tables
+ * [out]    value[1].b	signatures per second with tables
+ * [out]    value[2].a	verifications per second without tables
+ * [out]    value[2].b	verifications per second with tables
+ */
+#define PTA_INVOKE_TESTS_CMD_ECC_PERF		12
+
+/*
+ * Random number generator performance test, requests of the given size
+ * are read repeatedly with crypto_rng_read()
+ *
+ * [in]     value[0].a	request size in bytes, at most 1 MiB
+ * [in]     value[0].b	repetition count
+ * [out]    value[1].a	calls per second
+ * [out]    value[1].b	bytes per second, saturated at UINT32_MAX
+ */
+#define PTA_INVOKE_TESTS_CMD_RNG_PERF		13
+
+/*
+ * PBKDF2-HMAC-SHA256 performance test, one output block is derived both
+ * with the MAC rekeyed for each iteration and with precomputed HMAC pads
+ *
+ * [in]     value[0].a	iteration count, for instance 100000
+ * [out]    value[1].a	iterations per second rekeying the MAC
+ * [out]    value[1].b	iterations per second with precomputed pads
+ */
+#define PTA_INVOKE_TESTS_CMD_PBKDF2_PERF	14
+
+/*
+ * Bignum modular exponentiation performance test, on a random odd modulus
+ * of the given size
+ *
+ * [in]     value[0].a	modulus size in bits, a multiple of 64 from 512
+ *			to CFG_CORE_BIGNUM_MAX_BITS
+ * [in]     value[0].b	repetition count
+ * [out]    value[1].a	exponentiations per second, full size exponent
+ * [out]    value[1].b	exponentiations per second, exponent 65537
+ */
+#define PTA_INVOKE_TESTS_CMD_MPI_PERF		15
+
 #endif /*__PTA_INVOKE_TESTS_H*/
 
@@ -81,6 +81,14 @@
  */
 #define TEE_ALG_DES3_CMAC	0xF0000613
 
+/*
+ * ChaCha20-Poly1305 authenticated encryption with a 256-bit key, a 96-bit
+ * nonce and a 128-bit tag (RFC 8439)
+ */
+#define TEE_ALG_CHACHA20_POLY1305	0xF00000C3
+
+#define TEE_TYPE_CHACHA20		0xA00000C3
+
 /*
  * Implementation-specific object storage constants
  */
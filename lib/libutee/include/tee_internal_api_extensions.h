@@ -78,4 +78,51 @@ TEE_Result tee_invoke_supp_plugin(const TEE_UUID *uuid, uint32_t cmd,
 				  uint32_t sub_cmd, void *buf, size_t len,
 				  size_t *outlen);
 
+/*
+ * One-shot cryptographic operations
+ *
+ * Each function does what allocating an operation, setting its key,
+ * initializing it, passing all the data and freeing it does, but in a
+ * single call to TEE Core. Meant for small messages where the overhead
+ * of the separate calls dominates.
+ *
+ * Unlike the GP functions these don't panic on bad parameters, the
+ * error is returned instead. The key object must allow the usage
+ * required by the operation, as for TEE_SetOperationKey().
+ *
+ * TEE_DigestOneShot() - Computes the digest of @chunk
+ * TEE_MACComputeOneShot() - Computes the MAC of @message
+ * TEE_CipherOneShot() - Encrypts or decrypts @srcData, @mode is
+ *			 TEE_MODE_ENCRYPT or TEE_MODE_DECRYPT. TEE_ALG_AES_XTS
+ *			 isn't supported.
+ * TEE_AEEncryptOneShot() - Encrypts @srcData and computes a tag of
+ *			    *@tagLen bytes over @AADdata and @srcData
+ * TEE_AEDecryptOneShot() - Decrypts @srcData and checks @tag, returns
+ *			    TEE_ERROR_MAC_INVALID if the tag doesn't match
+ *
+ * Output lengths are updated with the number of bytes produced, or the
+ * number of bytes needed when TEE_ERROR_SHORT_BUFFER is returned.
+ */
+TEE_Result TEE_DigestOneShot(uint32_t algorithm, const void *chunk,
+			     size_t chunkLen, void *hash, size_t *hashLen);
+TEE_Result TEE_MACComputeOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				 const void *message, size_t messageLen,
+				 void *mac, size_t *macLen);
+TEE_Result TEE_CipherOneShot(uint32_t algorithm, uint32_t mode,
+			     TEE_ObjectHandle key, const void *IV,
+			     size_t IVLen, const void *srcData, size_t srcLen,
+			     void *destData, size_t *destLen);
+TEE_Result TEE_AEEncryptOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				const void *nonce, size_t nonceLen,
+				const void *AADdata, size_t AADdataLen,
+				const void *srcData, size_t srcLen,
+				void *destData, size_t *destLen,
+				void *tag, size_t *tagLen);
+TEE_Result TEE_AEDecryptOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				const void *nonce, size_t nonceLen,
+				const void *AADdata, size_t AADdataLen,
+				const void *srcData, size_t srcLen,
+				void *destData, size_t *destLen,
+				const void *tag, size_t tagLen);
+
 #endif
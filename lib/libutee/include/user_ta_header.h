@@ -20,7 +20,9 @@
 #define TA_FLAG_CACHE_MAINTENANCE	(1 << 7) /* use cache flush syscall */
 	/*
 	 * TA instance can execute multiple sessions concurrently
-	 * (pseudo-TAs only).
+	 * (pseudo-TAs only). It's ignored for user TAs, an instance has a
+	 * single user stack, a single set of parameter mappings and
+	 * non-reentrant libutee state like the heap and the handle tables.
 	 */
 #define TA_FLAG_CONCURRENT		(1 << 8)
 	/*
@@ -286,6 +286,17 @@ TEE_Result _utee_se_channel_close(unsigned long c);
 /* op is of type enum _utee_cache_operation */
 TEE_Result _utee_cache_operation(void *va, size_t l, unsigned long op);
 
+/* key is 0 for digest algorithms */
+TEE_Result _utee_hash_oneshot(unsigned long algo, unsigned long key,
+			      const void *chunk, size_t chunk_size, void *hash,
+			      uint64_t *hash_len);
+TEE_Result _utee_cipher_oneshot(unsigned long algo, unsigned long mode,
+				unsigned long key,
+				struct utee_cryp_oneshot *bufs);
+TEE_Result _utee_authenc_oneshot(unsigned long algo, unsigned long mode,
+				 unsigned long key,
+				 struct utee_cryp_oneshot *bufs);
+
 TEE_Result _utee_gprof_send(void *buf, size_t size, uint32_t *id);
 
 #endif /* UTEE_SYSCALLS_H */
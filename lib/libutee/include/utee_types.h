@@ -47,4 +47,24 @@ struct utee_attribute {
 	uint32_t attribute_id;
 };
 
+/*
+ * Buffers of the one-shot cipher and AE syscalls, each given as a user
+ * address and a length. aad and tag are only used by AE algorithms, the
+ * tag is written when encrypting and read when decrypting. dst_len and
+ * tag_len are updated with the number of bytes produced, or needed in
+ * case of TEE_ERROR_SHORT_BUFFER.
+ */
+struct utee_cryp_oneshot {
+	uint64_t iv;
+	uint64_t iv_len;
+	uint64_t aad;
+	uint64_t aad_len;
+	uint64_t src;
+	uint64_t src_len;
+	uint64_t dst;
+	uint64_t dst_len;
+	uint64_t tag;
+	uint64_t tag_len;
+};
+
 #endif /* UTEE_TYPES_H */
@@ -25,8 +25,12 @@ struct __TEE_OperationHandle {
 	size_t block_size;	/* Block size of cipher */
 	size_t buffer_offs;	/* Offset in buffer */
 	uint32_t state;		/* Handle to state in TEE Core */
+	uint8_t *stage;		/* Digest and MAC updates not yet passed on */
+	size_t stage_len;	/* Number of bytes in stage */
 };
 
+#define STAGE_SIZE	CFG_TA_HASH_UPDATE_STAGE_SIZE
+
 /* Cryptographic Operations API - Generic Operation Functions */
 
 TEE_Result TEE_AllocateOperation(TEE_OperationHandle *operation,
@@ -84,6 +88,9 @@ TEE_Result TEE_AllocateOperation(TEE_OperationHandle *operation,
 	case TEE_ALG_ECDH_P256:
 	case TEE_ALG_SM2_PKE:
 	case TEE_ALG_SM2_DSA_SM3:
+	case TEE_ALG_CHACHA20_POLY1305:
+	case TEE_ALG_ED25519:
+	case TEE_ALG_X25519:
 		if (maxKeySize != 256)
 			return TEE_ERROR_NOT_SUPPORTED;
 		break;
@@ -135,6 +142,7 @@ TEE_Result TEE_AllocateOperation(TEE_OperationHandle *operation,
 		fallthrough;
 	case TEE_ALG_AES_CTR:
 	case TEE_ALG_AES_GCM:
+	case TEE_ALG_CHACHA20_POLY1305:
 		if (mode == TEE_MODE_ENCRYPT)
 			req_key_usage = TEE_USAGE_ENCRYPT;
 		else if (mode == TEE_MODE_DECRYPT)
@@ -166,6 +174,7 @@ TEE_Result TEE_AllocateOperation(TEE_OperationHandle *operation,
 	case TEE_ALG_ECDSA_P384:
 	case TEE_ALG_ECDSA_P521:
 	case TEE_ALG_SM2_DSA_SM3:
+	case TEE_ALG_ED25519:
 		if (mode == TEE_MODE_SIGN) {
 			with_private_key = true;
 			req_key_usage = TEE_USAGE_SIGN;
@@ -210,6 +219,7 @@ TEE_Result TEE_AllocateOperation(TEE_OperationHandle *operation,
 	case TEE_ALG_ECDH_P256:
 	case TEE_ALG_ECDH_P384:
 	case TEE_ALG_ECDH_P521:
+	case TEE_ALG_X25519:
 	case TEE_ALG_HKDF_MD5_DERIVE_KEY:
 	case TEE_ALG_HKDF_SHA1_DERIVE_KEY:
 	case TEE_ALG_HKDF_SHA224_DERIVE_KEY:
@@ -383,6 +393,10 @@ void TEE_FreeOperation(TEE_OperationHandle operation)
 	if (res != TEE_SUCCESS)
 		TEE_Panic(res);
 
+	if (operation->stage) {
+		memzero_explicit(operation->stage, STAGE_SIZE);
+		TEE_Free(operation->stage);
+	}
 	TEE_Free(operation->buffer);
 	TEE_Free(operation);
 }
@@ -501,6 +515,7 @@ void TEE_ResetOperation(TEE_OperationHandle operation)
 			TEE_Panic(0);
 
 	operation->operationState = TEE_OPERATION_STATE_INITIAL;
+	operation->stage_len = 0;
 
 	if (operation->info.operationClass == TEE_OPERATION_DIGEST) {
 		res = _utee_hash_init(operation->state, NULL, 0);
@@ -712,6 +727,80 @@ out:
 	return res;
 }
 
+/*
+ * Digest and MAC updates are collected in op->stage as long as they fit,
+ * they're passed on to TEE Core with the next update that doesn't fit or
+ * when the operation is finalized or copied.
+ */
+static void flush_stage(TEE_OperationHandle op)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!op->stage_len)
+		return;
+
+	res = _utee_hash_update(op->state, op->stage, op->stage_len);
+	if (res != TEE_SUCCESS)
+		TEE_Panic(res);
+	op->stage_len = 0;
+}
+
+static void hash_update(TEE_OperationHandle op, const void *chunk,
+			size_t chunk_size)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!chunk_size)
+		return;
+
+	if (!STAGE_SIZE || chunk_size >= STAGE_SIZE) {
+		flush_stage(op);
+		goto update;
+	}
+
+	if (!op->stage) {
+		op->stage = TEE_Malloc(STAGE_SIZE,
+				       TEE_USER_MEM_HINT_NO_FILL_ZERO);
+		if (!op->stage)
+			goto update;
+	}
+
+	if (chunk_size > STAGE_SIZE - op->stage_len)
+		flush_stage(op);
+	memcpy(op->stage + op->stage_len, chunk, chunk_size);
+	op->stage_len += chunk_size;
+	return;
+
+update:
+	res = _utee_hash_update(op->state, chunk, chunk_size);
+	if (res != TEE_SUCCESS)
+		TEE_Panic(res);
+}
+
+static TEE_Result hash_final(TEE_OperationHandle op, const void *chunk,
+			     size_t chunk_size, void *hash, uint64_t *hash_len)
+{
+	size_t stage_len = op->stage_len;
+	TEE_Result res = TEE_SUCCESS;
+
+	if (!stage_len || chunk_size > STAGE_SIZE - stage_len) {
+		flush_stage(op);
+		return _utee_hash_final(op->state, chunk, chunk_size, hash,
+					hash_len);
+	}
+
+	/* The last chunk goes with the pending updates */
+	if (chunk_size)
+		memcpy(op->stage + stage_len, chunk, chunk_size);
+	res = _utee_hash_final(op->state, op->stage, stage_len + chunk_size,
+			       hash, hash_len);
+	/* Nothing is consumed on error, the caller may try again */
+	if (res == TEE_SUCCESS)
+		op->stage_len = 0;
+
+	return res;
+}
+
 void TEE_CopyOperation(TEE_OperationHandle dst_op, TEE_OperationHandle src_op)
 {
 	TEE_Result res;
@@ -757,6 +846,10 @@ void TEE_CopyOperation(TEE_OperationHandle dst_op, TEE_OperationHandle src_op)
 		TEE_Panic(0);
 	}
 
+	/* Pass on the pending updates, the state in TEE Core is copied */
+	flush_stage(src_op);
+	dst_op->stage_len = 0;
+
 	res = _utee_cryp_state_copy(dst_op->state, src_op->state);
 	if (res != TEE_SUCCESS)
 		TEE_Panic(res);
@@ -777,23 +870,20 @@ static void init_hash_operation(TEE_OperationHandle operation, const void *IV,
 	if (res != TEE_SUCCESS)
 		TEE_Panic(res);
 	operation->buffer_offs = 0;
+	operation->stage_len = 0;
 	operation->info.handleState |= TEE_HANDLE_FLAG_INITIALIZED;
 }
 
 void TEE_DigestUpdate(TEE_OperationHandle operation,
 		      const void *chunk, uint32_t chunkSize)
 {
-	TEE_Result res = TEE_ERROR_GENERIC;
-
 	if (operation == TEE_HANDLE_NULL ||
 	    operation->info.operationClass != TEE_OPERATION_DIGEST)
 		TEE_Panic(0);
 
 	operation->operationState = TEE_OPERATION_STATE_ACTIVE;
 
-	res = _utee_hash_update(operation->state, chunk, chunkSize);
-	if (res != TEE_SUCCESS)
-		TEE_Panic(res);
+	hash_update(operation, chunk, chunkSize);
 }
 
 TEE_Result TEE_DigestDoFinal(TEE_OperationHandle operation, const void *chunk,
@@ -811,7 +901,7 @@ TEE_Result TEE_DigestDoFinal(TEE_OperationHandle operation, const void *chunk,
 	__utee_check_inout_annotation(hashLen, sizeof(*hashLen));
 
 	hl = *hashLen;
-	res = _utee_hash_final(operation->state, chunk, chunkLen, hash, &hl);
+	res = hash_final(operation, chunk, chunkLen, hash, &hl);
 	*hashLen = hl;
 	if (res != TEE_SUCCESS)
 		goto out;
@@ -1180,8 +1270,6 @@ void TEE_MACInit(TEE_OperationHandle operation, const void *IV, uint32_t IVLen)
 void TEE_MACUpdate(TEE_OperationHandle operation, const void *chunk,
 		   uint32_t chunkSize)
 {
-	TEE_Result res;
-
 	if (operation == TEE_HANDLE_NULL || (chunk == NULL && chunkSize != 0))
 		TEE_Panic(0);
 
@@ -1194,9 +1282,7 @@ void TEE_MACUpdate(TEE_OperationHandle operation, const void *chunk,
 	if (operation->operationState != TEE_OPERATION_STATE_ACTIVE)
 		TEE_Panic(0);
 
-	res = _utee_hash_update(operation->state, chunk, chunkSize);
-	if (res != TEE_SUCCESS)
-		TEE_Panic(res);
+	hash_update(operation, chunk, chunkSize);
 }
 
 TEE_Result TEE_MACComputeFinal(TEE_OperationHandle operation,
@@ -1228,7 +1314,7 @@ TEE_Result TEE_MACComputeFinal(TEE_OperationHandle operation,
 	}
 
 	ml = *macLen;
-	res = _utee_hash_final(operation->state, message, messageLen, mac, &ml);
+	res = hash_final(operation, message, messageLen, mac, &ml);
 	*macLen = ml;
 	if (res != TEE_SUCCESS)
 		goto out;
@@ -1332,6 +1418,13 @@ TEE_Result TEE_AEInit(TEE_OperationHandle operation, const void *nonce,
 		}
 	}
 
+	/* RFC 8439 only defines a 128-bit tag for ChaCha20-Poly1305 */
+	if (operation->info.algorithm == TEE_ALG_CHACHA20_POLY1305 &&
+	    tagLen != 128) {
+		res = TEE_ERROR_NOT_SUPPORTED;
+		goto out;
+	}
+
 	res = _utee_authenc_init(operation->state, nonce, nonceLen, tagLen / 8,
 				 AADLen, payloadLen);
 	if (res != TEE_SUCCESS)
@@ -1816,10 +1909,55 @@ void TEE_DeriveKey(TEE_OperationHandle operation,
 
 /* Cryptographic Operations API - Random Number Generation Functions */
 
+#if CFG_TA_RNG_BUFFER_SIZE > 0
+/*
+ * Small requests are served from a buffer of random bytes drawn from the
+ * TEE core in advance, saving one syscall per request. Bytes are cleared
+ * as soon as they're handed out.
+ */
+static struct {
+	uint8_t data[CFG_TA_RNG_BUFFER_SIZE];
+	size_t avail;
+} rng_buf;
+
+static bool rng_buf_read(void *buf, size_t blen)
+{
+	uint8_t *d = NULL;
+
+	if (blen > sizeof(rng_buf.data) / 4)
+		return false;
+
+	if (rng_buf.avail < blen) {
+		if (_utee_cryp_random_number_generate(rng_buf.data,
+						      sizeof(rng_buf.data))) {
+			memzero_explicit(rng_buf.data, sizeof(rng_buf.data));
+			rng_buf.avail = 0;
+			return false;
+		}
+		rng_buf.avail = sizeof(rng_buf.data);
+	}
+
+	d = rng_buf.data + rng_buf.avail - blen;
+	memcpy(buf, d, blen);
+	memzero_explicit(d, blen);
+	rng_buf.avail -= blen;
+
+	return true;
+}
+#else
+static bool rng_buf_read(void *buf __unused, size_t blen __unused)
+{
+	return false;
+}
+#endif
+
 void TEE_GenerateRandom(void *randomBuffer, uint32_t randomBufferLen)
 {
 	TEE_Result res;
 
+	if (rng_buf_read(randomBuffer, randomBufferLen))
+		return;
+
 	res = _utee_cryp_random_number_generate(randomBuffer, randomBufferLen);
 	if (res != TEE_SUCCESS)
 		TEE_Panic(res);
@@ -1974,6 +2112,10 @@ TEE_Result TEE_IsAlgorithmSupported(uint32_t alg, uint32_t element)
 				goto check_element_none;
 		}
 	}
+	if (IS_ENABLED(CFG_CRYPTO_CHACHA20_POLY1305)) {
+		if (alg == TEE_ALG_CHACHA20_POLY1305)
+			goto check_element_none;
+	}
 	if (IS_ENABLED(CFG_CRYPTO_RSA)) {
 		if (IS_ENABLED(CFG_CRYPTO_MD5)) {
 			if (alg == TEE_ALG_RSASSA_PKCS1_V1_5_MD5)
@@ -2067,6 +2209,14 @@ TEE_Result TEE_IsAlgorithmSupported(uint32_t alg, uint32_t element)
 		if (alg == TEE_ALG_SM2_PKE && element == TEE_ECC_CURVE_SM2)
 			return TEE_SUCCESS;
 	}
+	if (IS_ENABLED(CFG_CRYPTO_X25519)) {
+		if (alg == TEE_ALG_X25519)
+			goto check_element_none;
+	}
+	if (IS_ENABLED(CFG_CRYPTO_ED25519)) {
+		if (alg == TEE_ALG_ED25519)
+			goto check_element_none;
+	}
 
 	return TEE_ERROR_NOT_SUPPORTED;
 check_element_none:
@@ -2074,3 +2224,153 @@ check_element_none:
 		return TEE_SUCCESS;
 	return TEE_ERROR_NOT_SUPPORTED;
 }
+
+/* One-shot extensions, see tee_internal_api_extensions.h */
+
+TEE_Result TEE_DigestOneShot(uint32_t algorithm, const void *chunk,
+			     size_t chunkLen, void *hash, size_t *hashLen)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t hl = 0;
+
+	if (TEE_ALG_GET_CLASS(algorithm) != TEE_OPERATION_DIGEST ||
+	    (!chunk && chunkLen))
+		return TEE_ERROR_BAD_PARAMETERS;
+	__utee_check_inout_annotation(hashLen, sizeof(*hashLen));
+
+	hl = *hashLen;
+	res = _utee_hash_oneshot(algorithm, 0, chunk, chunkLen, hash, &hl);
+	*hashLen = hl;
+
+	return res;
+}
+
+TEE_Result TEE_MACComputeOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				 const void *message, size_t messageLen,
+				 void *mac, size_t *macLen)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint64_t ml = 0;
+
+	if (TEE_ALG_GET_CLASS(algorithm) != TEE_OPERATION_MAC ||
+	    key == TEE_HANDLE_NULL || (!message && messageLen))
+		return TEE_ERROR_BAD_PARAMETERS;
+	__utee_check_inout_annotation(macLen, sizeof(*macLen));
+
+	ml = *macLen;
+	res = _utee_hash_oneshot(algorithm, (unsigned long)key, message,
+				 messageLen, mac, &ml);
+	*macLen = ml;
+
+	return res;
+}
+
+TEE_Result TEE_CipherOneShot(uint32_t algorithm, uint32_t mode,
+			     TEE_ObjectHandle key, const void *IV,
+			     size_t IVLen, const void *srcData, size_t srcLen,
+			     void *destData, size_t *destLen)
+{
+	struct utee_cryp_oneshot b = {
+		.iv = (uintptr_t)IV,
+		.iv_len = IVLen,
+		.src = (uintptr_t)srcData,
+		.src_len = srcLen,
+		.dst = (uintptr_t)destData,
+	};
+	TEE_Result res = TEE_SUCCESS;
+
+	if (key == TEE_HANDLE_NULL)
+		return TEE_ERROR_BAD_PARAMETERS;
+	__utee_check_inout_annotation(destLen, sizeof(*destLen));
+
+	b.dst_len = *destLen;
+	res = _utee_cipher_oneshot(algorithm, mode, (unsigned long)key, &b);
+	*destLen = b.dst_len;
+
+	return res;
+}
+
+/* Same tag lengths as accepted by TEE_AEInit(), but in bytes */
+static TEE_Result check_ae_tag_len(uint32_t algorithm, size_t tag_len)
+{
+	if (algorithm == TEE_ALG_AES_GCM && (tag_len < 12 || tag_len > 16))
+		return TEE_ERROR_NOT_SUPPORTED;
+	if (algorithm == TEE_ALG_CHACHA20_POLY1305 && tag_len != 16)
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result TEE_AEEncryptOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				const void *nonce, size_t nonceLen,
+				const void *AADdata, size_t AADdataLen,
+				const void *srcData, size_t srcLen,
+				void *destData, size_t *destLen,
+				void *tag, size_t *tagLen)
+{
+	struct utee_cryp_oneshot b = {
+		.iv = (uintptr_t)nonce,
+		.iv_len = nonceLen,
+		.aad = (uintptr_t)AADdata,
+		.aad_len = AADdataLen,
+		.src = (uintptr_t)srcData,
+		.src_len = srcLen,
+		.dst = (uintptr_t)destData,
+		.tag = (uintptr_t)tag,
+	};
+	TEE_Result res = TEE_SUCCESS;
+
+	if (key == TEE_HANDLE_NULL || !nonce)
+		return TEE_ERROR_BAD_PARAMETERS;
+	__utee_check_inout_annotation(destLen, sizeof(*destLen));
+	__utee_check_inout_annotation(tagLen, sizeof(*tagLen));
+
+	res = check_ae_tag_len(algorithm, *tagLen);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	b.dst_len = *destLen;
+	b.tag_len = *tagLen;
+	res = _utee_authenc_oneshot(algorithm, TEE_MODE_ENCRYPT,
+				    (unsigned long)key, &b);
+	*destLen = b.dst_len;
+	*tagLen = b.tag_len;
+
+	return res;
+}
+
+TEE_Result TEE_AEDecryptOneShot(uint32_t algorithm, TEE_ObjectHandle key,
+				const void *nonce, size_t nonceLen,
+				const void *AADdata, size_t AADdataLen,
+				const void *srcData, size_t srcLen,
+				void *destData, size_t *destLen,
+				const void *tag, size_t tagLen)
+{
+	struct utee_cryp_oneshot b = {
+		.iv = (uintptr_t)nonce,
+		.iv_len = nonceLen,
+		.aad = (uintptr_t)AADdata,
+		.aad_len = AADdataLen,
+		.src = (uintptr_t)srcData,
+		.src_len = srcLen,
+		.dst = (uintptr_t)destData,
+		.tag = (uintptr_t)tag,
+		.tag_len = tagLen,
+	};
+	TEE_Result res = TEE_SUCCESS;
+
+	if (key == TEE_HANDLE_NULL || !nonce || !tag)
+		return TEE_ERROR_BAD_PARAMETERS;
+	__utee_check_inout_annotation(destLen, sizeof(*destLen));
+
+	res = check_ae_tag_len(algorithm, tagLen);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	b.dst_len = *destLen;
+	res = _utee_authenc_oneshot(algorithm, TEE_MODE_DECRYPT,
+				    (unsigned long)key, &b);
+	*destLen = b.dst_len;
+
+	return res;
+}
@@ -74,4 +74,27 @@ void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size);
  */
 void mempool_free(struct mempool *pool, void *ptr);
 
+#if defined(__KERNEL__)
+/*
+ * mempool_arena_begin() - Open an arena for the calling thread
+ * @pool:		A memory pool created with mempool_alloc_pool()
+ * @size:		Size in bytes of the arena
+ *
+ * Reserves the pool for the calling thread and takes an item of @size
+ * bytes from it. Until mempool_arena_end() the allocations of the thread
+ * are served from that item by increasing an offset, falling back to the
+ * pool when it's full. Calls may be nested, only the outermost one opens
+ * the arena.
+ */
+void mempool_arena_begin(struct mempool *pool, size_t size);
+
+/*
+ * mempool_arena_end() - Close the arena opened by mempool_arena_begin()
+ * @pool:		A memory pool created with mempool_alloc_pool()
+ *
+ * All items allocated from the arena must have been freed.
+ */
+void mempool_arena_end(struct mempool *pool);
+#endif
+
 #endif /*__MEMPOOL_H*/
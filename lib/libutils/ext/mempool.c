@@ -15,6 +15,7 @@
 #if defined(__KERNEL__)
 #include <kernel/mutex.h>
 #include <kernel/panic.h>
+#include <kernel/thread.h>
 #endif
 
 /*
@@ -49,8 +50,34 @@
  *   - if an item A is allocated before another item B, then A should be
  *     released after B.
  *   So the potential fragmentation is mitigated.
+ *
+ * In the kernel a thread may also open an arena in a pool with
+ * mempool_arena_begin(). The arena is one large item taken from the pool,
+ * the following allocations of that thread are carved out of it by moving
+ * a top offset, without going through the mutex or the allocator. Each
+ * arena item is preceded by a struct arena_item which links it to the
+ * item below. Freeing an item only marks it as such, the top offset is
+ * moved down over all the freed items at the top of the arena. Holding
+ * the arena item keeps the pool reserved for the thread, which is what
+ * makes it safe to access the arena without locking.
  */
 
+#define ARENA_NO_ITEM	SIZE_MAX
+
+struct arena_item {
+	size_t prev;	/* Offset of the item below or ARENA_NO_ITEM */
+	size_t freed;	/* Non-zero when the item has been freed */
+};
+
+struct mempool_arena {
+	vaddr_t data;	/* Arena memory, 0 if none */
+	size_t size;	/* Size of the arena memory, in bytes */
+	size_t top;	/* Offset of the first unused byte */
+	size_t last;	/* Offset of the last item or ARENA_NO_ITEM */
+	size_t depth;	/* Nesting depth of mempool_arena_begin() */
+	short int owner; /* Thread using the arena */
+};
+
 
 struct mempool {
 	size_t size;  /* size of the memory pool, in bytes */
@@ -62,6 +89,7 @@ struct mempool {
 #if defined(__KERNEL__)
 	void (*release_mem)(void *ptr, size_t size);
 	struct recursive_mutex mu;
+	struct mempool_arena arena;
 #endif
 };
 
@@ -114,6 +142,117 @@ static void put_pool(struct mempool *pool __maybe_unused)
 #endif
 }
 
+#if defined(__KERNEL__)
+static struct mempool_arena *get_arena(struct mempool *pool)
+{
+	/*
+	 * Only the owner thread may find its own ID here, the field is
+	 * updated while holding the pool.
+	 */
+	if (pool->arena.owner != thread_get_id_may_fail() ||
+	    pool->arena.owner == THREAD_ID_INVALID)
+		return NULL;
+
+	return &pool->arena;
+}
+
+static void *arena_alloc(struct mempool *pool, size_t size)
+{
+	struct mempool_arena *a = get_arena(pool);
+	struct arena_item *item = NULL;
+	size_t end = 0;
+
+	if (!a || !a->data)
+		return NULL;
+
+	if (ADD_OVERFLOW(a->top, sizeof(*item), &end) ||
+	    ADD_OVERFLOW(end, size, &end) ||
+	    ROUNDUP_OVERFLOW(end, MEMPOOL_ALIGN, &end) || end > a->size)
+		return NULL;
+
+	item = (struct arena_item *)(a->data + a->top);
+	item->prev = a->last;
+	item->freed = 0;
+	a->last = a->top;
+	a->top = end;
+
+	return item + 1;
+}
+
+static bool arena_free(struct mempool *pool, void *ptr)
+{
+	struct mempool_arena *a = get_arena(pool);
+	struct arena_item *item = NULL;
+	vaddr_t v = (vaddr_t)ptr;
+
+	if (!a || v <= a->data || v >= a->data + a->size)
+		return false;
+
+	item = (struct arena_item *)ptr - 1;
+	item->freed = 1;
+
+	while (a->last != ARENA_NO_ITEM) {
+		item = (struct arena_item *)(a->data + a->last);
+		if (!item->freed)
+			break;
+		a->top = a->last;
+		a->last = item->prev;
+	}
+
+	return true;
+}
+
+void mempool_arena_begin(struct mempool *pool, size_t size)
+{
+	struct mempool_arena *a = &pool->arena;
+
+	get_pool(pool);
+	if (a->depth++) {
+		/* Nested, the outermost arena is used */
+		put_pool(pool);
+		return;
+	}
+
+	/* The pool is held until mempool_arena_end() */
+	a->data = (vaddr_t)raw_malloc(0, 0, ROUNDUP(size, MEMPOOL_ALIGN),
+				      pool->mctx);
+	a->size = a->data ? ROUNDUP(size, MEMPOOL_ALIGN) : 0;
+	a->top = 0;
+	a->last = ARENA_NO_ITEM;
+	a->owner = thread_get_id();
+}
+
+void mempool_arena_end(struct mempool *pool)
+{
+	struct mempool_arena *a = &pool->arena;
+
+	assert(get_arena(pool) && a->depth);
+	if (--a->depth)
+		return;
+
+	/* Items must not outlive the arena */
+	if (a->last != ARENA_NO_ITEM)
+		panic();
+
+	if (a->data)
+		raw_free((void *)a->data, pool->mctx, false /*!wipe*/);
+	a->data = 0;
+	a->size = 0;
+	a->owner = THREAD_ID_INVALID;
+	put_pool(pool);
+}
+#else
+static void *arena_alloc(struct mempool *pool __unused, size_t size __unused)
+{
+	return NULL;
+}
+
+static bool arena_free(struct mempool *pool __unused, void *ptr __unused)
+{
+	return false;
+}
+#endif
+
 struct mempool *
 mempool_alloc_pool(void *data, size_t size,
 		   void (*release_mem)(void *ptr, size_t size) __maybe_unused)
@@ -129,6 +268,7 @@ mempool_alloc_pool(void *data, size_t size,
 #if defined(__KERNEL__)
 		pool->release_mem = release_mem;
 		mutex_init_recursive(&pool->mu);
+		pool->arena.owner = THREAD_ID_INVALID;
 #else
 		init_mpool(pool);
 #endif
@@ -139,7 +279,10 @@ mempool_alloc_pool(void *data, size_t size,
 
 void *mempool_alloc(struct mempool *pool, size_t size)
 {
-	void *p = NULL;
+	void *p = arena_alloc(pool, size);
+
+	if (p)
+		return p;
 
 	get_pool(pool);
 
@@ -180,6 +323,9 @@ void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size)
 
 void mempool_free(struct mempool *pool, void *ptr)
 {
+	if (arena_free(pool, ptr))
+		return;
+
 	raw_free(ptr, pool->mctx, false /*!wipe*/);
 	put_pool(pool);
 }
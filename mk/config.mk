@@ -590,6 +590,35 @@ CFG_CORE_THREAD_SHIFT ?= 0
 # non-secure memory).
 CFG_CORE_DYN_SHM ?= y
 
+# Number of bits in the index of the hash table used to look up registered
+# shared memory by cookie, that is, the table has 2^N buckets. Increase for
+# normal world clients which keep many buffers registered. Valid values are
+# 1 to 16.
+CFG_CORE_SHM_COOKIE_HASH_BITS ?= 6
+$(call cfg-check-value,CORE_SHM_COOKIE_HASH_BITS,\
+	1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16)
+
+# Maximum number of registered shared memory buffers which are kept mapped
+# in the core virtual address space after their last user has unmapped them.
+# Cached mappings are reused on the next map and are unmapped when the
+# buffer is released, when the cache is full or when virtual address space
+# is needed. 0 disables the cache.
+CFG_CORE_REG_SHM_MAP_CACHE_SIZE ?= 16
+
+# Map memory reference parameters of type TEE_PARAM_TYPE_MEMREF_INPUT
+# read-only into user TAs, so a TA can't write to its input buffers.
+# Memrefs sharing pages with an output memref are still mapped read/write.
+# This doesn't stop normal world from modifying a shared buffer while the
+# TA uses it, a TA must still copy data it validates before using it.
+CFG_USER_TA_MAP_INPUT_RO ?= n
+
+# Enable support for invoke rings: a per-session ring of invoke command
+# requests located in registered shared memory that normal world can fill
+# with several requests and have processed by a single call into secure
+# world. Not available with CFG_CORE_FFA.
+CFG_CORE_INVOKE_RING ?= n
+$(eval $(call cfg-depends-all,CFG_CORE_INVOKE_RING,CFG_CORE_DYN_SHM))
+
 # Enable support for reserved shared memory (shared memory in a carved out
 # memory area).
 CFG_CORE_RESERVED_SHM ?= y
@@ -604,6 +633,11 @@ CFG_CORE_LARGE_PHYS_ADDR ?= n
 # Set this to a lower value to reduce the TA memory footprint.
 CFG_TA_BIGNUM_MAX_BITS ?= 2048
 
+# Size in bytes of the buffer used by TEE_GenerateRandom() in libutee to
+# serve small requests without a syscall each, 0 disables the buffer.
+# Requests larger than a quarter of the buffer bypass it.
+CFG_TA_RNG_BUFFER_SIZE ?= 256
+
 # Define the maximum size, in bits, for big numbers in the TEE core (privileged
 # layer).
 # This value is an upper limit for the key size in any cryptographic algorithm
@@ -611,6 +645,12 @@ CFG_TA_BIGNUM_MAX_BITS ?= 2048
 # Set this to a lower value to reduce the memory footprint.
 CFG_CORE_BIGNUM_MAX_BITS ?= 4096
 
+# When enabled, the temporary bignums of each asymmetric operation requested
+# by a TA are carved out of an arena sized from the key, taken once from the
+# bignum memory pool, instead of going through the pool for each of them.
+# Only used when the core bignums are provided by libtomcrypt.
+CFG_CORE_BIGNUM_ARENA ?= y
+
 # Not used since libmpa was removed. Force the values to catch build scripts
 # that would set = n.
 $(call force,CFG_TA_MBEDTLS_MPI,y)
@@ -620,6 +660,11 @@ $(call force,CFG_TA_MBEDTLS,y)
 # need to be called to test anything
 CFG_TA_MBEDTLS_SELF_TEST ?= y
 
+# Use the AArch64 assembly multiply-accumulate kernels in the mbedTLS bignum
+# code, both in the core and in the TAs. Only has an effect in 64-bit
+# builds, the generic C code is used otherwise.
+CFG_MBEDTLS_MPI_ASM ?= y
+
 # By default use tomcrypt as the main crypto lib providing an implementation
 # for the API in <crypto/crypto.h>
 # CFG_CRYPTOLIB_NAME is used as libname and
@@ -707,6 +752,11 @@ endif
 # not allowed.
 CFG_TA_STRICT_ANNOTATION_CHECKS ?= y
 
+# Size in bytes of the buffer libutee uses to collect small
+# TEE_DigestUpdate() and TEE_MACUpdate() chunks of an operation before
+# passing them to the TEE core in one system call. 0 disables the buffering.
+CFG_TA_HASH_UPDATE_STAGE_SIZE ?= 2048
+
 # When enabled accepts the DES key sizes excluding parity bits as in
 # the GP Internal API Specification v1.0
 CFG_COMPAT_GP10_DES ?= y
@@ -801,3 +851,19 @@ CFG_CORE_ASYNC_NOTIF ?= n
 
 $(eval $(call cfg-enable-all-depends,CFG_MEMPOOL_REPORT_LAST_OFFSET, \
 	 CFG_WITH_STATS))
+
+# CFG_CRYPTO_DRV_BALANCE, when enabled, lets the crypto driver API process
+# hash, cipher, MAC and authenticated encryption requests in software when
+# that is expected to be faster than the HW driver:
+# - requests smaller than a threshold per class of algorithms. The
+#   threshold is measured at boot when CFG_CRYPTO_DRV_BALANCE_CALIBRATE=y,
+#   it's CFG_CRYPTO_DRV_BALANCE_MIN_SIZE bytes otherwise.
+# - requests arriving while the HW driver already processes
+#   CFG_CRYPTO_DRV_BALANCE_HW_DEPTH requests of the same class.
+# The counters of each class are available with the stats pseudo TA.
+CFG_CRYPTO_DRV_BALANCE ?= n
+CFG_CRYPTO_DRV_BALANCE_CALIBRATE ?= y
+CFG_CRYPTO_DRV_BALANCE_MIN_SIZE ?= 256
+CFG_CRYPTO_DRV_BALANCE_HW_DEPTH ?= 2
+
+$(eval $(call cfg-depends-all,CFG_CRYPTO_DRV_BALANCE,CFG_CRYPTO_DRIVER))